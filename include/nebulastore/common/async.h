@@ -1,6 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <coroutine>
+#include <cstdint>
+#include <mutex>
 #include <optional>
 #include <exception>
 #include <type_traits>
@@ -12,28 +16,107 @@ namespace nebulastore {
 // ================================
 // 简单的 C++20 协程封装
 // ================================
+//
+// 任务立即开始执行 (initial_suspend 不挂起). 挂起在 IO 上的协程由完成它的线程
+// 恢复: io_uring 的 reaper、线程池回退的工作线程或元数据合批器的写线程.
+// co_await 之后的代码 (含析构) 都跑在这些线程上, 其中不能同步阻塞:
+// 不调用 Get()、不等条件变量、不 sleep, 否则该线程上其他 IO 的完成都被卡住,
+// 等待的正是本线程要投递的完成时直接死锁. 需要等待时用 co_await
+
+namespace detail {
+
+// 协程状态: 任务可能挂起在 IO 上, 由 IO 线程恢复,
+// 因此 co_await / Get() 与完成之间需要原子同步
+enum TaskState : uint8_t {
+    kTaskRunning = 0,     // 运行中或挂起等待 IO
+    kTaskAwaited = 1,     // 已有协程 co_await, 完成时恢复 continuation
+    kTaskSyncWaiting = 2, // 已有线程在 Get() 中阻塞等待
+    kTaskDone = 3,
+};
+
+struct SyncWaiter {
+    std::mutex mu;
+    std::condition_variable cv;
+    bool done = false;
+};
+
+struct PromiseBase {
+    std::atomic<uint8_t> state_{kTaskRunning};
+    std::coroutine_handle<> continuation_;
+    SyncWaiter* sync_waiter_ = nullptr;
+    std::exception_ptr exception_;
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            PromiseBase& p = h.promise();
+            auto prev = p.state_.exchange(kTaskDone, std::memory_order_acq_rel);
+            if (prev == kTaskAwaited) {
+                return p.continuation_;
+            }
+            if (prev == kTaskSyncWaiting) {
+                // 持锁通知: 等待方拿到锁之前不会返回并销毁协程帧
+                std::lock_guard<std::mutex> lock(p.sync_waiter_->mu);
+                p.sync_waiter_->done = true;
+                p.sync_waiter_->cv.notify_one();
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_never initial_suspend() { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() {
+        exception_ = std::current_exception();
+    }
+
+    bool IsDone() const {
+        return state_.load(std::memory_order_acquire) == kTaskDone;
+    }
+
+    // co_await: 登记 continuation, 返回 false 表示任务已完成无需挂起
+    bool Await(std::coroutine_handle<> continuation) {
+        continuation_ = continuation;
+        uint8_t expected = kTaskRunning;
+        return state_.compare_exchange_strong(expected, kTaskAwaited,
+                                              std::memory_order_acq_rel);
+    }
+
+    // Get(): 任务挂起在 IO 上时阻塞等待完成
+    void Wait() {
+        if (IsDone()) return;
+        SyncWaiter waiter;
+        sync_waiter_ = &waiter;
+        uint8_t expected = kTaskRunning;
+        if (!state_.compare_exchange_strong(expected, kTaskSyncWaiting,
+                                            std::memory_order_acq_rel)) {
+            return;  // 已完成
+        }
+        std::unique_lock<std::mutex> lock(waiter.mu);
+        waiter.cv.wait(lock, [&waiter] { return waiter.done; });
+    }
+};
+
+} // namespace detail
 
 template<typename T>
 class AsyncTask {
 public:
-    struct promise_type {
+    struct promise_type : detail::PromiseBase {
         AsyncTask get_return_object() {
             return AsyncTask{std::coroutine_handle<promise_type>::from_promise(*this)};
         }
 
-        std::suspend_never initial_suspend() { return {}; }
-        std::suspend_always final_suspend() noexcept { return {}; }
-
         void return_value(T value) {
             value_ = std::move(value);
         }
 
-        void unhandled_exception() {
-            exception_ = std::current_exception();
-        }
-
         T value_;
-        std::exception_ptr exception_;
     };
 
     explicit AsyncTask(std::coroutine_handle<promise_type> handle)
@@ -63,11 +146,9 @@ public:
         return *this;
     }
 
-    // 获取结果
+    // 获取结果 (任务挂起在 IO 上时阻塞等待)
     T Get() {
-        if (!handle_.done()) {
-            handle_.resume();
-        }
+        handle_.promise().Wait();
 
         if (handle_.promise().exception_) {
             std::rethrow_exception(handle_.promise().exception_);
@@ -78,14 +159,12 @@ public:
 
     // === awaitable 接口 ===
     bool await_ready() noexcept {
-        return handle_.done();
+        return handle_.promise().IsDone();
     }
 
-    void await_suspend(std::coroutine_handle<> continuation) {
-        // TODO: 实现真正的异步调度
-        // 当前: 直接 resume，同步执行
-        handle_.resume();
-        continuation.resume();
+    // 任务完成时由 FinalAwaiter 恢复 continuation (可能在 IO 线程上)
+    bool await_suspend(std::coroutine_handle<> continuation) {
+        return handle_.promise().Await(continuation);
     }
 
     T await_resume() {
@@ -103,21 +182,12 @@ private:
 template<>
 class AsyncTask<void> {
 public:
-    struct promise_type {
+    struct promise_type : detail::PromiseBase {
         AsyncTask get_return_object() {
             return AsyncTask{std::coroutine_handle<promise_type>::from_promise(*this)};
         }
 
-        std::suspend_never initial_suspend() { return {}; }
-        std::suspend_always final_suspend() noexcept { return {}; }
-
         void return_void() {}
-
-        void unhandled_exception() {
-            exception_ = std::current_exception();
-        }
-
-        std::exception_ptr exception_;
     };
 
     explicit AsyncTask(std::coroutine_handle<promise_type> handle)
@@ -146,9 +216,7 @@ public:
     }
 
     void Get() {
-        if (!handle_.done()) {
-            handle_.resume();
-        }
+        handle_.promise().Wait();
 
         if (handle_.promise().exception_) {
             std::rethrow_exception(handle_.promise().exception_);
@@ -157,13 +225,11 @@ public:
 
     // === awaitable 接口 ===
     bool await_ready() noexcept {
-        return handle_.done();
+        return handle_.promise().IsDone();
     }
 
-    void await_suspend(std::coroutine_handle<> continuation) {
-        // TODO: 实现真正的异步调度
-        handle_.resume();
-        continuation.resume();
+    bool await_suspend(std::coroutine_handle<> continuation) {
+        return handle_.promise().Await(continuation);
     }
 
     void await_resume() {
@@ -176,6 +242,21 @@ private:
     std::coroutine_handle<promise_type> handle_;
 };
 
+// ================================
+// 分离执行的协程 (fire-and-forget)
+// ================================
+
+// 不可等待, 结束时自动销毁协程帧; 结果需由协程自身回写
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
 // ================================
 // awaiter 包装器
 // ================================
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace nebulastore::codec {
+
+// ================================
+// 紧凑二进制编码原语
+// ================================
+//
+// varint 为 LEB128 (与 protobuf / RocksDB 相同): 每字节低 7 位是数据, 最高位表示
+// 后面还有字节, 小于 128 的值只占 1 字节, uint64 最多 10 字节.
+// 有符号差值先做 zigzag 映射 (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...), 绝对值小的负数同样短.
+// Reader 直接在调用方持有的内存上解码 (如 rocksdb::PinnableSlice), 不做拷贝.
+
+constexpr size_t kMaxVarint64Length = 10;
+
+// 时间字段按与该基准 (2020-09-13) 的差值编码, 当前时间约 4 字节
+constexpr uint64_t kTimeBase = 1600000000;
+
+inline char* EncodeVarint64(char* dst, uint64_t v) {
+    auto* p = reinterpret_cast<unsigned char*>(dst);
+    while (v >= 0x80) {
+        *p++ = static_cast<unsigned char>(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = static_cast<unsigned char>(v);
+    return reinterpret_cast<char*>(p);
+}
+
+inline void PutVarint64(std::string* dst, uint64_t v) {
+    char buf[kMaxVarint64Length];
+    dst->append(buf, static_cast<size_t>(EncodeVarint64(buf, v) - buf));
+}
+
+inline size_t VarintLength(uint64_t v) {
+    size_t len = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++len;
+    }
+    return len;
+}
+
+inline uint64_t ZigZagEncode(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t ZigZagDecode(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// 有符号差值 to - from, 按模 2^64 回绕, 任意两个 uint64 之间都可还原
+inline void PutDelta(std::string* dst, uint64_t from, uint64_t to) {
+    PutVarint64(dst, ZigZagEncode(static_cast<int64_t>(to - from)));
+}
+
+inline void PutLengthPrefixed(std::string* dst, std::string_view s) {
+    PutVarint64(dst, s.size());
+    dst->append(s.data(), s.size());
+}
+
+class Reader {
+public:
+    explicit Reader(std::string_view data)
+        : p_(data.data()), limit_(data.data() + data.size()) {}
+
+    bool empty() const { return p_ == limit_; }
+    size_t remaining() const { return static_cast<size_t>(limit_ - p_); }
+
+    bool GetByte(uint8_t* v) {
+        if (p_ == limit_) return false;
+        *v = static_cast<uint8_t>(*p_++);
+        return true;
+    }
+
+    bool GetVarint64(uint64_t* v) {
+        uint64_t result = 0;
+        for (uint32_t shift = 0; shift < 64 && p_ < limit_; shift += 7) {
+            uint64_t byte = static_cast<unsigned char>(*p_++);
+            result |= (byte & 0x7F) << shift;
+            if (byte < 0x80) {
+                *v = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 解码并检查是否超出 T 的范围
+    template <typename T>
+    bool GetVarint(T* v) {
+        uint64_t x;
+        if (!GetVarint64(&x) || x > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+            return false;
+        }
+        *v = static_cast<T>(x);
+        return true;
+    }
+
+    bool GetDelta(uint64_t from, uint64_t* to) {
+        uint64_t x;
+        if (!GetVarint64(&x)) return false;
+        *to = from + static_cast<uint64_t>(ZigZagDecode(x));
+        return true;
+    }
+
+    // 返回的视图指向原内存, 生命周期随数据源
+    bool GetLengthPrefixed(std::string_view* s) {
+        uint64_t len;
+        if (!GetVarint64(&len) || len > remaining()) return false;
+        *s = std::string_view(p_, static_cast<size_t>(len));
+        p_ += len;
+        return true;
+    }
+
+private:
+    const char* p_;
+    const char* limit_;
+};
+
+// 定长栈缓冲拼 key: 不超过 N 字节时不分配, 超出 (如超长文件名) 退回 std::string
+template <size_t N>
+class KeyBuffer {
+public:
+    KeyBuffer() = default;
+    KeyBuffer(const KeyBuffer&) = delete;
+    KeyBuffer& operator=(const KeyBuffer&) = delete;
+
+    void Append(std::string_view s) {
+        if (s.empty()) return;
+        if (!on_heap_ && size_ + s.size() <= N) {
+            std::memcpy(buf_ + size_, s.data(), s.size());
+            size_ += s.size();
+            return;
+        }
+        if (!on_heap_) {
+            heap_.assign(buf_, size_);
+            on_heap_ = true;
+        }
+        heap_.append(s.data(), s.size());
+    }
+
+    void Push(char c) { Append(std::string_view(&c, 1)); }
+
+    void PutFixed64LE(uint64_t v) {
+        char b[8];
+        for (int i = 0; i < 8; ++i) b[i] = static_cast<char>(v >> (i * 8));
+        Append(std::string_view(b, 8));
+    }
+
+    // 大端: 字节序与数值序一致, 用于需要按数值有序扫描的 key
+    void PutFixed64BE(uint64_t v) {
+        char b[8];
+        for (int i = 0; i < 8; ++i) b[i] = static_cast<char>(v >> ((7 - i) * 8));
+        Append(std::string_view(b, 8));
+    }
+
+    const char* data() const { return on_heap_ ? heap_.data() : buf_; }
+    size_t size() const { return on_heap_ ? heap_.size() : size_; }
+    std::string_view view() const { return std::string_view(data(), size()); }
+    std::string ToString() const { return std::string(data(), size()); }
+
+private:
+    char buf_[N];
+    size_t size_ = 0;
+    bool on_heap_ = false;
+    std::string heap_;
+};
+
+} // namespace nebulastore::codec
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <sys/uio.h>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <optional>
@@ -79,6 +84,11 @@ struct SliceInfo {
     std::string storage_key; // 存储键: chunks/{inode}/{slice}
 };
 
+// 写入器生成的默认存储键 (元数据编码时省略)
+inline std::string SliceStorageKey(uint64_t inode, uint64_t slice_id) {
+    return "chunks/" + std::to_string(inode) + "/" + std::to_string(slice_id);
+}
+
 // ================================
 // FileLayout: 文件布局
 // ================================
@@ -101,6 +111,7 @@ enum class ErrorCode : int {
     kInvalidArgument = 22,
     kIOError = 5,
     kNoSpace = 28,
+    kAgain = 11,            // 并发修改冲突, 可重新读取后重试
 };
 
 class Status {
@@ -129,6 +140,9 @@ public:
     static Status IO(const std::string& msg = "") {
         return Status(ErrorCode::kIOError, msg);
     }
+    static Status Again(const std::string& msg = "") {
+        return Status(ErrorCode::kAgain, msg);
+    }
 
 private:
     ErrorCode code_;
@@ -138,32 +152,175 @@ private:
 // ================================
 // ByteBuffer
 // ================================
+//
+// 引用计数的字节视图: 底层内存由 owner 持有, 拷贝与 Slice() 只增加引用计数,
+// 不复制数据 (写入 data() 对共享同一内存的视图可见, 需要独立副本用 Clone()).
+// 内存来源: Allocate() 未初始化分配, 接管 vector/string, Wrap() 接管外部内存
+// (缓冲池、mmap 等), Unowned() 借用调用方内存.
 class ByteBuffer {
 public:
     ByteBuffer() = default;
-    ByteBuffer(const void* data, size_t size) {
-        const uint8_t* ptr = static_cast<const uint8_t*>(data);
-        data_.assign(ptr, ptr + size);
+
+    // 复制外部数据
+    ByteBuffer(const void* data, size_t size) { assign(data, size); }
+
+    // 接管 vector, 不复制
+    ByteBuffer(std::vector<uint8_t>&& data) { assign(std::move(data)); }
+
+    // 分配 size 字节, 内容未初始化
+    static ByteBuffer Allocate(size_t size) {
+        ByteBuffer buf;
+        if (size > 0) {
+            std::shared_ptr<uint8_t[]> mem(new uint8_t[size]);
+            buf.data_ = mem.get();
+            buf.size_ = size;
+            buf.owner_ = std::move(mem);
+        }
+        return buf;
+    }
+
+    // 接管 string, 不复制; 独占时 std::move(buf).ToString() 原样交还
+    static ByteBuffer FromString(std::string&& str) {
+        ByteBuffer buf;
+        auto owner = std::make_shared<std::string>(std::move(str));
+        buf.data_ = reinterpret_cast<uint8_t*>(owner->data());
+        buf.size_ = owner->size();
+        buf.string_owner_ = true;
+        buf.owner_ = std::move(owner);
+        return buf;
+    }
+
+    // 接管外部内存: owner 最后一个引用释放时内存随之释放
+    static ByteBuffer Wrap(uint8_t* data, size_t size, std::shared_ptr<void> owner) {
+        ByteBuffer buf;
+        buf.data_ = data;
+        buf.size_ = size;
+        buf.owner_ = std::move(owner);
+        return buf;
     }
-    ByteBuffer(std::vector<uint8_t>&& data) : data_(std::move(data)) {}
 
-    const uint8_t* data() const { return data_.data(); }
-    uint8_t* data() { return data_.data(); }
-    size_t size() const { return data_.size(); }
-    bool empty() const { return data_.empty(); }
+    // 借用调用方内存, 调用方保证其在 ByteBuffer (含拷贝) 存活期间有效.
+    // 只用于同步调用链, 不得被缓存或跨请求保留
+    static ByteBuffer Unowned(const void* data, size_t size) {
+        ByteBuffer buf;
+        buf.data_ = static_cast<uint8_t*>(const_cast<void*>(data));
+        buf.size_ = size;
+        return buf;
+    }
+
+    const uint8_t* data() const { return data_; }
+    uint8_t* data() { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // 子区间视图, 越界部分截断
+    ByteBuffer Slice(size_t offset, size_t len) const {
+        ByteBuffer out(*this);
+        if (offset > size_) offset = size_;
+        out.data_ = data_ + offset;
+        out.size_ = std::min(len, size_ - offset);
+        return out;
+    }
+
+    // 缩短视图 (短读后使用), 不释放内存
+    void Truncate(size_t size) {
+        if (size < size_) size_ = size;
+    }
+
+    // 深拷贝到新分配的内存
+    ByteBuffer Clone() const {
+        ByteBuffer out = Allocate(size_);
+        if (size_ > 0) std::memcpy(out.data_, data_, size_);
+        return out;
+    }
 
     void assign(const void* ptr, size_t size) {
-        const uint8_t* p = static_cast<const uint8_t*>(ptr);
-        data_.assign(p, p + size);
+        *this = Allocate(size);
+        if (size > 0) std::memcpy(data_, ptr, size);
+    }
+
+    void assign(std::vector<uint8_t>&& vec) {
+        auto owner = std::make_shared<std::vector<uint8_t>>(std::move(vec));
+        data_ = owner->data();
+        size_ = owner->size();
+        string_owner_ = false;
+        owner_ = std::move(owner);
+    }
+
+    std::string_view view() const {
+        return std::string_view(reinterpret_cast<const char*>(data_), size_);
+    }
+
+    iovec ToIovec() const { return iovec{data_, size_}; }
+
+    std::string ToString() const& { return std::string(view()); }
+
+    // 由 FromString 构造且独占整串时直接交出, 否则复制
+    std::string ToString() && {
+        if (string_owner_ && owner_.use_count() == 1) {
+            auto* str = static_cast<std::string*>(owner_.get());
+            if (reinterpret_cast<uint8_t*>(str->data()) == data_ && str->size() == size_) {
+                std::string out = std::move(*str);
+                *this = ByteBuffer();
+                return out;
+            }
+        }
+        std::string out = ToString();
+        *this = ByteBuffer();
+        return out;
+    }
+
+private:
+    std::shared_ptr<void> owner_;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool string_owner_ = false;   // owner_ 指向 std::string
+};
+
+// ================================
+// ByteBufferChain: 分散/聚集缓冲链
+// ================================
+//
+// 按顺序拼接多个 ByteBuffer 而不复制, 可导出 iovec 供 writev/readv/io_uring 使用.
+class ByteBufferChain {
+public:
+    void Append(ByteBuffer buf) {
+        if (buf.empty()) return;
+        size_ += buf.size();
+        buffers_.push_back(std::move(buf));
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const std::vector<ByteBuffer>& buffers() const { return buffers_; }
+
+    std::vector<iovec> ToIovecs() const {
+        std::vector<iovec> iovs;
+        iovs.reserve(buffers_.size());
+        for (const auto& b : buffers_) iovs.push_back(b.ToIovec());
+        return iovs;
+    }
+
+    // 合并为单个 ByteBuffer: 只有一段时共享, 否则复制一次
+    ByteBuffer Coalesce() const {
+        if (buffers_.size() == 1) return buffers_[0];
+        ByteBuffer out = ByteBuffer::Allocate(size_);
+        size_t off = 0;
+        for (const auto& b : buffers_) {
+            std::memcpy(out.data() + off, b.data(), b.size());
+            off += b.size();
+        }
+        return out;
     }
-    void assign(std::vector<uint8_t>&& vec) { data_ = std::move(vec); }
 
-    std::string ToString() const {
-        return std::string(reinterpret_cast<const char*>(data_.data()), data_.size());
+    void Clear() {
+        buffers_.clear();
+        size_ = 0;
     }
 
 private:
-    std::vector<uint8_t> data_;
+    std::vector<ByteBuffer> buffers_;
+    size_t size_ = 0;
 };
 
 // ================================
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <rocksdb/db.h>
+#include <rocksdb/write_batch.h>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nebulastore/common/types.h"
+
+namespace nebulastore::metadata {
+
+// ================================
+// 元数据写入合批 (group commit)
+// ================================
+//
+// 每个事务单独 DB::Write(sync) 时, 每次提交都要等一次 WAL fsync, 大量并发小事务
+// 被 fsync 串行化. 合批器用一个写线程消费提交队列: 把排队中的多个 WriteBatch
+// 按提交顺序拼成一个, 一次 DB::Write 写 WAL 并 fsync, 再逐个完成等待者.
+// - 写入进行时到达的提交自然在下一组合并; max_delay_us > 0 时队列未满会再等待
+//   至多这么久凑批, 用延迟换吞吐
+// - 单个提交的 WriteBatch 无法拼接 (如含不支持的操作) 时只有它失败, 不影响同组
+// - 整组写入失败时组内所有提交都返回该错误
+// - 协程提交在写线程上恢复 (与 IoEngine 相同); 写线程上的同步提交直接写入, 不排队
+//
+// 乐观并发: 提交可附带读集合 (事务读到的 key 及当时的值). 写线程在写入前逐个校验,
+// 所有写入都经过写线程, 校验与写入之间不会插入其他事务:
+// - key 已被同组排在前面的提交写过, 或库中的值与读到的不同, 该提交返回 kAgain
+// - 构造时给出 write_mutex 的话, 校验到写入完成期间持有它, 与不经合批器的
+//   读-改-写 (如 RocksDBStore::AppendSlices) 互斥
+
+class GroupCommitter {
+public:
+    struct Options {
+        uint32_t max_batch = 100;       // 一次写入最多合并的提交数 (performance.batch_size)
+        uint64_t max_delay_us = 0;      // 凑批的最长等待, 0 只合并已排队的提交
+        bool sync = true;               // WAL fsync
+    };
+
+    struct Stats {
+        uint64_t commits = 0;           // 完成的提交数 (含失败)
+        uint64_t groups = 0;            // DB::Write 次数
+        uint64_t max_group = 0;         // 单组最多提交数
+        uint64_t failures = 0;
+        uint64_t conflicts = 0;         // 读集合校验失败的提交数
+    };
+
+    // 读集合中的一项: exists 为 false 表示读到 key 不存在
+    struct ReadCheck {
+        std::string key;
+        bool exists = false;
+        std::string value;
+    };
+
+    GroupCommitter(rocksdb::DB* db, Options options, std::mutex* write_mutex = nullptr);
+    // 写完已排队的提交后停止写线程
+    ~GroupCommitter();
+
+    GroupCommitter(const GroupCommitter&) = delete;
+    GroupCommitter& operator=(const GroupCommitter&) = delete;
+
+    // 单个提交: 完成前调用方须保持 batch 有效
+    struct Request {
+        rocksdb::WriteBatch* batch = nullptr;
+        const std::vector<ReadCheck>* reads = nullptr;     // 可选, 写入前校验
+        Status status;
+        void (*on_complete)(Request*) = nullptr;
+        std::coroutine_handle<> waiter;
+    };
+
+    class CommitAwaiter {
+    public:
+        CommitAwaiter(GroupCommitter* owner, rocksdb::WriteBatch* batch,
+                      const std::vector<ReadCheck>* reads)
+            : owner_(owner) {
+            req_.batch = batch;
+            req_.reads = reads;
+            req_.on_complete = &CommitAwaiter::Resume;
+        }
+
+        bool await_ready() noexcept { return false; }
+
+        // 已停止时不挂起, 直接返回错误
+        bool await_suspend(std::coroutine_handle<> h) {
+            req_.waiter = h;
+            return owner_->Enqueue(&req_);
+        }
+
+        Status await_resume() { return std::move(req_.status); }
+
+    private:
+        static void Resume(Request* r) { r->waiter.resume(); }
+
+        GroupCommitter* owner_;
+        Request req_;
+    };
+
+    // 协程提交: co_await committer.Commit(&batch); reads 非空时先校验
+    CommitAwaiter Commit(rocksdb::WriteBatch* batch,
+                         const std::vector<ReadCheck>* reads = nullptr) {
+        return CommitAwaiter(this, batch, reads);
+    }
+
+    // 阻塞提交, 与其他线程的并发提交合并
+    Status CommitSync(rocksdb::WriteBatch* batch, const std::vector<ReadCheck>* reads = nullptr);
+
+    Stats stats() const;
+
+private:
+    // 入队; 已停止时写入 r->status 并返回 false
+    bool Enqueue(Request* r);
+    void Loop();
+    void WriteGroup(std::deque<Request*>& group);
+
+    rocksdb::DB* db_;
+    Options options_;
+    std::mutex* write_mutex_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Request*> queue_;
+    Stats stats_;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+} // namespace nebulastore::metadata
@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <mutex>
 #include "nebulastore/common/types.h"
+#include "nebulastore/metadata/value_codec.h"
 
 namespace nebulastore::metadata {
 
@@ -29,6 +30,23 @@ struct KVPair {
     std::string value;
 };
 
+// 流式扫描回调: 视图只在回调内有效, 返回 false 提前结束
+using KVVisitor = std::function<bool(std::string_view key, std::string_view value)>;
+
+struct ScanOptions {
+    uint32_t limit = 0;             // 0 不限
+    size_t readahead_size = 0;      // 0 用后端默认 (RocksDB 连续读时自动增大预读)
+    bool fill_cache = true;         // 一次性的批量扫描设为 false, 避免冲掉点查热数据
+
+    // 长扫描: 大预读, 不填充缓存
+    static ScanOptions Bulk() {
+        ScanOptions options;
+        options.readahead_size = 2 << 20;
+        options.fill_cache = false;
+        return options;
+    }
+};
+
 // ================================
 // KVClient 接口 - 通用 KV 存储抽象
 // ================================
@@ -36,8 +54,8 @@ class KVClient {
 public:
     virtual ~KVClient() = default;
 
-    // 基础操作
-    virtual Status Get(const std::string& key, std::string* value) = 0;
+    // 基础操作; Get 写入调用方的缓冲, 复用同一缓冲可避免重复分配
+    virtual Status Get(std::string_view key, std::string* value) = 0;
     virtual Status Set(const std::string& key, const std::string& value) = 0;
     virtual Status Delete(const std::string& key) = 0;
 
@@ -45,6 +63,18 @@ public:
     virtual Status Scan(const std::string& start, const std::string& end,
                         std::vector<KVPair>* results, uint32_t limit = 0) = 0;
 
+    // 流式范围扫描, 不物化结果; 默认实现经 Scan 物化后回调
+    virtual Status ScanEach(std::string_view start, std::string_view end,
+                            const KVVisitor& visit, const ScanOptions& options = {}) {
+        std::vector<KVPair> kvs;
+        auto s = Scan(std::string(start), std::string(end), &kvs, options.limit);
+        if (!s.OK()) return s;
+        for (auto& kv : kvs) {
+            if (!visit(kv.key, kv.value)) break;
+        }
+        return Status::Ok();
+    }
+
     // 事务批量操作
     virtual Status Txn(const std::vector<TxnOp>& ops) = 0;
 };
@@ -134,19 +164,25 @@ public:
 
     Status CreateInode(InodeID inode, FileMode mode, UserID uid, GroupID gid) override {
         InodeAttr attr{inode, mode, uid, gid, 0, NowInSeconds(), NowInSeconds(), 1};
-        return client_->Set(EncodeInodeKey(inode), EncodeInodeValue(attr));
+        std::string value;
+        EncodeInodeValue(attr, &value);
+        return client_->Set(EncodeInodeKey(inode), value);
     }
 
     Status GetAttr(InodeID inode, InodeAttr* attr) override {
-        std::string value;
-        auto s = client_->Get(EncodeInodeKey(inode), &value);
+        KeyBuffer key;
+        EncodeInodeKey(inode, &key);
+        std::string& value = ReadBuffer();
+        auto s = client_->Get(key.view(), &value);
         if (!s.OK()) return s;
-        *attr = DecodeInodeValue(value);
+        if (!DecodeInodeValue(value, attr)) return Status::IO("Corrupted inode");
         return Status::Ok();
     }
 
     Status SetAttr(InodeID inode, const InodeAttr& attr, uint32_t /*to_set*/) override {
-        return client_->Set(EncodeInodeKey(inode), EncodeInodeValue(attr));
+        std::string value;
+        EncodeInodeValue(attr, &value);
+        return client_->Set(EncodeInodeKey(inode), value);
     }
 
     Status DeleteInode(InodeID inode) override {
@@ -154,17 +190,20 @@ public:
     }
 
     Status Lookup(InodeID parent, const std::string& name, Dentry* dentry) override {
-        std::string value;
-        auto s = client_->Get(EncodeDentryKey(parent, name), &value);
+        KeyBuffer key;
+        EncodeDentryKey(parent, name, &key);
+        std::string& value = ReadBuffer();
+        auto s = client_->Get(key.view(), &value);
         if (!s.OK()) return s;
-        *dentry = DecodeDentryValue(value);
+        if (!DecodeDentryValue(value, dentry)) return Status::IO("Corrupted dentry");
         dentry->name = name;
         return Status::Ok();
     }
 
     Status CreateDentry(InodeID parent, const std::string& name, InodeID inode, FileType type) override {
-        Dentry d{name, inode, type};
-        return client_->Set(EncodeDentryKey(parent, name), EncodeDentryValue(d));
+        std::string value;
+        EncodeDentryValue(Dentry{name, inode, type}, &value);
+        return client_->Set(EncodeDentryKey(parent, name), value);
     }
 
     Status DeleteDentry(InodeID parent, const std::string& name) override {
@@ -174,35 +213,46 @@ public:
     Status Readdir(InodeID parent, std::vector<Dentry>* entries) override {
         std::string prefix = "D" + EncodeU64(parent);
         std::string end = "D" + EncodeU64(parent + 1);
-        std::vector<KVPair> kvs;
-        auto s = client_->Scan(prefix, end, &kvs);
-        if (!s.OK()) return s;
         entries->clear();
-        for (auto& kv : kvs) {
-            Dentry d = DecodeDentryValue(kv.value);
-            d.name = kv.key.substr(9);  // 跳过 "D" + 8字节 parent
+        bool corrupted = false;
+        auto s = client_->ScanEach(prefix, end, [&](std::string_view key, std::string_view value) {
+            Dentry d{};
+            if (!DecodeDentryValue(value, &d)) {
+                corrupted = true;
+                return false;
+            }
+            d.name = key.substr(9);  // 跳过 "D" + 8字节 parent
             entries->push_back(std::move(d));
-        }
+            return true;
+        });
+        if (!s.OK()) return s;
+        if (corrupted) return Status::IO("Corrupted dentry");
         return Status::Ok();
     }
 
     Status AddSlice(InodeID inode, const SliceInfo& slice) override {
         std::string key = EncodeSliceKey(inode, slice.offset);
-        return client_->Set(key, EncodeSliceValue(slice));
+        return client_->Set(key, EncodeSliceValue(inode, slice));
     }
 
     Status GetLayout(InodeID inode, FileLayout* layout) override {
         std::string prefix = "S" + EncodeU64(inode);
         std::string end = "S" + EncodeU64(inode + 1);
-        std::vector<KVPair> kvs;
-        auto s = client_->Scan(prefix, end, &kvs);
-        if (!s.OK()) return s;
         layout->inode_id = inode;
         layout->chunk_size = 4 * 1024 * 1024;  // 4MB default
         layout->slices.clear();
-        for (auto& kv : kvs) {
-            layout->slices.push_back(DecodeSliceValue(kv.value));
-        }
+        bool corrupted = false;
+        auto s = client_->ScanEach(prefix, end, [&](std::string_view, std::string_view value) {
+            SliceInfo slice;
+            if (!DecodeSliceValue(inode, value, &slice)) {
+                corrupted = true;
+                return false;
+            }
+            layout->slices.push_back(std::move(slice));
+            return true;
+        });
+        if (!s.OK()) return s;
+        if (corrupted) return Status::IO("Corrupted slice");
         return Status::Ok();
     }
 
@@ -231,70 +281,39 @@ private:
     static std::string EncodeDentryKey(InodeID parent, const std::string& name) {
         return "D" + EncodeU64(parent) + name;
     }
-    static std::string EncodeSliceKey(InodeID inode, uint64_t offset) {
-        return "S" + EncodeU64(inode) + EncodeU64(offset);
-    }
 
-    // Value 编码 (简单二进制格式)
-    static std::string EncodeInodeValue(const InodeAttr& a) {
-        std::string s;
-        s.reserve(64);
-        s += EncodeU64(a.inode_id);
-        s += EncodeU64(a.mode.mode);
-        s += EncodeU64(a.uid);
-        s += EncodeU64(a.gid);
-        s += EncodeU64(a.size);
-        s += EncodeU64(a.mtime);
-        s += EncodeU64(a.ctime);
-        s += EncodeU64(a.nlink);
-        return s;
+    // 点查用: key 拼在栈上, value 读进线程内复用的缓冲, 命中时不分配
+    using KeyBuffer = codec::KeyBuffer<1 + 8 + 255>;
+    static void EncodeInodeKey(InodeID inode, KeyBuffer* key) {
+        key->Push('I');
+        key->PutFixed64BE(inode);
     }
-
-    static InodeAttr DecodeInodeValue(const std::string& s) {
-        InodeAttr a;
-        a.inode_id = DecodeU64(s, 0);
-        a.mode = FileMode::FromUint(static_cast<uint32_t>(DecodeU64(s, 8)));
-        a.uid = static_cast<UserID>(DecodeU64(s, 16));
-        a.gid = static_cast<GroupID>(DecodeU64(s, 24));
-        a.size = DecodeU64(s, 32);
-        a.mtime = DecodeU64(s, 40);
-        a.ctime = DecodeU64(s, 48);
-        a.nlink = DecodeU64(s, 56);
-        return a;
+    static void EncodeDentryKey(InodeID parent, std::string_view name, KeyBuffer* key) {
+        key->Push('D');
+        key->PutFixed64BE(parent);
+        key->Append(name);
     }
-
-    static std::string EncodeDentryValue(const Dentry& d) {
-        std::string s;
-        s += EncodeU64(d.inode_id);
-        s += EncodeU64(static_cast<uint64_t>(d.type));
-        return s;
+    static std::string& ReadBuffer() {
+        thread_local std::string buf;
+        return buf;
     }
-
-    static Dentry DecodeDentryValue(const std::string& s) {
-        Dentry d;
-        d.inode_id = DecodeU64(s, 0);
-        d.type = static_cast<FileType>(DecodeU64(s, 8));
-        return d;
+    static std::string EncodeSliceKey(InodeID inode, uint64_t offset) {
+        return "S" + EncodeU64(inode) + EncodeU64(offset);
     }
 
-    static std::string EncodeSliceValue(const SliceInfo& sl) {
+    // Value 编码见 value_codec.h; slice value 为 ver | slice 记录 (offset 相对 0)
+    static std::string EncodeSliceValue(InodeID inode, const SliceInfo& sl) {
         std::string s;
-        s += EncodeU64(sl.slice_id);
-        s += EncodeU64(sl.offset);
-        s += EncodeU64(sl.size);
-        s += EncodeU64(sl.storage_key.size());
-        s += sl.storage_key;
+        s.push_back(static_cast<char>(kValueFormatV2));
+        EncodeSliceRecord(sl, inode, 0, &s);
         return s;
     }
 
-    static SliceInfo DecodeSliceValue(const std::string& s) {
-        SliceInfo sl;
-        sl.slice_id = DecodeU64(s, 0);
-        sl.offset = DecodeU64(s, 8);
-        sl.size = DecodeU64(s, 16);
-        uint64_t len = DecodeU64(s, 24);
-        sl.storage_key = s.substr(32, len);
-        return sl;
+    static bool DecodeSliceValue(InodeID inode, std::string_view s, SliceInfo* sl) {
+        codec::Reader reader(s);
+        uint8_t version;
+        return reader.GetByte(&version) && version == kValueFormatV2 &&
+               DecodeSliceRecord(&reader, inode, 0, sl) && reader.empty();
     }
 };
 
@@ -305,10 +324,15 @@ class RocksDBKVClient : public KVClient {
 public:
     explicit RocksDBKVClient(rocksdb::DB* db) : db_(db) {}
 
-    Status Get(const std::string& key, std::string* value) override {
-        auto s = db_->Get(rocksdb::ReadOptions(), key, value);
+    Status Get(std::string_view key, std::string* value) override {
+        // 以 value 为 PinnableSlice 的自有缓冲: memtable 命中时直接写入其中,
+        // block cache 命中时 pin 住缓存块, 再拷贝一次到 value (容量可复用)
+        rocksdb::PinnableSlice pinned(value);
+        auto s = db_->Get(rocksdb::ReadOptions(), db_->DefaultColumnFamily(),
+                          rocksdb::Slice(key.data(), key.size()), &pinned);
         if (s.IsNotFound()) return Status::NotFound();
         if (!s.ok()) return Status::IO(s.ToString());
+        if (pinned.IsPinned()) value->assign(pinned.data(), pinned.size());
         return Status::Ok();
     }
 
@@ -327,12 +351,34 @@ public:
     Status Scan(const std::string& start, const std::string& end,
                 std::vector<KVPair>* results, uint32_t limit = 0) override {
         results->clear();
-        std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+        ScanOptions options;
+        options.limit = limit;
+        return ScanEach(start, end, [results](std::string_view key, std::string_view value) {
+            results->push_back({std::string(key), std::string(value)});
+            return true;
+        }, options);
+    }
+
+    Status ScanEach(std::string_view start, std::string_view end,
+                    const KVVisitor& visit, const ScanOptions& options = {}) override {
+        // 上界交给 RocksDB: 越界即停, 并可据此跳过不相交的 SST
+        rocksdb::Slice upper(end.data(), end.size());
+        rocksdb::ReadOptions read_options;
+        read_options.iterate_upper_bound = &upper;
+        read_options.readahead_size = options.readahead_size;
+        read_options.fill_cache = options.fill_cache;
+        std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(read_options));
         uint32_t count = 0;
-        for (it->Seek(start); it->Valid() && it->key().ToString() < end; it->Next()) {
-            results->push_back({it->key().ToString(), it->value().ToString()});
-            if (limit > 0 && ++count >= limit) break;
+        for (it->Seek(rocksdb::Slice(start.data(), start.size())); it->Valid(); it->Next()) {
+            rocksdb::Slice key = it->key();
+            rocksdb::Slice value = it->value();
+            if (!visit(std::string_view(key.data(), key.size()),
+                       std::string_view(value.data(), value.size()))) {
+                break;
+            }
+            if (options.limit > 0 && ++count >= options.limit) break;
         }
+        if (!it->status().ok()) return Status::IO(it->status().ToString());
         return Status::Ok();
     }
 
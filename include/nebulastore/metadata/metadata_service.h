@@ -78,6 +78,32 @@ public:
         FileLayout* layout
     ) = 0;
 
+    // 获取读取 [offset, offset + size) 所需的布局: 至少包含与该范围相交的 slice
+    // 及结束位置最大的 slice, 顺序与 GetLayout 一致. 默认返回完整布局
+    virtual AsyncTask<Status> GetLayoutRange(
+        InodeID inode,
+        uint64_t offset,
+        uint64_t size,
+        FileLayout* layout
+    ) {
+        (void)offset;
+        (void)size;
+        co_return co_await GetLayout(inode, layout);
+    }
+
+    // 文件布局的 chunk 大小 (写入器切分用), 不读取 slice. 默认取完整布局
+    virtual AsyncTask<Status> GetChunkSize(
+        InodeID inode,
+        uint64_t* chunk_size
+    ) {
+        FileLayout layout;
+        auto status = co_await GetLayout(inode, &layout);
+        if (status.OK()) {
+            *chunk_size = layout.chunk_size;
+        }
+        co_return status;
+    }
+
     // 添加 slice
     virtual AsyncTask<Status> AddSlice(
         InodeID inode,
@@ -90,6 +116,36 @@ public:
         uint64_t new_size
     ) = 0;
 
+    // 批量提交 slice (按顺序追加), 文件大小提升到至少 min_size.
+    // 默认逐个 AddSlice 再 UpdateSize, 实现应覆盖为一次原子提交
+    virtual AsyncTask<Status> AddSlices(
+        InodeID inode,
+        const std::vector<SliceInfo>& slices,
+        uint64_t min_size
+    ) {
+        for (const auto& slice : slices) {
+            auto status = co_await AddSlice(inode, slice);
+            if (!status.OK()) {
+                co_return status;
+            }
+        }
+        co_return co_await UpdateSize(inode, min_size);
+    }
+
+    // 原子替换布局开头的一段 slice (压缩用): 布局须仍以 expected 开头 (按 slice_id
+    // 比较), 这一段被 replacement 取代, 其后追加的 slice 保持不变. 布局已被改写时
+    // 返回 kAgain. 默认不支持
+    virtual AsyncTask<Status> ReplaceSlices(
+        InodeID inode,
+        const std::vector<SliceInfo>& expected,
+        const std::vector<SliceInfo>& replacement
+    ) {
+        (void)inode;
+        (void)expected;
+        (void)replacement;
+        co_return Status::IO("ReplaceSlices not supported");
+    }
+
     // === 查找操作 ===
 
     // 路径解析: /a/b/c → inode_id
@@ -128,9 +184,32 @@ public:
             GroupID gid
         ) = 0;
 
-        // 提交事务
+        // 更新 inode (整条覆盖)
+        virtual Status UpdateInode(const InodeAttr& attr) = 0;
+
+        // 删除 dentry / inode / 文件布局 (布局头与全部 chunk)
+        virtual Status DeleteDentry(InodeID parent, const std::string& name) = 0;
+        virtual Status DeleteInode(InodeID inode) = 0;
+        virtual Status DeleteLayout(InodeID inode) = 0;
+
+        // 读取已提交的 dentry / inode 并记入读集合 (乐观并发): 提交时若它已被其他
+        // 提交创建、修改或删除, Commit 返回 kAgain 且整个事务不写入.
+        // 读不到本事务尚未提交的修改
+        virtual Status ReadDentry(
+            InodeID parent,
+            const std::string& name,
+            Dentry* dentry
+        ) = 0;
+        virtual Status ReadInode(InodeID inode, InodeAttr* attr) = 0;
+
+        // 提交事务: 全部修改一次原子写入
         virtual Status Commit() = 0;
 
+        // 异步提交, 等待写入时不占用线程. 默认同步提交
+        virtual AsyncTask<Status> CommitAsync() {
+            co_return Commit();
+        }
+
         // 回滚事务
         virtual Status Rollback() = 0;
     };
@@ -170,6 +249,11 @@ public:
         uint64_t start_inode;
         uint64_t end_inode;
         std::string data_dir;  // RocksDB 数据目录
+
+        // 事务提交合批 (metadata.yaml performance 段)
+        uint32_t batch_size = 100;          // performance.batch_size: 一次 WAL 写入最多合并的事务数
+        uint64_t batch_max_delay_us = 0;    // performance.batch_max_delay_us: 凑批的最长等待
+        bool sync_wal = true;
     };
 
     explicit MetaPartition(const Config& config);
@@ -181,6 +265,14 @@ public:
     // 初始化
     Status Init();
 
+    // === 事务 ===
+
+    // 多条记录的修改 (如 dentry + inode) 在一次提交中原子写入, 只覆盖本分区的记录
+    std::unique_ptr<MetadataStore::Transaction> BeginTransaction();
+
+    // 异步提交; 读集合校验失败返回 kAgain, 调用方重新读取后重试
+    AsyncTask<Status> Commit(MetadataStore::Transaction* txn);
+
     // === 查询操作 ===
 
     // 查找 inode (内存 BTree)
@@ -221,6 +313,17 @@ public:
     // === 目录扫描 ===
     AsyncTask<Status> ListDentries(InodeID parent, std::vector<Dentry>* entries);
 
+    // === 文件布局 ===
+    AsyncTask<Status> GetLayout(InodeID inode, FileLayout* layout);
+    AsyncTask<Status> GetLayoutRange(InodeID inode, uint64_t offset, uint64_t size,
+                                     FileLayout* layout);
+    AsyncTask<Status> GetChunkSize(InodeID inode, uint64_t* chunk_size);
+    AsyncTask<Status> AppendSlices(InodeID inode, const std::vector<SliceInfo>& slices,
+                                   uint64_t min_size);
+    AsyncTask<Status> SetSize(InodeID inode, uint64_t size);
+    AsyncTask<Status> ReplaceSlices(InodeID inode, const std::vector<SliceInfo>& expected,
+                                    const std::vector<SliceInfo>& replacement);
+
     // === 规模自适应 (沧海设计) ===
 
     enum class ScaleMode {
@@ -320,6 +423,18 @@ public:
         FileLayout* layout
     ) override;
 
+    AsyncTask<Status> GetLayoutRange(
+        InodeID inode,
+        uint64_t offset,
+        uint64_t size,
+        FileLayout* layout
+    ) override;
+
+    AsyncTask<Status> GetChunkSize(
+        InodeID inode,
+        uint64_t* chunk_size
+    ) override;
+
     AsyncTask<Status> AddSlice(
         InodeID inode,
         const SliceInfo& slice
@@ -330,6 +445,18 @@ public:
         uint64_t new_size
     ) override;
 
+    AsyncTask<Status> AddSlices(
+        InodeID inode,
+        const std::vector<SliceInfo>& slices,
+        uint64_t min_size
+    ) override;
+
+    AsyncTask<Status> ReplaceSlices(
+        InodeID inode,
+        const std::vector<SliceInfo>& expected,
+        const std::vector<SliceInfo>& replacement
+    ) override;
+
     AsyncTask<Status> LookupPath(
         const std::string& path,
         InodeID* inode_id
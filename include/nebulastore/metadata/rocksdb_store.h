@@ -4,6 +4,9 @@
 #include <rocksdb/write_batch.h>
 #include <rocksdb/options.h>
 #include <memory>
+#include <mutex>
+#include "nebulastore/common/codec.h"
+#include "nebulastore/metadata/group_commit.h"
 #include "nebulastore/metadata/metadata_service.h"
 
 namespace nebulastore::metadata {
@@ -11,6 +14,17 @@ namespace nebulastore::metadata {
 // ================================
 // RocksDB 元数据存储实现
 // ================================
+//
+// 文件布局按 chunk 分 key 存储, 大文件追加 slice 无需重写整份布局:
+// - 布局头 "L" + inode: chunk_size + 下一个提交序号
+// - chunk  "L" + inode + chunk_idx: 与该 chunk 相交的 slice 记录, 追加走 merge 操作
+//   (值拼接), 不读旧值; 跨 chunk 的 slice 在每个相交的 chunk 各存一份
+// 记录带提交序号, 读取时按序号排序去重即还原写入顺序 (后写覆盖先写).
+// 早期 (v1) 把整份布局存在布局头 key 下; 读取时按 v1 解码, 下一次追加/替换时
+// 转存为布局头 + chunk.
+//
+// 点查 (LookupDentry/LookupInode) 不分配堆内存: key 拼在栈上, value 经线程内复用的
+// PinnableSlice 读取, 命中 block cache 时直接在缓存内存上解码.
 
 class RocksDBStore : public MetadataStore {
 public:
@@ -19,6 +33,7 @@ public:
         bool create_if_missing = true;
         uint64_t cache_size = 1ULL << 30;  // 1GB 缓存
         uint32_t max_open_files = 100000;
+        GroupCommitter::Options group_commit;   // 事务提交合批
     };
 
     explicit RocksDBStore(const Config& config);
@@ -26,6 +41,9 @@ public:
 
     Status Init();
 
+    // 事务提交合批器, Init 后有效
+    GroupCommitter* committer() { return committer_.get(); }
+
     // === 实现 MetadataStore 接口 ===
 
     std::unique_ptr<Transaction> BeginTransaction() override;
@@ -46,6 +64,18 @@ public:
         FileLayout* layout
     ) override;
 
+    // 只读取与 [offset, offset + size) 相交的 chunk, 另加文件最后一个 chunk
+    // (其中有结束位置最大的 slice, 读取据此判断 EOF)
+    Status LookupLayoutRange(
+        InodeID inode,
+        uint64_t offset,
+        uint64_t size,
+        FileLayout* layout
+    );
+
+    // 只读布局头取 chunk 大小, 没有布局时为默认值
+    Status LookupChunkSize(InodeID inode, uint64_t* chunk_size);
+
     // === 删除操作 ===
     Status DeleteDentry(InodeID parent, const std::string& name);
     Status DeleteInode(InodeID inode);
@@ -54,36 +84,97 @@ public:
     // === 目录扫描 ===
     Status ListDentries(InodeID parent, std::vector<Dentry>* entries);
 
+    // === 布局/大小更新 (读-改-写, 进程内串行) ===
+
+    // 追加一批 slice, 并把文件大小提升到至少 min_size; 布局与 inode 同批写入
+    Status AppendSlices(InodeID inode, const std::vector<SliceInfo>& slices, uint64_t min_size);
+
+    // 设置文件大小 (保留其余属性)
+    Status SetSize(InodeID inode, uint64_t size);
+
+    // 布局仍以 expected 开头时, 把这一段替换为 replacement, 否则返回 kAgain
+    Status ReplaceSlices(InodeID inode, const std::vector<SliceInfo>& expected,
+                         const std::vector<SliceInfo>& replacement);
+
     // === Key/Value 编码 (public for RocksDBTransaction) ===
 
-    // dentry key: "D" + parent_inode(8字节) + name
+    // 栈上 key 缓冲, 文件名不超过 255 字节时不分配
+    using KeyBuffer = codec::KeyBuffer<1 + 8 + 1 + 255>;
+
+    // dentry key: "D" + parent_inode(8字节) + "/" + name
     std::string EncodeDentryKey(InodeID parent, const std::string& name);
+    static void EncodeDentryKey(InodeID parent, std::string_view name, KeyBuffer* key);
 
     // inode key: "I" + inode_id(8字节)
     std::string EncodeInodeKey(InodeID inode);
+    static void EncodeInodeKey(InodeID inode, KeyBuffer* key);
 
-    // layout key: "L" + inode_id(8字节)
+    // layout 头 key: "L" + inode_id(8字节)
     std::string EncodeLayoutKey(InodeID inode);
+    static void EncodeLayoutKey(InodeID inode, KeyBuffer* key);
 
-    // Value 编码/解码
+    // layout chunk key: "L" + inode_id(8字节) + chunk_idx(8字节大端, 按下标有序)
+    std::string EncodeLayoutChunkKey(InodeID inode, uint64_t chunk_idx);
+
+    // 删除布局 (public for RocksDBTransaction): 读布局头登记到读集合, 把布局头与
+    // 现有 chunk key 逐个点删写入 batch, 不写范围删除
+    Status DeleteLayoutKeys(InodeID inode, rocksdb::WriteBatch* batch,
+                            std::vector<GroupCommitter::ReadCheck>* reads);
+
+    // Value 编码/解码 (value_codec.h), 解码失败时返回空值
     std::string EncodeDentryValue(const Dentry& dentry);
-    Dentry DecodeDentryValue(const std::string& value);
+    Dentry DecodeDentryValue(std::string_view value);
 
     std::string EncodeInodeValue(const InodeAttr& inode);
-    InodeAttr DecodeInodeValue(const std::string& value);
-
-    std::string EncodeLayoutValue(const FileLayout& layout);
-    FileLayout DecodeLayoutValue(const std::string& value);
+    InodeAttr DecodeInodeValue(std::string_view value);
 
 private:
+    struct SliceRecord {
+        uint64_t seq;
+        SliceInfo slice;
+    };
+
+    struct LayoutHeader {
+        uint64_t chunk_size = 4ULL << 20;
+        uint64_t next_seq = 0;
+        // v1 整份布局中的 slice (序号 0..n-1), 尚未转存为 chunk
+        std::vector<SliceRecord> legacy;
+    };
+
+    Status LookupLayoutHeader(InodeID inode, LayoutHeader* header);
+    static Status DecodeLayoutHeader(std::string_view value, InodeID inode, LayoutHeader* header);
+    // 读-改-写: 读出当前值并登记到读集合, committer 写入前校验它们未被改写
+    Status ReadForUpdate(std::string key, std::vector<GroupCommitter::ReadCheck>* reads);
+    Status ReadInodeForUpdate(InodeID inode, InodeAttr* attr,
+                              std::vector<GroupCommitter::ReadCheck>* reads);
+    Status ReadLayoutHeaderForUpdate(InodeID inode, LayoutHeader* header,
+                                     std::vector<GroupCommitter::ReadCheck>* reads);
+    // 读取 chunk key 落在 [begin, end) 的全部 slice 记录, keys 非空时一并带回 chunk key
+    Status ScanLayoutChunks(InodeID inode, uint64_t chunk_size,
+                            const std::string& begin, const std::string& end,
+                            std::vector<SliceRecord>* records,
+                            std::vector<std::string>* keys = nullptr);
+    // 记录按序号排序去重后填入 layout
+    static void FillLayout(InodeID inode, const LayoutHeader& header,
+                           std::vector<SliceRecord>* records, FileLayout* layout);
+    // 按 chunk 切分记录写入 batch (merge 追加)
+    void AppendLayoutRecords(InodeID inode, uint64_t chunk_size,
+                             const std::vector<SliceRecord>& records, rocksdb::WriteBatch* batch);
+
     Config config_;
     rocksdb::DB* db_;
     rocksdb::Options options_;
+    std::unique_ptr<GroupCommitter> committer_;     // 先于 db_ 销毁
+    std::mutex update_mutex_;   // 保护布局/inode 的读-改-写; 带读集合的事务校验写入时也持有
 };
 
 // ================================
 // RocksDB 事务实现
 // ================================
+//
+// 修改累积在一个 WriteBatch 中, 提交时经 GroupCommitter 一次原子写入.
+// ReadDentry/ReadInode 记下读到的原始 value, 写线程在写入前逐个比对 (乐观并发),
+// 不一致则整个事务返回 kAgain
 
 class RocksDBTransaction : public MetadataStore::Transaction {
 public:
@@ -106,13 +197,31 @@ public:
         GroupID gid
     ) override;
 
+    Status UpdateInode(const InodeAttr& attr) override;
+    Status DeleteDentry(InodeID parent, const std::string& name) override;
+    Status DeleteInode(InodeID inode) override;
+    Status DeleteLayout(InodeID inode) override;
+
+    Status ReadDentry(
+        InodeID parent,
+        const std::string& name,
+        Dentry* dentry
+    ) override;
+    Status ReadInode(InodeID inode, InodeAttr* attr) override;
+
+    // 经 GroupCommitter 与并发事务合并写入
     Status Commit() override;
+    AsyncTask<Status> CommitAsync() override;
     Status Rollback() override;
 
 private:
+    // 读取 key 并记入读集合; 同一 key 再次读取返回首次读到的值
+    Status RecordRead(std::string key, const GroupCommitter::ReadCheck** read);
+
     rocksdb::DB* db_;
     RocksDBStore* store_;
     rocksdb::WriteBatch batch_;
+    std::vector<GroupCommitter::ReadCheck> reads_;
     bool committed_;
 
     // 编码后的数据
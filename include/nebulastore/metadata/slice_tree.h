@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cstdint>
-#include <memory>
+#include <deque>
 #include <vector>
 #include <string>
 #include "nebulastore/common/types.h"
@@ -15,8 +15,9 @@ struct SliceNode {
     uint64_t off;     // slice 内部偏移
     uint64_t len;     // 使用的长度
     uint64_t pos;     // 在文件中的位置
-    std::shared_ptr<SliceNode> left;
-    std::shared_ptr<SliceNode> right;
+    SliceNode* left = nullptr;
+    SliceNode* right = nullptr;
+    uint32_t priority = 0;    // treap 堆序优先级
 
     SliceNode(uint64_t pos_, uint64_t id_, uint64_t size_, uint64_t off_, uint64_t len_)
         : id(id_), size(size_), off(off_), len(len_), pos(pos_) {}
@@ -24,20 +25,31 @@ struct SliceNode {
     uint64_t End() const { return pos + len; }
 };
 
-using SliceNodePtr = std::shared_ptr<SliceNode>;
+// 指向树内节点, 在下一次 Insert 或树销毁前有效
+using SliceNodePtr = const SliceNode*;
 
 // SliceTree: 管理文件的 slice 集合，处理重叠写入
+//
+// 树中的 slice 互不重叠, 按 pos 有序, 因此 End 也随 pos 单调; 以 pos 为键的
+// treap 即可按区间查询, 无需 max-end 增强. Insert 通过两次 split 取出与新
+// slice 重叠的子树, 只有两端的节点需要裁剪, 中间的整体回收, 复杂度
+// O(log n + k) (k 为被覆盖的 slice 数). split/merge 均为迭代实现.
+// 节点从树自带的 arena 分配, 被覆盖的节点进入空闲链表复用.
 class SliceTree {
 public:
     SliceTree() = default;
 
+    // 节点之间以裸指针相连, 指向 arena 内部
+    SliceTree(const SliceTree&) = delete;
+    SliceTree& operator=(const SliceTree&) = delete;
+
     // 插入新 slice，处理重叠（Cut 算法）
     void Insert(uint64_t pos, uint64_t id, uint64_t size, uint64_t off, uint64_t len);
 
     // 查找包含指定位置的 slice
     SliceNodePtr Find(uint64_t pos) const;
 
-    // 获取范围内的 slices
+    // 获取范围内的 slices (按 pos 升序)
     std::vector<SliceNodePtr> GetRange(uint64_t start, uint64_t end) const;
 
     // 构建最终 SliceInfo 列表
@@ -46,21 +58,29 @@ public:
     // 获取根节点
     SliceNodePtr Root() const { return root_; }
 
+    // 当前 slice 数
+    size_t Count() const { return count_; }
+
 private:
-    SliceNodePtr root_;
+    SliceNode* root_ = nullptr;
+    size_t count_ = 0;
 
-    // Cut 算法：切割被新 slice 覆盖的旧 slices
-    SliceNodePtr Cut(SliceNodePtr node, uint64_t pos, uint64_t len);
+    std::deque<SliceNode> arena_;       // 节点存储, deque 扩容不移动已有元素
+    std::vector<SliceNode*> free_;      // 被覆盖回收的节点
+    uint64_t rng_ = 0x9E3779B97F4A7C15ULL;
 
-    // BST 插入
-    SliceNodePtr InsertNode(SliceNodePtr node, SliceNodePtr new_node);
+    SliceNode* NewNode(uint64_t pos, uint64_t id, uint64_t size, uint64_t off, uint64_t len);
+    // 回收整棵子树
+    void FreeTree(SliceNode* node);
 
-    // 中序遍历收集 slices
-    void InorderCollect(SliceNodePtr node, std::vector<SliceNodePtr>& result) const;
+    // Cut 算法：切掉 [pos, pos + len) 覆盖的部分, 剩余节点分为区间之前与之后两棵树
+    void Cut(uint64_t pos, uint64_t len, SliceNode** before, SliceNode** after);
 
-    // 范围查询辅助
-    void RangeCollect(SliceNodePtr node, uint64_t start, uint64_t end,
-                      std::vector<SliceNodePtr>& result) const;
+    // 按 key 分成 pos < key 与 pos >= key 两棵树
+    static void Split(SliceNode* node, uint64_t key, SliceNode** left, SliceNode** right);
+    // 合并两棵树, left 中所有 pos 小于 right
+    static SliceNode* Merge(SliceNode* left, SliceNode* right);
+    static SliceNode* Last(SliceNode* node);
 };
 
 } // namespace nebulastore
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "nebulastore/common/codec.h"
+#include "nebulastore/common/types.h"
+
+namespace nebulastore::metadata {
+
+// ================================
+// 元数据 value 编码 (版本化紧凑格式)
+// ================================
+//
+// 独立 value 首字节为格式版本; 整数一律 varint, mtime 相对 codec::kTimeBase、
+// ctime 相对 mtime 做差值, 取默认值的字段由可选字段位图省略. 解码只读 string_view,
+// 可以直接解码 PinnableSlice 指向的 block cache 内存.
+//
+// inode:  ver | flags | inode_id | mode | [uid] [gid] [size] [mtime] [ctime] [nlink]
+//         缺省: uid/gid/size/mtime = 0, ctime = mtime, nlink = 1
+// dentry: ver | inode_id | type             (名字已在 key 中, 不再存)
+// slice:  flags | slice_id | offset 差值 | size | [storage_key]
+//         作为记录嵌在更大的 value 中, 无版本字节; offset 相对调用方给出的基准
+//         (如 chunk 起点), storage_key 等于 SliceStorageKey(inode, slice_id) 时省略
+//
+// v1 为早期无版本字节的小端定长格式, 仍可读取 (v2 解码失败且长度吻合时),
+// 写回时一律为 v2:
+// inode v1:  inode_id(8) mode(4) uid(4) gid(4) size(8) mtime(8) ctime(8) nlink(8) = 52 字节
+// dentry v1: inode_id(8) type(4) = 12 字节
+// layout v1: chunk_size(8) count(4) [slice_id(8) offset(8) size(8) key_len(4) key]*
+//            整份布局存在 "L" + inode 下, 现由 RocksDBStore 读出后转存为按 chunk 的格式
+
+constexpr uint8_t kValueFormatV2 = 2;
+
+void EncodeInodeValue(const InodeAttr& attr, std::string* dst);
+bool DecodeInodeValue(std::string_view value, InodeAttr* attr);
+
+void EncodeDentryValue(const Dentry& dentry, std::string* dst);
+// 不设置 name, 由调用方从 key 中取
+bool DecodeDentryValue(std::string_view value, Dentry* dentry);
+
+void EncodeSliceRecord(const SliceInfo& slice, InodeID inode, uint64_t base, std::string* dst);
+bool DecodeSliceRecord(codec::Reader* reader, InodeID inode, uint64_t base, SliceInfo* slice);
+
+// 长度须与 count 个 slice 恰好吻合, 否则返回 false
+bool DecodeLayoutValueV1(std::string_view value, FileLayout* layout);
+
+} // namespace nebulastore::metadata
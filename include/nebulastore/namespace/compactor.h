@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "nebulastore/common/async.h"
+#include "nebulastore/common/types.h"
+#include "nebulastore/metadata/metadata_service.h"
+#include "nebulastore/namespace/read_planner.h"
+#include "nebulastore/storage/backend.h"
+
+namespace nebulastore::namespace_ {
+
+// ================================
+// slice 压缩: 把碎片化的文件重写为按 chunk 连续的对象
+// ================================
+//
+// 覆盖写与随机写会让 FileLayout::slices 越来越长, 其中大量字节已被后写的 slice
+// 遮蔽, 每次读都要重新解析. 压缩器在后台挑选候选文件:
+// - 判定: 被遮蔽字节占比达到 min_garbage_ratio, 或 slice 数达到 min_slices
+//   且至少是非空 chunk 数的两倍 (顺序写出的大文件不值得重写)
+// - 读取: 经 ReadPlanner (内部用 SliceTree 求可见区间) 读出每个 chunk 内
+//   首个到末个可见字节, 中间空洞补零; 整个 chunk 为空洞则跳过
+// - 切换: 新对象全部写入后用 MetadataService::ReplaceSlices 原子替换读到的那段
+//   slice, 期间追加的 slice 保留在其后; 布局被改写 (kAgain) 时删除新对象并重新排队
+// - 回收: 旧对象延迟 delete_delay_ms 后删除, 打开时缓存了旧布局的读流仍可读完
+// 热文件优先: 每次访问累加热度, 热度按 hot_half_life_ms 指数衰减.
+// 重写按 max_bytes_per_sec 限速, 避免挤占前台带宽. 需要等待时协程挂起,
+// 由后台线程到期后恢复, 不在 IO 线程上睡眠; 因此限速只在后台线程运行时生效.
+
+class SliceCompactor {
+public:
+    struct Options {
+        uint32_t min_slices = 32;
+        double min_garbage_ratio = 0.5;
+        uint64_t max_bytes_per_sec = 32ULL << 20;   // 重写限速, 0 不限
+        uint32_t max_parallel_reads = 8;
+        uint64_t delete_delay_ms = 60 * 1000;       // 旧对象的保留时间
+        uint64_t hot_half_life_ms = 5 * 60 * 1000;  // 热度半衰期
+        size_t max_candidates = 4096;               // 超出时丢弃最冷的候选
+        uint64_t poll_interval_ms = 1000;           // 后台线程空闲时的等待
+    };
+
+    struct Stats {
+        uint64_t files_compacted = 0;
+        uint64_t slices_reclaimed = 0;      // 压缩前后 slice 数之差
+        uint64_t bytes_reclaimed = 0;       // 旧对象总量减去重写量
+        uint64_t bytes_rewritten = 0;
+        uint64_t conflicts = 0;             // 切换时布局已被改写
+        uint64_t failures = 0;
+        uint64_t objects_deleted = 0;
+        uint64_t pending_deletes = 0;       // 等待到期删除的旧对象
+    };
+
+    SliceCompactor(std::shared_ptr<metadata::MetadataService> metadata,
+                   std::shared_ptr<storage::StorageBackend> backend,
+                   Options options);
+    // 停止后台线程; 未到期的旧对象不再删除
+    ~SliceCompactor();
+
+    SliceCompactor(const SliceCompactor&) = delete;
+    SliceCompactor& operator=(const SliceCompactor&) = delete;
+
+    // 登记一次访问 (读/写), 文件进入候选; 是否值得压缩在执行时按布局判定
+    void Touch(InodeID inode, double weight = 1.0);
+
+    bool NeedsCompaction(const FileLayout& layout) const;
+
+    // 压缩当前最热的候选; *inode 返回处理的文件, 没有候选时为 0
+    AsyncTask<Status> RunOnce(InodeID* inode = nullptr);
+
+    // 压缩指定文件, 未达阈值时直接返回 OK
+    AsyncTask<Status> CompactInode(InodeID inode);
+
+    // 删除到期的旧对象; force 时忽略保留时间
+    AsyncTask<Status> PurgeDeleted(bool force = false);
+
+    // 后台线程: 循环 RunOnce + PurgeDeleted, 无候选时等待 poll_interval_ms;
+    // 同时负责恢复因限速挂起的压缩协程
+    void Start();
+    void Stop();
+
+    Stats stats() const;
+    size_t candidates() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Candidate {
+        double heat = 0;
+        Clock::time_point stamp;
+    };
+
+    struct PendingDelete {
+        Clock::time_point due;
+        std::string key;
+    };
+
+    // 因限速挂起的协程, 到期后由后台线程恢复
+    struct Parked {
+        Clock::time_point due;
+        std::coroutine_handle<> handle;
+    };
+
+    // co_await 返回 false 表示已停止
+    struct PaceAwaiter {
+        SliceCompactor* self;
+        Clock::time_point due;
+
+        bool await_ready() const { return due <= Clock::now(); }
+        bool await_suspend(std::coroutine_handle<> handle);
+        bool await_resume() const;
+    };
+
+    // 衰减到 now 的热度
+    double HeatAt(const Candidate& c, Clock::time_point now) const;
+    // 按限速预留写出 bytes 的额度, 返回的 awaiter 等到额度可用
+    PaceAwaiter Throttle(uint64_t bytes);
+    // 删除压缩中途已写出的新对象
+    AsyncTask<void> DropObjects(std::vector<SliceInfo> slices);
+    // 后台线程的一轮 RunOnce, 完成时唤醒 Loop
+    AsyncTask<Status> RunStep(InodeID* inode);
+    // 在后台线程上恢复到期 (或已停止时全部) 的挂起协程, 直到本轮完成
+    void ServeParked();
+    void Loop();
+
+    std::shared_ptr<metadata::MetadataService> metadata_;
+    std::shared_ptr<storage::StorageBackend> backend_;
+    Options options_;
+    ReadPlanner planner_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<InodeID, Candidate> candidates_;
+    std::deque<PendingDelete> pending_;         // 按到期时间升序
+    Stats stats_;
+    Clock::time_point pace_{};                  // 限速: 下一字节最早可写出的时间
+    std::vector<Parked> parked_;
+    bool running_ = false;                      // 后台线程在运行, 可以挂起等待
+    bool step_done_ = false;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+} // namespace nebulastore::namespace_
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "nebulastore/common/async.h"
+#include "nebulastore/common/types.h"
+#include "nebulastore/storage/backend.h"
+
+namespace nebulastore::namespace_ {
+
+// ================================
+// 读计划: 文件区间 -> 存储对象区间
+// ================================
+//
+// 按布局顺序把 slice 插入 SliceTree (后写覆盖先写), 求出 [offset, offset+size)
+// 内每段可见数据来自哪个对象的哪一段; 同一对象内首尾相接的段合并为一次读,
+// 过长的段再按 max_extent 切开以便并发. 未被任何 slice 覆盖的部分是空洞 (读为 0).
+
+struct ReadExtent {
+    std::string storage_key;
+    uint64_t object_offset;   // 对象内偏移
+    uint64_t length;
+    uint64_t buffer_offset;   // 相对读起点的偏移
+};
+
+struct ReadPlan {
+    uint64_t offset = 0;      // 读起点
+    uint64_t length = 0;      // 截断到文件末尾后的长度, 越过 EOF 为 0
+    std::vector<ReadExtent> extents;   // 按 buffer_offset 升序, 互不重叠
+};
+
+class ReadPlanner {
+public:
+    static constexpr uint64_t kDefaultMaxExtent = 8ULL << 20;
+
+    explicit ReadPlanner(storage::StorageBackend* backend, uint32_t max_parallel = 16)
+        : backend_(backend), max_parallel_(max_parallel ? max_parallel : 1) {}
+
+    // 文件末尾取所有 slice 的最大结束位置
+    static ReadPlan Plan(const FileLayout& layout, uint64_t offset, uint64_t size,
+                         uint64_t max_extent = kDefaultMaxExtent);
+
+    // 并发执行计划, 结果写入 dst[0, plan.length): 空洞与对象短读补零.
+    // 同时在途的后端读不超过 max_parallel. 异步后端逐段直接读入 dst;
+    // 同步后端 (AsyncReads() 为 false) 每 max_parallel 段一次 BatchRead, 由后端并发
+    AsyncTask<Status> Execute(const ReadPlan& plan, uint8_t* dst);
+
+    // 后端读能否真正在后台进行 (决定是否值得预读)
+    bool AsyncReads() const { return backend_->AsyncReads(); }
+
+private:
+    AsyncTask<Status> ReadExtentInto(const ReadExtent& extent, uint8_t* dst);
+    AsyncTask<Status> ExecuteBatched(const ReadPlan& plan, uint8_t* dst);
+
+    storage::StorageBackend* backend_;
+    uint32_t max_parallel_;
+};
+
+} // namespace nebulastore::namespace_
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include "nebulastore/common/async.h"
+#include "nebulastore/common/types.h"
+#include "nebulastore/namespace/read_planner.h"
+
+namespace nebulastore::namespace_ {
+
+// ================================
+// 顺序读预读
+// ================================
+//
+// 每个打开的文件一个 ReadStream: 打开时缓存布局 (close-to-open), 之后的读
+// 不再走 LookupPath/GetLayout. 连续命中顺序读时窗口翻倍直到 max_window,
+// 当前读完成后按 block_size 发起后续区间的读, IO 在后台进行;
+// 随机读时丢弃预读数据并把窗口重置为 initial_window.
+// 后端读是同步的 (AsyncReads() 为 false, 如 S3) 时不预读: 预读会在
+// 发起时就地读完, 既拖慢当前读也绕过 max_inflight_bytes.
+// 预读块占用的内存从所有流共享的 ReadaheadBudget 中预留, 用完即归还.
+
+struct ReadaheadOptions {
+    uint64_t initial_window = 512ULL << 10;
+    uint64_t max_window = 8ULL << 20;
+    uint64_t block_size = 1ULL << 20;          // 预取粒度
+    uint64_t max_inflight_bytes = 4ULL << 20;  // 单个流尚未完成的预取
+    uint64_t memory_budget = 256ULL << 20;     // 所有流的预读缓冲总量
+};
+
+class ReadaheadBudget {
+public:
+    explicit ReadaheadBudget(uint64_t limit) : limit_(limit) {}
+
+    bool TryReserve(uint64_t bytes) {
+        uint64_t used = used_.load(std::memory_order_relaxed);
+        do {
+            if (used + bytes > limit_) return false;
+        } while (!used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+        return true;
+    }
+
+    void Release(uint64_t bytes) { used_.fetch_sub(bytes, std::memory_order_relaxed); }
+
+    uint64_t used() const { return used_.load(std::memory_order_relaxed); }
+    uint64_t limit() const { return limit_; }
+
+private:
+    const uint64_t limit_;
+    std::atomic<uint64_t> used_{0};
+};
+
+class ReadStream {
+public:
+    struct Stats {
+        uint64_t hit_bytes = 0;         // 由预读块提供
+        uint64_t miss_bytes = 0;        // 同步读取
+        uint64_t prefetched_bytes = 0;  // 发起的预读总量
+    };
+
+    // planner 与 budget 须比流活得久
+    ReadStream(FileLayout layout, ReadPlanner* planner,
+               std::shared_ptr<ReadaheadBudget> budget, ReadaheadOptions options);
+    // 不阻塞: 未 Close 时剩余预读块交给后台协程等完再释放
+    ~ReadStream();
+
+    ReadStream(const ReadStream&) = delete;
+    ReadStream& operator=(const ReadStream&) = delete;
+
+    // 语义同 NamespaceService::Read. 同一流上的读须串行
+    AsyncTask<Status> Read(uint64_t offset, uint64_t size, ByteBuffer* data);
+
+    // 同 Read, 但直接读入 dst (至少 size 字节, 如 FUSE 的内核缓冲), 实际字节数写入 *got
+    AsyncTask<Status> ReadInto(uint64_t offset, uint64_t size, uint8_t* dst, uint64_t* got);
+
+    // 等待在途预读并归还缓冲; 释放流之前调用
+    AsyncTask<void> Close();
+
+    InodeID inode() const { return layout_.inode_id; }
+    uint64_t file_size() const { return file_end_; }
+    uint64_t window() const { return window_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Block {
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        ByteBuffer data;
+        std::atomic<bool> done{false};
+        std::optional<AsyncTask<Status>> task;   // 等待后置空
+        Status status = Status::Ok();
+
+        uint64_t End() const { return offset + length; }
+    };
+
+    // dst 为空时读入新缓冲并写入 *data (单块覆盖时为块的视图), 否则读入 dst
+    AsyncTask<Status> ReadImpl(uint64_t offset, uint64_t size, uint8_t* dst, ByteBuffer* data,
+                               uint64_t* got);
+    AsyncTask<Status> Fetch(Block* block, ReadPlan plan);
+    AsyncTask<Status> Wait(Block* block);
+    AsyncTask<Status> ReadDirect(uint64_t offset, uint64_t length, uint8_t* dst);
+    // 丢弃结束位置不超过 pos 的块 (pos = UINT64_MAX 时全部丢弃)
+    AsyncTask<void> DropBefore(uint64_t pos);
+    void Prefetch(uint64_t from);
+    uint64_t InflightBytes() const;
+
+    FileLayout layout_;
+    ReadPlanner* planner_;
+    std::shared_ptr<ReadaheadBudget> budget_;
+    ReadaheadOptions options_;
+
+    uint64_t file_end_ = 0;
+    uint64_t next_offset_ = 0;      // 顺序读预期的下一个偏移
+    uint32_t seq_run_ = 0;          // 连续顺序读次数
+    uint64_t window_ = 0;
+    uint64_t ra_end_ = 0;           // 已发起预读的结束位置
+    std::deque<std::unique_ptr<Block>> blocks_;   // 按偏移升序, 首尾相接
+    Stats stats_;
+};
+
+} // namespace nebulastore::namespace_
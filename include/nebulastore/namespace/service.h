@@ -6,6 +6,10 @@
 #include "nebulastore/common/types.h"
 #include "nebulastore/common/async.h"
 #include "nebulastore/metadata/metadata_service.h"
+#include "nebulastore/namespace/compactor.h"
+#include "nebulastore/namespace/read_planner.h"
+#include "nebulastore/namespace/readahead.h"
+#include "nebulastore/namespace/slice_writer.h"
 #include "nebulastore/storage/backend.h"
 
 namespace nebulastore::namespace_ {
@@ -49,6 +53,10 @@ public:
         std::shared_ptr<metadata::MetadataService> metadata_service;
         std::shared_ptr<storage::StorageBackend> storage_backend;
         std::string default_bucket = "default";
+        uint32_t max_parallel_reads = 16;   // 单次 Read 同时在途的后端读
+        uint32_t max_inflight_uploads = 4;  // 每个写入器同时在途的 chunk 上传
+        ReadaheadOptions readahead;         // OpenReader 打开的流使用
+        std::shared_ptr<SliceCompactor> compactor;   // 可选: 读写时登记访问, 热文件优先压缩
     };
 
     explicit NamespaceService(Config config);
@@ -68,7 +76,7 @@ public:
         FileLayout* layout
     );
 
-    // 读取文件
+    // 读取文件: 跨多个 slice 时并发读取, 空洞读为 0, 越过文件末尾时短读
     AsyncTask<Status> Read(
         const std::string& path,
         uint64_t offset,
@@ -76,13 +84,25 @@ public:
         ByteBuffer* data
     );
 
-    // 写入文件
+    // 一次性写入: 临时写入器写完立即 Flush
     AsyncTask<Status> Write(
         const std::string& path,
         const ByteBuffer& data,
         uint64_t offset
     );
 
+    // 为打开的文件创建带预读的读流, 布局在打开时缓存
+    AsyncTask<Status> OpenReader(
+        const std::string& path,
+        std::shared_ptr<ReadStream>* reader
+    );
+
+    // 为打开的文件创建写回写入器, 数据在 Flush 后可见
+    AsyncTask<Status> OpenWriter(
+        const std::string& path,
+        std::shared_ptr<SliceWriter>* writer
+    );
+
     // 列出目录
     AsyncTask<Status> Readdir(
         const std::string& path,
@@ -93,6 +113,11 @@ private:
     PathConverter converter_;
     std::shared_ptr<metadata::MetadataService> metadata_service_;
     std::shared_ptr<storage::StorageBackend> storage_backend_;
+    ReadPlanner planner_;
+    uint32_t max_inflight_uploads_;
+    ReadaheadOptions readahead_options_;
+    std::shared_ptr<ReadaheadBudget> readahead_budget_;   // 所有读流共享
+    std::shared_ptr<SliceCompactor> compactor_;
 };
 
 } // namespace nebulastore::namespace_
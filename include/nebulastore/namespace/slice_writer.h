@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include "nebulastore/common/async.h"
+#include "nebulastore/common/types.h"
+#include "nebulastore/metadata/metadata_service.h"
+#include "nebulastore/storage/backend.h"
+
+namespace nebulastore::namespace_ {
+
+// 进程内唯一的 slice ID, 写入器与压缩共用
+uint64_t NextSliceId();
+
+// ================================
+// 写回缓冲: 按 chunk 聚合写入的 slice 写入器 (JuiceFS 模型)
+// ================================
+//
+// 每个打开的文件一个写入器. 写入按 chunk (FileLayout::chunk_size) 切分,
+// 每个 chunk 维护一个正在构造的 slice, 连续写追加到其中:
+// - slice 写满 chunk 即封口, 后台异步上传为一个对象 (同时在途上传数有上限)
+// - 同一 chunk 内不连续的写先封口旧 slice 再开新 slice
+// - Flush 封口全部 slice, 等上传完成后一次性提交整批 slice 元数据
+// 未 Flush 的数据对其他读者不可见 (close-to-open 一致性).
+// 同一写入器上的 Write/Flush 须由调用方串行.
+
+class SliceWriter {
+public:
+    struct Options {
+        uint64_t chunk_size = 4ULL << 20;
+        uint32_t max_inflight_uploads = 4;   // 同时在途的对象上传
+        uint32_t max_open_slices = 16;       // 超出时封口最早打开的 slice
+    };
+
+    SliceWriter(InodeID inode,
+                std::shared_ptr<metadata::MetadataService> metadata,
+                std::shared_ptr<storage::StorageBackend> backend,
+                Options options);
+    // 不阻塞 (可能在 IO 线程上析构): 仍在途的上传交给后台收尾并告警.
+    // 出错或放弃写入时应先 co_await Abort()
+    ~SliceWriter();
+
+    SliceWriter(const SliceWriter&) = delete;
+    SliceWriter& operator=(const SliceWriter&) = delete;
+
+    // 写入缓冲 (拷贝 data). 上传失败的错误在此或 Flush 时返回, 之后一直保持
+    AsyncTask<Status> Write(uint64_t offset, const ByteBuffer& data);
+
+    // 封口并上传全部缓冲数据, 然后一次提交所有 slice 与文件大小
+    AsyncTask<Status> Flush();
+
+    // 丢弃未提交的数据, 等待在途上传结束; 之后可安全释放写入器
+    AsyncTask<void> Abort();
+
+    InodeID inode() const { return inode_; }
+    uint64_t buffered_bytes() const { return buffered_bytes_; }
+    size_t pending_slices() const { return sealed_.size(); }
+
+private:
+    struct OpenSlice {
+        uint64_t offset = 0;      // 文件内起点
+        uint64_t length = 0;
+        ByteBuffer buffer;        // 容量到 chunk 末尾
+        uint64_t seq = 0;         // 打开顺序
+    };
+
+    // 封口 chunk 上的 slice 并启动上传
+    AsyncTask<Status> Seal(uint64_t chunk_index);
+    // 不引用写入器, 写入器释放后仍可安全完成
+    static AsyncTask<Status> Upload(std::shared_ptr<storage::StorageBackend> backend,
+                                    std::string key, ByteBuffer data);
+    // 等待最早的上传
+    AsyncTask<Status> WaitOldest();
+
+    InodeID inode_;
+    std::shared_ptr<metadata::MetadataService> metadata_;
+    std::shared_ptr<storage::StorageBackend> backend_;
+    Options options_;
+
+    std::map<uint64_t, OpenSlice> open_;          // chunk 下标 -> 构造中的 slice
+    std::vector<SliceInfo> sealed_;               // 已封口待提交, 按封口顺序
+    std::deque<AsyncTask<Status>> uploads_;       // 在途上传, 按启动顺序
+    uint64_t next_seq_ = 0;
+    uint64_t buffered_bytes_ = 0;
+    uint64_t max_end_ = 0;                        // 待提交数据的最大结束位置
+    Status error_ = Status::Ok();
+};
+
+} // namespace nebulastore::namespace_
@@ -3,6 +3,8 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include "nebulastore/common/types.h"
 #include "nebulastore/common/async.h"
 #include "nebulastore/metadata/metadata_service.h"
@@ -122,7 +124,7 @@ public:
     struct Config {
         std::shared_ptr<namespace_::NamespaceService> namespace_service;
         std::string mount_point;
-        uint32_t max_readahead = 131072;  // 128KB
+        uint32_t max_readahead = 131072;  // 128KB, 内核预读; 用户态预读见 NamespaceService::Config
         bool allow_other = false;
     };
 
@@ -193,9 +195,40 @@ public:
         std::vector<Dentry>* entries
     );
 
+    // === 打开文件句柄 (写回缓冲) ===
+    // fuse_loop 单线程分发, 同一句柄上的操作天然串行
+
+    // 打开文件并分配句柄
+    AsyncTask<Status> Open(const std::string& path, uint64_t* fh);
+
+    // 经句柄的预读流直接读入 dst (内核缓冲), 实际字节数写入 *got; 首次读取时创建读流.
+    // 本句柄有缓冲的写时先提交
+    AsyncTask<Status> Read(uint64_t fh, uint64_t offset, uint64_t size, uint8_t* dst, uint64_t* got);
+
+    // 写入句柄的写回缓冲, 首次写入时创建写入器
+    AsyncTask<Status> Write(uint64_t fh, const ByteBuffer& data, uint64_t offset);
+
+    // flush/fsync: 上传并提交已缓冲的写
+    AsyncTask<Status> Flush(uint64_t fh);
+
+    // close: 提交后释放句柄
+    AsyncTask<Status> Release(uint64_t fh);
+
 private:
     Config config_;
 
+    struct OpenFile {
+        std::string path;
+        std::shared_ptr<namespace_::SliceWriter> writer;   // 首次写入时创建
+        std::shared_ptr<namespace_::ReadStream> reader;    // 首次读取时创建, 提交写后重建
+    };
+
+    std::shared_ptr<OpenFile> FindHandle(uint64_t fh);
+
+    std::mutex handles_mutex_;
+    std::unordered_map<uint64_t, std::shared_ptr<OpenFile>> handles_;
+    uint64_t next_fh_ = 1;
+
     // 查找文件对应的 slice
     Status FindSlice(
         const FileLayout& layout,
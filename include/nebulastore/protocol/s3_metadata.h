@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include "nebulastore/common/codec.h"
 
 namespace nebulastore {
 namespace s3 {
@@ -40,8 +41,13 @@ struct ObjectMeta {
     std::string data_path;
     std::map<std::string, std::string> user_metadata;
 
+    // v2: 0x02 | flags | bucket | key | 非默认字段 (varint / 长度前缀, 时间相对 kTimeBase)
+    // 仍可读取 v1 (定长 U32/U64) 格式
     std::string Encode() const;
     bool Decode(const std::string& data);
+
+private:
+    bool DecodeV1(const std::string& data);
 };
 
 // ================================
@@ -202,29 +208,99 @@ inline bool BucketMeta::Decode(const std::string& data) {
 // ================================
 // ObjectMeta 序列化实现
 // ================================
+namespace encoding {
+    // ObjectMeta v2 可选字段
+    constexpr uint64_t kObjSize = 1 << 0;
+    constexpr uint64_t kObjEtag = 1 << 1;
+    constexpr uint64_t kObjContentType = 1 << 2;
+    constexpr uint64_t kObjLastModified = 1 << 3;
+    constexpr uint64_t kObjStorageClass = 1 << 4;
+    constexpr uint64_t kObjDataPath = 1 << 5;
+    constexpr uint64_t kObjUserMeta = 1 << 6;
+    constexpr uint64_t kObjKnown = (1 << 7) - 1;
+    constexpr uint8_t kObjMetaV2 = 2;
+
+    inline bool GetString(codec::Reader& reader, std::string& s) {
+        std::string_view v;
+        if (!reader.GetLengthPrefixed(&v)) return false;
+        s.assign(v.data(), v.size());
+        return true;
+    }
+}
+
 inline std::string ObjectMeta::Encode() const {
+    using namespace encoding;
+    uint64_t flags = 0;
+    if (size != 0) flags |= kObjSize;
+    if (!etag.empty()) flags |= kObjEtag;
+    if (!content_type.empty()) flags |= kObjContentType;
+    if (last_modified != 0) flags |= kObjLastModified;
+    if (!storage_class.empty()) flags |= kObjStorageClass;
+    if (!data_path.empty()) flags |= kObjDataPath;
+    if (!user_metadata.empty()) flags |= kObjUserMeta;
+
     std::string buf;
-    encoding::PutU32(buf, 1);  // version
-    encoding::PutString(buf, bucket);
-    encoding::PutString(buf, key);
-    encoding::PutU64(buf, size);
-    encoding::PutString(buf, etag);
-    encoding::PutString(buf, content_type);
-    encoding::PutU64(buf, last_modified);
-    encoding::PutString(buf, storage_class);
-    encoding::PutString(buf, data_path);
-    encoding::PutU32(buf, user_metadata.size());
-    for (const auto& [k, v] : user_metadata) {
-        encoding::PutString(buf, k);
-        encoding::PutString(buf, v);
+    buf.push_back(static_cast<char>(kObjMetaV2));
+    codec::PutVarint64(&buf, flags);
+    codec::PutLengthPrefixed(&buf, bucket);
+    codec::PutLengthPrefixed(&buf, key);
+    if (flags & kObjSize) codec::PutVarint64(&buf, size);
+    if (flags & kObjEtag) codec::PutLengthPrefixed(&buf, etag);
+    if (flags & kObjContentType) codec::PutLengthPrefixed(&buf, content_type);
+    if (flags & kObjLastModified) codec::PutDelta(&buf, codec::kTimeBase, last_modified);
+    if (flags & kObjStorageClass) codec::PutLengthPrefixed(&buf, storage_class);
+    if (flags & kObjDataPath) codec::PutLengthPrefixed(&buf, data_path);
+    if (flags & kObjUserMeta) {
+        codec::PutVarint64(&buf, user_metadata.size());
+        for (const auto& [k, v] : user_metadata) {
+            codec::PutLengthPrefixed(&buf, k);
+            codec::PutLengthPrefixed(&buf, v);
+        }
     }
     return buf;
 }
 
 inline bool ObjectMeta::Decode(const std::string& data) {
+    using namespace encoding;
+    // v1 以小端 U32 版本号 1 开头, 首字节为 0x01
+    if (!data.empty() && data[0] == 1) return DecodeV1(data);
+
+    codec::Reader reader(data);
+    uint8_t ver;
+    uint64_t flags;
+    if (!reader.GetByte(&ver) || ver != kObjMetaV2 ||
+        !reader.GetVarint64(&flags) || (flags & ~kObjKnown) != 0 ||
+        !GetString(reader, bucket) || !GetString(reader, key)) return false;
+
+    size = 0;
+    etag.clear();
+    content_type.clear();
+    last_modified = 0;
+    storage_class.clear();
+    data_path.clear();
+    user_metadata.clear();
+    if ((flags & kObjSize) && !reader.GetVarint64(&size)) return false;
+    if ((flags & kObjEtag) && !GetString(reader, etag)) return false;
+    if ((flags & kObjContentType) && !GetString(reader, content_type)) return false;
+    if ((flags & kObjLastModified) && !reader.GetDelta(codec::kTimeBase, &last_modified)) return false;
+    if ((flags & kObjStorageClass) && !GetString(reader, storage_class)) return false;
+    if ((flags & kObjDataPath) && !GetString(reader, data_path)) return false;
+    if (flags & kObjUserMeta) {
+        uint64_t count;
+        if (!reader.GetVarint64(&count)) return false;
+        for (uint64_t i = 0; i < count; i++) {
+            std::string k, v;
+            if (!GetString(reader, k) || !GetString(reader, v)) return false;
+            user_metadata[std::move(k)] = std::move(v);
+        }
+    }
+    return reader.empty();
+}
+
+inline bool ObjectMeta::DecodeV1(const std::string& data) {
     size_t pos = 0;
     uint32_t ver;
-    if (!encoding::GetU32(data, pos, ver) || ver > 1) return false;
+    if (!encoding::GetU32(data, pos, ver) || ver != 1) return false;
     if (!encoding::GetString(data, pos, bucket) ||
         !encoding::GetString(data, pos, key) ||
         !encoding::GetU64(data, pos, size) ||
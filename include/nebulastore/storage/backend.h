@@ -1,10 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <unistd.h>
 #include <vector>
 #include <string>
 #include "nebulastore/common/types.h"
 #include "nebulastore/common/async.h"
+#include "nebulastore/storage/buffer_pool.h"
+#include "nebulastore/storage/io_engine.h"
 
 namespace nebulastore::storage {
 
@@ -16,6 +24,11 @@ class StorageBackend {
 public:
     virtual ~StorageBackend() = default;
 
+    // 读是否真正异步: co_await 时挂起, 由 IO 线程完成. 为 false 的后端 (如 S3 的
+    // curl easy 调用) 在协程内同步阻塞, 逐个启动的读实际串行执行; 需要并发时
+    // 改走 BatchRead, 也不宜做后台预取
+    virtual bool AsyncReads() const { return false; }
+
     // === 基础操作 ===
 
     // 写入数据
@@ -50,13 +63,135 @@ public:
         ByteBuffer* data
     ) = 0;
 
+    // 读取范围到调用方内存 (如 usrbio 共享缓冲区), 越过对象末尾时短读.
+    // 默认实现经 GetRange 中转一次拷贝, 本地后端直接读入目标内存
+    virtual AsyncTask<Status> GetRangeInto(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        uint8_t* dst,
+        uint64_t* bytes_read
+    ) {
+        ByteBuffer data;
+        auto status = co_await GetRange(key, offset, size, &data);
+        if (!status.OK()) {
+            co_return status;
+        }
+        uint64_t n = std::min<uint64_t>(data.size(), size);
+        if (n > 0) std::memcpy(dst, data.data(), n);
+        *bytes_read = n;
+        co_return Status::Ok();
+    }
+
+    // === 流式读 ===
+
+    // 数据块回调: 按对象顺序交付, 返回非 OK 时中止读取并以该状态返回
+    using ChunkSink = std::function<Status(const uint8_t* data, size_t size)>;
+
+    // 流式读取 [offset, offset + size) (size == 0 读到对象末尾), 不在内存中缓冲整段数据.
+    // 默认实现读出整段后一次交付
+    virtual AsyncTask<Status> GetStream(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        ChunkSink sink
+    ) {
+        ByteBuffer data;
+        Status status;
+        if (size == 0) {
+            status = co_await Get(key, &data);
+            data = data.Slice(offset, SIZE_MAX);
+        } else {
+            status = co_await GetRange(key, offset, size, &data);
+        }
+        if (!status.OK()) {
+            co_return status;
+        }
+        co_return data.empty() ? Status::Ok() : sink(data.data(), data.size());
+    }
+
+    // 流式读取整个对象写入文件描述符 (从 fd 当前位置写), 返回写入字节数
+    AsyncTask<Status> GetToFd(const std::string& key, int fd, uint64_t* bytes_written) {
+        *bytes_written = 0;
+        co_return co_await GetStream(key, 0, 0, [fd, bytes_written](const uint8_t* data, size_t size) {
+            while (size > 0) {
+                ssize_t n = ::write(fd, data, size);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) return Status::IO(std::string("write failed: ") + strerror(errno));
+                data += n;
+                size -= static_cast<size_t>(n);
+                *bytes_written += static_cast<uint64_t>(n);
+            }
+            return Status::Ok();
+        });
+    }
+
     // === AI 场景优化 ===
 
-    // 批量读取
+    // 批量读的单项: size == 0 读整个对象, 否则读 [offset, offset + size) (越过末尾短读)
+    struct ReadRequest {
+        std::string key;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    struct ReadResult {
+        Status status;
+        ByteBuffer data;
+    };
+
+    // 并发批量读, 每项独立返回状态 (单项失败不影响其他项), 在途请求数不超过
+    // max_concurrency. 默认实现以滑动窗口并发 Get/GetRange
+    virtual AsyncTask<void> BatchRead(
+        const std::vector<ReadRequest>& requests,
+        std::vector<ReadResult>* results,
+        uint32_t max_concurrency = 64
+    ) {
+        results->assign(requests.size(), ReadResult{});
+        size_t limit = std::max<uint32_t>(max_concurrency, 1);
+        std::deque<std::pair<size_t, AsyncTask<Status>>> inflight;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            if (inflight.size() >= limit) {
+                auto [index, task] = std::move(inflight.front());
+                inflight.pop_front();
+                (*results)[index].status = co_await task;
+            }
+            const auto& req = requests[i];
+            auto* out = &(*results)[i].data;
+            inflight.emplace_back(i, req.size == 0 ? Get(req.key, out)
+                                                   : GetRange(req.key, req.offset, req.size, out));
+        }
+        while (!inflight.empty()) {
+            auto [index, task] = std::move(inflight.front());
+            inflight.pop_front();
+            (*results)[index].status = co_await task;
+        }
+    }
+
+    // 批量读取整个对象, 返回第一个失败项的状态. 默认经 BatchRead 并发读取
     virtual AsyncTask<Status> BatchGet(
         const std::vector<std::string>& keys,
         std::vector<ByteBuffer>* data
-    ) = 0;
+    ) {
+        std::vector<ReadRequest> requests;
+        requests.reserve(keys.size());
+        for (const auto& key : keys) {
+            requests.push_back(ReadRequest{key, 0, 0});
+        }
+        std::vector<ReadResult> results;
+        co_await BatchRead(requests, &results);
+
+        data->clear();
+        data->reserve(results.size());
+        Status first_error;
+        for (auto& result : results) {
+            if (!result.status.OK() && first_error.OK()) {
+                first_error = result.status;
+            }
+            data->push_back(std::move(result.data));
+        }
+        co_return first_error;
+    }
 
     // === 健康检查和容量 ===
 
@@ -81,13 +216,35 @@ public:
         std::string access_key;
         std::string secret_key;
         std::string region;
-        std::string endpoint;    // 可选，用于兼容 S3 的存储
+        std::string endpoint;    // 可选，用于兼容 S3 的存储 (可带 http:// 前缀)
         std::string bucket;
-        uint32_t max_connections = 100;
+        uint32_t max_connections = 100;   // curl 句柄池上限, 连接在句柄间共享复用
+        bool http2 = true;                // TLS 连接上协商 HTTP/2
+        uint64_t multipart_threshold = 64ULL << 20;  // 不小于此大小的对象分片上传, 0 关闭
+        uint64_t part_size = 16ULL << 20;            // 分片大小 (不小于 5MB)
+        uint32_t upload_concurrency = 8;             // 单个对象并发上传的分片数
+        uint32_t max_part_retries = 3;               // 单个分片失败后的重试次数
+        uint32_t max_retries = 3;                    // 可重试错误 (连接失败、超时、429、5xx) 的重试次数
+        uint32_t retry_base_delay_ms = 50;           // 第 n 次重试在 [0, base * 2^n] 内随机退避
+        uint32_t retry_max_delay_ms = 2000;          // 单次退避上限
+        bool hedge_reads = true;                     // GET 首字节迟于端点 p95 时发对冲请求
+        uint32_t hedge_budget_percent = 5;           // 对冲请求数上限, 占 GET 数的百分比
+        uint32_t hedge_min_delay_ms = 10;            // 对冲前至少等待的时间
+    };
+
+    // 请求统计; 首字节延迟为本端点近期 GET 的分位数
+    struct Stats {
+        uint64_t requests = 0;      // 逻辑请求数 (不含重试与对冲副本)
+        uint64_t retries = 0;
+        uint64_t hedges = 0;        // 发出的对冲请求
+        uint64_t hedge_wins = 0;    // 对冲请求先于主请求完成
+        uint64_t ttfb_p50_us = 0;
+        uint64_t ttfb_p95_us = 0;
+        uint64_t ttfb_p99_us = 0;
     };
 
     explicit S3Backend(Config config);
-    ~S3Backend() override = default;
+    ~S3Backend() override;
 
     // === 实现 StorageBackend 接口 ===
 
@@ -116,14 +273,34 @@ public:
         ByteBuffer* data
     ) override;
 
-    AsyncTask<Status> BatchGet(
-        const std::vector<std::string>& keys,
-        std::vector<ByteBuffer>* data
+    // 响应体直接写入目标内存, 不经中间缓冲
+    AsyncTask<Status> GetRangeInto(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        uint8_t* dst,
+        uint64_t* bytes_read
+    ) override;
+
+    AsyncTask<Status> GetStream(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        ChunkSink sink
+    ) override;
+
+    // curl multi 并发 GET, 同一对象相邻的范围合并为一次请求
+    AsyncTask<void> BatchRead(
+        const std::vector<ReadRequest>& requests,
+        std::vector<ReadResult>* results,
+        uint32_t max_concurrency = 64
     ) override;
 
     AsyncTask<Status> HealthCheck() override;
     AsyncTask<Status> GetCapacity(CapacityInfo* info) override;
 
+    Stats stats() const;
+
 private:
     Config config_;
 
@@ -139,11 +316,18 @@ private:
 class LocalBackend : public StorageBackend {
 public:
     struct Config {
-        std::string data_dir;  // 数据根目录
+        std::string data_dir;             // 数据根目录
+        IoEngine::Config io;              // io_uring / 线程池配置
+        uint32_t max_open_files = 1024;   // 读句柄缓存上限
+        BufferPool* buffer_pool = nullptr; // 可选: 注册为固定缓冲区, 落在池内的读写走 *_FIXED
+        uint64_t stream_chunk_size = 1ULL << 20;  // GetStream 每次读取并交付的块大小
     };
 
     explicit LocalBackend(Config config);
-    ~LocalBackend() override = default;
+    ~LocalBackend() override;
+
+    // 读经 IoEngine 提交, 在引擎线程上完成
+    bool AsyncReads() const override { return true; }
 
     // === 实现 StorageBackend 接口 ===
 
@@ -172,9 +356,27 @@ public:
         ByteBuffer* data
     ) override;
 
-    AsyncTask<Status> BatchGet(
-        const std::vector<std::string>& keys,
-        std::vector<ByteBuffer>* data
+    AsyncTask<Status> GetRangeInto(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        uint8_t* dst,
+        uint64_t* bytes_read
+    ) override;
+
+    // 按 stream_chunk_size 分块读出交付, 内存占用与对象大小无关
+    AsyncTask<Status> GetStream(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        ChunkSink sink
+    ) override;
+
+    // 每轮打开一批文件, 首次读通过一次 SubmitBatch 提交 (io_uring 下一次 io_uring_enter)
+    AsyncTask<void> BatchRead(
+        const std::vector<ReadRequest>& requests,
+        std::vector<ReadResult>* results,
+        uint32_t max_concurrency = 64
     ) override;
 
     AsyncTask<Status> HealthCheck() override;
@@ -182,9 +384,22 @@ public:
 
 private:
     Config config_;
+    std::unique_ptr<IoEngine> io_engine_;
+
+    // 读句柄缓存 (避免每次 Get/GetRange 都 open/close)
+    struct OpenFile;
+    class FileCache;
+    std::unique_ptr<FileCache> file_cache_;
 
     // key 转换为文件路径
     std::string KeyToPath(const std::string& key);
+
+    // 读缓冲区: 优先取自缓冲池 (可走固定缓冲区), 池满时普通分配; 均不清零
+    ByteBuffer AllocateBuffer(size_t size);
+
+    // 循环读满 len 字节 (遇到 EOF 提前返回), 返回读取字节数或 -errno
+    AsyncTask<int64_t> ReadFull(const OpenFile& file, uint8_t* buf,
+                                uint64_t len, uint64_t offset);
 };
 
 } // namespace nebulastore::storage
@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <vector>
 #include "nebulastore/storage/backend.h"
+#include "nebulastore/storage/caching_backend.h"
+#include "nebulastore/storage/memory_cache.h"
 
 namespace nebulastore::storage {
 
@@ -18,8 +20,34 @@ struct Config {
     std::string secret_key;
     std::string region;
     std::string bucket;
+    std::string cache_dir;      // 非空时远端后端外包一层本地盘块缓存 (data_cache)
+    uint64_t cache_size_mb = 1024;
+    uint64_t memory_cache_mb = 0;   // 非 0 时最外层加一层进程内热块缓存
 };
 
+// 按配置为远端后端加上本地盘块缓存
+inline std::unique_ptr<StorageBackend> WithDataCache(std::unique_ptr<StorageBackend> remote,
+                                                     const Config& cfg) {
+    if (cfg.cache_dir.empty()) {
+        return remote;
+    }
+    CachingBackend::Config cache_cfg;
+    cache_cfg.cache_dir = cfg.cache_dir;
+    cache_cfg.capacity_bytes = cfg.cache_size_mb << 20;
+    return std::make_unique<CachingBackend>(std::move(cache_cfg), std::move(remote));
+}
+
+// 按配置加上进程内热块缓存 (位于本地盘缓存之外)
+inline std::unique_ptr<StorageBackend> WithMemoryCache(std::unique_ptr<StorageBackend> inner,
+                                                       const Config& cfg) {
+    if (cfg.memory_cache_mb == 0) {
+        return inner;
+    }
+    MemoryCacheBackend::Config mem_cfg;
+    mem_cfg.cache.capacity_bytes = cfg.memory_cache_mb << 20;
+    return std::make_unique<MemoryCacheBackend>(mem_cfg, std::move(inner));
+}
+
 // 后端创建器类型
 using BackendCreator = std::function<std::unique_ptr<StorageBackend>(const Config&)>;
 
@@ -77,7 +105,7 @@ inline void RegisterBuiltinBackends() {
     // local 后端
     BackendFactory::Instance().Register("local", [](const Config& cfg) {
         LocalBackend::Config local_cfg{cfg.data_dir};
-        return std::make_unique<LocalBackend>(local_cfg);
+        return WithMemoryCache(std::make_unique<LocalBackend>(local_cfg), cfg);
     });
 
     // s3 后端
@@ -86,7 +114,7 @@ inline void RegisterBuiltinBackends() {
             cfg.access_key, cfg.secret_key, cfg.region,
             cfg.endpoint, cfg.bucket
         };
-        return std::make_unique<S3Backend>(s3_cfg);
+        return WithMemoryCache(WithDataCache(std::make_unique<S3Backend>(s3_cfg), cfg), cfg);
     });
 
     // minio 后端 (使用 S3 兼容接口)
@@ -95,7 +123,7 @@ inline void RegisterBuiltinBackends() {
             cfg.access_key, cfg.secret_key, cfg.region,
             cfg.endpoint, cfg.bucket
         };
-        return std::make_unique<S3Backend>(minio_cfg);
+        return WithMemoryCache(WithDataCache(std::make_unique<S3Backend>(minio_cfg), cfg), cfg);
     });
 }
 
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "nebulastore/common/result.h"
+#include "nebulastore/storage/io_engine.h"
+
+namespace nebulastore::storage {
+
+// ================================
+// 注册缓冲池 (大页 + memfd)
+// ================================
+//
+// 进程级的一整块 memfd 内存, 切成定长块按需分配 (多块连续分配).
+// - 优先 2MB 大页 (MFD_HUGETLB), 不可用时退回普通页 + 透明大页提示
+// - 可整体注册为 io_uring 固定缓冲区, 读写走 READ_FIXED/WRITE_FIXED
+// - memfd 可经 SCM_RIGHTS 交给 usrbio 服务端, 池内偏移即 buf_off
+// 分配得到的 PooledBuffer 带引用计数, 可切片共享; 最后一个引用释放时块归还.
+// 块内存不清零.
+
+class BufferPool;
+
+class PooledBuffer {
+public:
+    PooledBuffer() = default;
+
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // 子区间视图, 与原缓冲区共享同一批块
+    PooledBuffer Slice(size_t offset, size_t len) const;
+
+    // io_uring 固定缓冲区下标 (-1 表示池未注册)
+    int buf_index() const;
+
+    // 相对池起始的偏移 (共享 memfd 时使用)
+    uint64_t pool_offset() const;
+
+private:
+    friend class BufferPool;
+    struct Lease;   // 一次分配: 归还时释放对应块
+
+    std::shared_ptr<Lease> lease_;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+class BufferPool {
+public:
+    struct Config {
+        size_t block_size = 2ULL << 20;     // 分配粒度, 按 4KB 对齐
+        size_t num_blocks = 256;
+        bool use_hugepages = true;          // 失败时自动回退
+        std::string name = "nebula-pool";
+    };
+
+    static Result<std::unique_ptr<BufferPool>> Create(Config config);
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // 分配至少 size 字节 (向上取整到块大小), 池耗尽返回 kNoSpace.
+    // 返回的缓冲区可在池对象销毁后继续使用, 内存随最后一个引用释放
+    Result<PooledBuffer> Acquire(size_t size);
+
+    // 注册为 engine 的固定缓冲区 (替换 engine 现有注册), 成功返回 true
+    bool RegisterWith(IoEngine* engine);
+
+    // ptr 落在池内且 [ptr, ptr+len) 不跨注册段时返回固定缓冲区下标, 否则 -1
+    int FixedIndex(const void* ptr, size_t len) const;
+
+    int fd() const;
+    uint8_t* base() const;
+    size_t capacity() const;
+    size_t block_size() const;
+    size_t free_blocks() const;
+    bool hugepages() const;
+
+private:
+    friend class PooledBuffer;
+    struct Region;   // 映射与空闲块表, 由池与所有缓冲区共享
+
+    explicit BufferPool(std::shared_ptr<Region> region);
+
+    std::shared_ptr<Region> region_;
+};
+
+} // namespace nebulastore::storage
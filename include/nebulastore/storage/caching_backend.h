@@ -0,0 +1,188 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "nebulastore/storage/backend.h"
+
+namespace nebulastore::storage {
+
+// ================================
+// TinyLFU 频率估计 (Count-Min Sketch, 4 位计数)
+// ================================
+//
+// 每个 key 在 4 行中各占一个计数器, 估计值取最小. 累计 sample_size 次
+// 记录后所有计数减半, 让历史热度随时间衰减.
+
+class FrequencySketch {
+public:
+    explicit FrequencySketch(size_t expected_entries);
+
+    void Record(uint64_t hash);
+    uint32_t Estimate(uint64_t hash) const;
+
+private:
+    static constexpr int kDepth = 4;
+    static constexpr uint8_t kMaxCount = 15;
+
+    size_t Index(uint64_t hash, int row) const;
+    void Age();
+
+    std::vector<uint8_t> table_;   // kDepth 行, 每行 width_ 个计数器
+    size_t width_;                 // 2 的幂
+    uint64_t additions_ = 0;
+    uint64_t sample_size_;
+};
+
+// ================================
+// 本地磁盘块缓存 (装饰任意 StorageBackend)
+// ================================
+//
+// 对象按 block_size 切块缓存在本地盘 ({dir}/{key}@{块号}), 内存中只保存索引.
+// - 读: 命中的块直接从本地盘读; 连续未命中的块合并为一次远端范围读
+// - 准入: 缓存满时新块的 TinyLFU 频率须高于 LRU 尾部的淘汰候选才写入
+// - 回填: 远端读返回后异步写盘 (先写临时文件再 rename), 不阻塞读者
+// - 重启: 构造时扫描缓存目录重建索引, 按修改时间恢复 LRU 顺序
+// Put/Delete 透传并使该对象已缓存的块失效. 对象按不可变处理 (slice 对象).
+
+class CachingBackend : public StorageBackend {
+public:
+    struct Config {
+        std::string cache_dir;
+        uint64_t capacity_bytes = 1ULL << 30;
+        uint64_t block_size = 1ULL << 20;
+        bool admission = true;              // 关闭时未命中即回填 (纯 LRU)
+        uint32_t max_pending_fills = 64;    // 在途回填上限, 超出时跳过回填
+        IoEngine::Config io;                // 本地盘 IO 引擎
+    };
+
+    struct Stats {
+        uint64_t hit_blocks = 0;
+        uint64_t miss_blocks = 0;
+        uint64_t filled_blocks = 0;
+        uint64_t rejected_blocks = 0;     // 准入拒绝或回填跳过
+        uint64_t evicted_blocks = 0;
+        uint64_t cached_blocks = 0;
+        uint64_t used_bytes = 0;
+    };
+
+    CachingBackend(Config config, std::shared_ptr<StorageBackend> remote);
+    // 等待在途回填
+    ~CachingBackend() override;
+
+    // 未命中走远端, 与远端一致
+    bool AsyncReads() const override { return remote_->AsyncReads(); }
+
+    // === 实现 StorageBackend 接口 ===
+
+    AsyncTask<Status> Put(
+        const std::string& key,
+        const ByteBuffer& data
+    ) override;
+
+    AsyncTask<Status> Get(
+        const std::string& key,
+        ByteBuffer* data
+    ) override;
+
+    AsyncTask<Status> Delete(
+        const std::string& key
+    ) override;
+
+    AsyncTask<Status> Exists(
+        const std::string& key
+    ) override;
+
+    AsyncTask<Status> GetRange(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        ByteBuffer* data
+    ) override;
+
+    AsyncTask<Status> GetRangeInto(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        uint8_t* dst,
+        uint64_t* bytes_read
+    ) override;
+
+    // 块全部已缓存的项读本地盘, 其余按块对齐后一次交给远端 BatchRead 并回填
+    AsyncTask<void> BatchRead(
+        const std::vector<ReadRequest>& requests,
+        std::vector<ReadResult>* results,
+        uint32_t max_concurrency = 64
+    ) override;
+
+    AsyncTask<Status> HealthCheck() override;
+    AsyncTask<Status> GetCapacity(CapacityInfo* info) override;
+
+    Stats stats() const;
+
+    // 等待当前所有异步回填完成
+    void WaitForFills();
+
+private:
+    struct BlockRef {
+        std::string key;
+        uint64_t block;
+    };
+
+    struct Entry {
+        uint64_t size;                          // 块实际大小 (对象末块可能较短)
+        std::list<BlockRef>::iterator lru;      // 在 lru_ 中的位置
+    };
+
+    // 本地盘上的文件名 (相对缓存目录)
+    static std::string BlockKey(const std::string& key, uint64_t block);
+
+    // 扫描缓存目录重建索引
+    void Rebuild();
+
+    // 记录访问频率; 命中时返回块大小并移到 LRU 头部
+    bool Lookup(const std::string& key, uint64_t block, uint64_t* size);
+    bool Contains(const std::string& key, uint64_t block) const;
+    // [offset, offset + size) 涉及的块都已缓存 (遇到对象末块为止)
+    bool ContainsRange(const std::string& key, uint64_t offset, uint64_t size) const;
+    // 以下两个须持有 mutex_
+    void EraseLocked(const std::string& key, uint64_t block);
+    void InsertLocked(const std::string& key, uint64_t block, uint64_t size);
+
+    void Forget(const std::string& key, uint64_t block);
+    void InvalidateObject(const std::string& key);
+
+    // 远端读 [first, last] 块, 拷出请求范围内的部分, 并异步回填
+    AsyncTask<Status> FetchRemote(const std::string& key, uint64_t first, uint64_t last,
+                                  uint64_t offset, uint64_t size, uint8_t* dst,
+                                  uint64_t* copied, bool* eof);
+    void ScheduleFill(const std::string& key, uint64_t block, ByteBuffer data);
+    // 准入判断, 通过时预留空间并返回需淘汰的块文件
+    bool Admit(const std::string& key, uint64_t block, uint64_t size,
+               std::vector<std::string>* victims);
+    DetachedTask Fill(std::string key, uint64_t block, ByteBuffer data);
+    void FinishFill();
+
+    Config config_;
+    std::shared_ptr<StorageBackend> remote_;
+    std::unique_ptr<LocalBackend> disk_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::unordered_map<uint64_t, Entry>> index_;  // 对象 -> 块
+    std::list<BlockRef> lru_;                       // 头部最近使用
+    std::unordered_set<std::string> filling_;       // 回填中的块 (BlockKey)
+    FrequencySketch sketch_;
+    Stats stats_;
+
+    std::mutex fill_mutex_;
+    std::condition_variable fill_cv_;
+    uint32_t pending_fills_ = 0;
+};
+
+} // namespace nebulastore::storage
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+#include "nebulastore/common/types.h"
+
+namespace nebulastore::storage {
+
+// ================================
+// 异步 IO 引擎 (io_uring / 线程池回退)
+// ================================
+
+enum class IoOp : uint8_t {
+    kRead,
+    kWrite,
+    kFsync,
+};
+
+// 单个 IO 请求
+struct IoRequest {
+    IoOp op = IoOp::kRead;
+    int fd = -1;
+    void* buf = nullptr;
+    uint64_t len = 0;
+    uint64_t offset = 0;
+    int file_index = -1;   // io_uring 注册文件槽位 (-1 表示使用 fd)
+    int buf_index = -1;    // io_uring 注册缓冲区下标 (-1 表示普通缓冲区)
+};
+
+// IO 完成记录: 由提交方持有, 完成前必须保持有效
+struct IoCompletion {
+    IoRequest req;
+    int64_t result = 0;    // >=0 传输字节数, <0 为 -errno
+    void (*on_complete)(IoCompletion*) = nullptr;
+    std::coroutine_handle<> waiter;
+};
+
+class IoEngine {
+public:
+    struct Config {
+        bool use_io_uring = true;          // 不可用时自动回退到线程池
+        uint32_t queue_depth = 256;        // SQ 深度, 即单引擎最大在途 IO
+        bool sqpoll = false;               // 内核 SQ 轮询线程
+        uint32_t sqpoll_idle_ms = 1000;
+        uint32_t fallback_threads = 8;     // 线程池回退时的工作线程数
+        uint32_t max_registered_files = 1024;
+    };
+
+    virtual ~IoEngine() = default;
+
+    // 提交一个 IO, 完成后在引擎线程调用 c->on_complete
+    virtual void Submit(IoCompletion* c) = 0;
+
+    // 批量提交 (io_uring 下一次 io_uring_enter)
+    virtual void SubmitBatch(IoCompletion* const* cs, size_t n) {
+        for (size_t i = 0; i < n; ++i) Submit(cs[i]);
+    }
+
+    // 注册文件, 返回槽位 (-1 表示不支持或槽位已满)
+    virtual int RegisterFile(int fd) { (void)fd; return -1; }
+    virtual void UnregisterFile(int index) { (void)index; }
+
+    // 注册固定缓冲区 (整体替换), 成功返回 true
+    virtual bool RegisterBuffers(const std::vector<iovec>& iovs) { (void)iovs; return false; }
+
+    virtual const char* Name() const = 0;
+
+    // === 协程接口 ===
+
+    class IoAwaiter {
+    public:
+        IoAwaiter(IoEngine* engine, const IoRequest& req) : engine_(engine) {
+            completion_.req = req;
+            completion_.on_complete = &IoAwaiter::Resume;
+        }
+
+        bool await_ready() noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            completion_.waiter = h;
+            engine_->Submit(&completion_);
+        }
+
+        int64_t await_resume() noexcept { return completion_.result; }
+
+    private:
+        static void Resume(IoCompletion* c) { c->waiter.resume(); }
+
+        IoEngine* engine_;
+        IoCompletion completion_;
+    };
+
+    // 一批 IO 经一次 SubmitBatch 提交, 全部完成后恢复协程, 按请求顺序返回结果.
+    // 请求数须不超过 queue_depth (io_uring 提交时按在途上限阻塞)
+    class BatchAwaiter {
+    public:
+        BatchAwaiter(IoEngine* engine, const std::vector<IoRequest>& reqs)
+            : engine_(engine), entries_(reqs.size()) {
+            for (size_t i = 0; i < reqs.size(); ++i) {
+                entries_[i].req = reqs[i];
+                entries_[i].on_complete = &BatchAwaiter::Complete;
+                entries_[i].owner = this;
+            }
+        }
+
+        BatchAwaiter(const BatchAwaiter&) = delete;
+        BatchAwaiter& operator=(const BatchAwaiter&) = delete;
+
+        bool await_ready() noexcept { return entries_.empty(); }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            waiter_ = h;
+            remaining_.store(entries_.size(), std::memory_order_relaxed);
+            std::vector<IoCompletion*> cs;
+            cs.reserve(entries_.size());
+            for (auto& e : entries_) cs.push_back(&e);
+            engine_->SubmitBatch(cs.data(), cs.size());
+        }
+
+        std::vector<int64_t> await_resume() {
+            std::vector<int64_t> results;
+            results.reserve(entries_.size());
+            for (const auto& e : entries_) results.push_back(e.result);
+            return results;
+        }
+
+    private:
+        struct Entry : IoCompletion {
+            BatchAwaiter* owner = nullptr;
+        };
+
+        static void Complete(IoCompletion* c) {
+            auto* self = static_cast<Entry*>(c)->owner;
+            if (self->remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                self->waiter_.resume();
+            }
+        }
+
+        IoEngine* engine_;
+        std::vector<Entry> entries_;
+        std::atomic<size_t> remaining_{0};
+        std::coroutine_handle<> waiter_;
+    };
+
+    BatchAwaiter ReadBatch(const std::vector<IoRequest>& reqs) {
+        return BatchAwaiter(this, reqs);
+    }
+
+    IoAwaiter Read(int fd, void* buf, uint64_t len, uint64_t offset,
+                   int file_index = -1, int buf_index = -1) {
+        return IoAwaiter(this, IoRequest{IoOp::kRead, fd, buf, len, offset, file_index, buf_index});
+    }
+
+    IoAwaiter Write(int fd, const void* buf, uint64_t len, uint64_t offset,
+                    int file_index = -1, int buf_index = -1) {
+        return IoAwaiter(this, IoRequest{IoOp::kWrite, fd, const_cast<void*>(buf), len, offset,
+                                         file_index, buf_index});
+    }
+
+    IoAwaiter Fsync(int fd) {
+        return IoAwaiter(this, IoRequest{IoOp::kFsync, fd, nullptr, 0, 0, -1, -1});
+    }
+};
+
+// 创建 IO 引擎: 优先 io_uring, 内核不支持或被禁用时回退到线程池
+std::unique_ptr<IoEngine> CreateIoEngine(const IoEngine::Config& config);
+
+// 线程池实现 (pread/pwrite)
+std::unique_ptr<IoEngine> CreateThreadPoolIoEngine(const IoEngine::Config& config);
+
+// io_uring 实现, 失败时返回 nullptr
+std::unique_ptr<IoEngine> CreateIoUringEngine(const IoEngine::Config& config);
+
+} // namespace nebulastore::storage
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "nebulastore/storage/backend.h"
+
+namespace nebulastore::storage {
+
+// ================================
+// 进程内块缓存 (分片 S3-FIFO)
+// ================================
+//
+// key = (storage_key, 块号), 按哈希分片, 每片一把锁. 每片按 S3-FIFO 淘汰:
+// - 新块进入 small 队列 (约占 10%), 被淘汰时若期间被再次访问则晋升 main,
+//   否则只留下哈希进 ghost 队列; 命中 ghost 的块直接进入 main
+// - main 队列按 CLOCK 方式淘汰: 访问计数 > 0 的块减一后重新入队
+// 一次性扫描只会流过 small 队列, 不会冲掉 main 中的热块.
+// 内存上限严格按块数据 + 索引开销计, 每片平分; 超过单片上限的块不缓存.
+// 命中返回共享的 ByteBuffer 视图, 不拷贝.
+
+class BlockCache {
+public:
+    struct Config {
+        uint64_t capacity_bytes = 256ULL << 20;
+        uint32_t shards = 16;
+        uint32_t small_ratio_percent = 10;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        uint64_t evictions = 0;
+        uint64_t ghost_hits = 0;    // 曾被淘汰又回来的块 (直接进 main)
+        uint64_t entries = 0;
+        uint64_t bytes = 0;
+
+        double hit_ratio() const {
+            uint64_t total = hits + misses;
+            return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    explicit BlockCache(Config config);
+    ~BlockCache();
+
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+
+    // 命中时返回 true 并写出数据视图
+    bool Lookup(const std::string& key, uint64_t block, ByteBuffer* data);
+
+    // 已存在时替换; 数据由缓存持有 (调用方负责不要传入池化内存)
+    void Insert(const std::string& key, uint64_t block, ByteBuffer data);
+
+    // 删除对象的所有块
+    void EraseObject(const std::string& key);
+
+    Stats stats() const;
+    uint64_t capacity() const { return config_.capacity_bytes; }
+
+private:
+    struct Shard;
+
+    Shard& ShardFor(uint64_t hash);
+
+    Config config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// ================================
+// 内存块缓存后端 (装饰任意 StorageBackend)
+// ================================
+//
+// 范围读按 block_size 对齐缓存, 连续未命中的块合并为一次下层读.
+// 整对象 Get 按块缓存, 末块短于 block_size (或空块) 标记对象结尾,
+// 全部命中时不访问下层. Put/Delete 透传并使该对象的块失效.
+
+class MemoryCacheBackend : public StorageBackend {
+public:
+    struct Config {
+        BlockCache::Config cache;
+        uint64_t block_size = 256ULL << 10;
+    };
+
+    MemoryCacheBackend(Config config, std::shared_ptr<StorageBackend> inner);
+    ~MemoryCacheBackend() override = default;
+
+    // 命中不做 IO, 未命中与下层一致
+    bool AsyncReads() const override { return inner_->AsyncReads(); }
+
+    // === 实现 StorageBackend 接口 ===
+
+    AsyncTask<Status> Put(
+        const std::string& key,
+        const ByteBuffer& data
+    ) override;
+
+    AsyncTask<Status> Get(
+        const std::string& key,
+        ByteBuffer* data
+    ) override;
+
+    AsyncTask<Status> Delete(
+        const std::string& key
+    ) override;
+
+    AsyncTask<Status> Exists(
+        const std::string& key
+    ) override;
+
+    AsyncTask<Status> GetRange(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        ByteBuffer* data
+    ) override;
+
+    AsyncTask<Status> GetRangeInto(
+        const std::string& key,
+        uint64_t offset,
+        uint64_t size,
+        uint8_t* dst,
+        uint64_t* bytes_read
+    ) override;
+
+    // 命中项直接由缓存组装, 未命中项按块对齐后一次交给下层 BatchRead
+    AsyncTask<void> BatchRead(
+        const std::vector<ReadRequest>& requests,
+        std::vector<ReadResult>* results,
+        uint32_t max_concurrency = 64
+    ) override;
+
+    AsyncTask<Status> HealthCheck() override;
+    AsyncTask<Status> GetCapacity(CapacityInfo* info) override;
+
+    BlockCache::Stats stats() const { return cache_.stats(); }
+
+private:
+    // 只查缓存: 整个对象 / [offset, offset + size) 全部命中时返回 true
+    bool LookupObject(const std::string& key, ByteBuffer* data);
+    bool LookupRange(const std::string& key, uint64_t offset, uint64_t size, ByteBuffer* data);
+    // 读取 [first, last] 块 (命中取缓存, 未命中合并读下层), 遇到对象末尾提前停止
+    AsyncTask<Status> LoadBlocks(const std::string& key, uint64_t first, uint64_t last,
+                                 std::vector<ByteBuffer>* blocks);
+    // 缓存下层返回的数据 (按块拷贝, 不持有下层缓冲区)
+    void InsertBlocks(const std::string& key, uint64_t first_block, const ByteBuffer& data,
+                      uint64_t requested);
+
+    Config config_;
+    std::shared_ptr<StorageBackend> inner_;
+    BlockCache cache_;
+};
+
+} // namespace nebulastore::storage
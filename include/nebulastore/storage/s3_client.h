@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "nebulastore/storage/backend.h"
+
+namespace nebulastore::storage {
+
+// ================================
+// S3 客户端组件
+// ================================
+//
+// S3Backend 内部使用的签名、延迟统计、范围读规划等组件, 不依赖 curl 连接, 可单独测试.
+
+// ================================
+// AWS SigV4 签名
+// ================================
+//
+// 签名密钥 (四级 HMAC 派生) 只随 UTC 日期变化, 按 date_stamp 缓存, 每次请求
+// 只剩 canonical request 摘要与最终 HMAC 两步. 摘要走 OpenSSL EVP 接口 (自动
+// 使用 SHA-NI / ARMv8 SHA 指令), 每线程复用一个 EVP_MD_CTX; canonical request
+// 与 string-to-sign 在线程局部缓冲区中拼接, 稳态下不产生临时字符串.
+
+class SigV4Signer {
+public:
+    static constexpr size_t kDigestSize = 32;
+    using Digest = std::array<unsigned char, kDigestSize>;
+
+    SigV4Signer(std::string access_key, std::string secret_key, std::string region)
+        : access_key_(std::move(access_key)),
+          secret_key_(std::move(secret_key)),
+          region_(std::move(region)) {}
+
+    // 返回 Host / x-amz-date / x-amz-content-sha256 / Authorization 请求头;
+    // canonical_uri 须已编码, query 须已是规范形式
+    std::vector<std::string> Sign(std::string_view method, std::string_view host,
+                                  std::string_view canonical_uri, std::string_view query,
+                                  time_t now) const;
+
+    static void Sha256(std::string_view data, unsigned char* out);
+
+    // RFC 2104 HMAC, 直接在复用的摘要上下文上计算 (避免每次新建 HMAC 上下文)
+    static void HmacSha256(const unsigned char* key, size_t key_len, std::string_view data,
+                           unsigned char* out);
+
+    // kSigning = HMAC(HMAC(HMAC(HMAC("AWS4" + secret, date), region), service), "aws4_request")
+    static Digest DeriveKey(std::string_view secret, std::string_view date_stamp,
+                            std::string_view region, std::string_view service);
+
+    static void AppendHex(std::string* out, const unsigned char* data, size_t len);
+
+private:
+    // 每线程一个摘要上下文 (定义见 s3_backend.cpp)
+    struct DigestContext;
+
+    // x-amz-date (YYYYMMDDTHHMMSSZ), 每线程按秒缓存格式化结果
+    static std::string_view AmzDate(time_t now);
+
+    Digest SigningKey(std::string_view date_stamp) const;
+
+    std::string access_key_;
+    std::string secret_key_;
+    std::string region_;
+
+    mutable std::mutex key_mutex_;
+    mutable char key_date_[8] = {};     // 缓存密钥对应的 YYYYMMDD
+    mutable Digest key_{};
+};
+
+// ================================
+// 延迟直方图
+// ================================
+//
+// 对数分桶: 每个 2 的幂区间再等分 4 档, 分位数相对误差不超过 25%.
+// 计数器为原子变量, 记录不加锁; 样本数达到 kDecaySamples 时所有计数减半,
+// 分位数随端点近况变化而不被历史样本拖住.
+
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 2;
+    static constexpr size_t kBuckets = 64 << kSubBits;
+    static constexpr uint64_t kDecaySamples = 1 << 16;
+
+    void Record(uint64_t micros);
+
+    uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+
+    // 返回第 p 分位 (0 < p <= 1) 所在桶的上界, 无样本时返回 0
+    uint64_t Percentile(double p) const;
+
+    // 值所在的桶与桶内最大值
+    static size_t Bucket(uint64_t v);
+    static uint64_t UpperBound(size_t bucket);
+
+private:
+    void Decay();
+
+    std::atomic<uint64_t> buckets_[kBuckets] = {};
+    std::atomic<uint64_t> total_{0};
+    std::mutex decay_mutex_;
+};
+
+// ================================
+// 对冲预算
+// ================================
+//
+// 每次 GET 积攒 percent 个令牌, 一次对冲消耗 100 个, 对冲数因此不超过 GET 数的
+// 该百分比; 最多积攒 burst 次对冲, 空闲之后也不会突发大量对冲.
+
+class HedgeBudget {
+public:
+    static constexpr int64_t kDefaultBurst = 10;
+
+    explicit HedgeBudget(uint32_t percent, int64_t burst = kDefaultBurst)
+        : percent_(percent), cap_(burst * 100) {}
+
+    void Earn();
+
+    // 预算足够时扣除一次对冲并返回 true
+    bool Take();
+
+    int64_t tokens() const { return tokens_.load(std::memory_order_relaxed); }
+
+private:
+    const int64_t percent_;
+    const int64_t cap_;
+    std::atomic<int64_t> tokens_{0};
+};
+
+// ================================
+// 批量范围读规划
+// ================================
+//
+// 同一对象相邻 (间隙不超过 kRangeMergeGap) 的范围请求合并为一次范围 GET,
+// 合并后长度不超过 kMaxMergedRange; 整对象请求各自一次 GET.
+
+inline constexpr uint64_t kRangeMergeGap = 64ULL << 10;
+inline constexpr uint64_t kMaxMergedRange = 16ULL << 20;
+
+// 一次实际的 GET: size == 0 为整对象, members 为它服务的请求下标
+struct RangeFetch {
+    std::string key;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    std::vector<size_t> members;
+};
+
+std::vector<RangeFetch> PlanRangeFetches(const std::vector<StorageBackend::ReadRequest>& requests);
+
+// 把一次 GET 的结果分发给它合并的各请求 (范围请求取视图, 不拷贝)
+void DistributeRangeFetch(const RangeFetch& fetch, const Status& status, const ByteBuffer& body,
+                          const std::vector<StorageBackend::ReadRequest>& requests,
+                          std::vector<StorageBackend::ReadResult>* results);
+
+} // namespace nebulastore::storage
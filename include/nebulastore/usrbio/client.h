@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "nebulastore/common/result.h"
+#include "nebulastore/common/types.h"
+#include "nebulastore/storage/buffer_pool.h"
+#include "nebulastore/usrbio/ioring.h"
+
+namespace nebulastore {
+namespace usrbio {
+
+// ================================
+// usrbio 客户端库
+// ================================
+//
+// 训练进程直接与 usrbio 服务端共享 IoRing 和数据缓冲区, 绕过 FUSE:
+//
+//   auto client = UsrbioClient::Connect(path).value();
+//   auto buf = client->RegisterBuffer(64 << 20).value();
+//   auto ring = client->CreateRing(256, true).value();
+//   client->PrepareIo(ring, buf, 0, inode, offset, len, ctx);
+//   client->Submit(ring);
+//   client->Wait(ring, cqes, 16, 1, -1);   // 数据已在 buf.data 中
+
+class UsrbioClient {
+public:
+    // 已注册的共享缓冲区 (memfd 映射)
+    struct Buffer {
+        uint32_t id = 0;
+        uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    // 已注册的 IoRing
+    struct Ring {
+        uint32_t id = 0;
+        IoRing* io = nullptr;
+    };
+
+    static Result<std::unique_ptr<UsrbioClient>> Connect(const std::string& socket_path);
+    ~UsrbioClient();
+
+    UsrbioClient(const UsrbioClient&) = delete;
+    UsrbioClient& operator=(const UsrbioClient&) = delete;
+
+    // === 资源注册 ===
+
+    Result<Buffer> RegisterBuffer(size_t size);
+
+    // 把整个缓冲池注册为一个缓冲区 (共享池的 memfd), 池内缓冲区的
+    // pool_offset() 即 buf_off. 池须在注销前保持存活
+    Result<Buffer> RegisterBuffer(const storage::BufferPool& pool);
+    Status UnregisterBuffer(const Buffer& buffer);
+
+    Result<Ring> CreateRing(uint32_t entries, bool for_read = true);
+    Status DestroyRing(const Ring& ring);
+
+    // === IO ===
+
+    // 同一 ring 的 SQ/CQ 在共享内存中是单生产者单消费者的:
+    // 多个应用线程应各用一个 ring, 或自行串行化提交与收割.
+
+    // 准备一个 IO: 读 ring 把文件数据读入缓冲区, 写 ring 把缓冲区写入文件.
+    // 条目立即对服务端可见, 但服务端休眠时需调用 Submit() 唤醒.
+    // 返回条目索引, SQ 满返回 -EAGAIN, 参数越界返回 -EINVAL
+    int PrepareIo(const Ring& ring, const Buffer& buffer, uint32_t buf_off,
+                  InodeID inode, uint64_t file_off, uint64_t len, void* userdata);
+
+    // 按需敲 SQ 门铃 (服务端未休眠时无系统调用)
+    void Submit(const Ring& ring);
+
+    // 批量提交: 一次发布 + 至多一次门铃. args 须引用本客户端注册的缓冲区
+    // (服务端会再次校验). 返回实际提交数, SQ 剩余空间不足时少于 n
+    int SubmitIos(const Ring& ring, const IoArgs* args, int n);
+
+    // 收割完成项: 至少等到 min_complete 个 (timeout_ms < 0 表示一直等),
+    // 返回收到的 CQE 数. 短暂自旋后阻塞在 CQ 门铃上
+    int Wait(const Ring& ring, IoCqe* cqes, int max_cqes, int min_complete, int timeout_ms);
+
+private:
+    struct Mapping;
+
+    explicit UsrbioClient(int sock);
+
+    // 发送控制请求并等待应答, 返回应答状态 (0 或 -errno)
+    int Call(const void* req, size_t len, const int* fds, size_t nfds, uint32_t* id);
+
+    int sock_ = -1;
+    std::mutex mutex_;   // 控制通道一问一答, 串行化
+    std::unordered_map<uint32_t, std::unique_ptr<Mapping>> buffers_;
+    std::unordered_map<uint32_t, std::unique_ptr<Mapping>> rings_;
+    std::unordered_map<uint32_t, std::unique_ptr<IoRing>> ring_views_;
+    std::unordered_map<uint32_t, std::pair<int, int>> doorbells_;  // ring ID -> (SQ, CQ) eventfd
+};
+
+}  // namespace usrbio
+}  // namespace nebulastore
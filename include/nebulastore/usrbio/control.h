@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nebulastore {
+namespace usrbio {
+
+// ================================
+// usrbio 控制通道协议
+// ================================
+//
+// Unix domain socket (SOCK_SEQPACKET), 一问一答.
+// 注册类请求通过 SCM_RIGHTS 附带 memfd (及门铃 eventfd), 服务端 mmap 后即可零拷贝访问.
+
+enum class CtrlOp : uint32_t {
+    kRegisterBuffer = 1,    // 附带 memfd, size 为映射长度
+    kRegisterRing = 2,      // 附带 memfd + SQ 门铃 + CQ 门铃 (eventfd), size 为映射长度
+    kUnregisterBuffer = 3,  // id 为缓冲区 ID
+    kUnregisterRing = 4,    // id 为 ring ID
+};
+
+// 单条消息最多附带的 fd 数
+constexpr size_t kMaxCtrlFds = 4;
+
+struct CtrlRequest {
+    CtrlOp op;
+    uint32_t id;
+    uint64_t size;
+};
+
+struct CtrlResponse {
+    int32_t status;   // 0 成功, <0 为 -errno
+    uint32_t id;      // 注册得到的 ID
+};
+
+// 发送一条消息, 附带 fds[0..nfds). 成功返回 0, 失败返回 -errno
+int SendCtrlMsg(int sock, const void* msg, size_t len,
+                const int* fds = nullptr, size_t nfds = 0);
+
+// 接收一条消息, 附带的 fd 依次写入 fds (最多 max_fds 个, 多余的关闭),
+// 个数写入 *nfds. 返回收到的字节数, 对端关闭返回 0, 失败返回 -errno
+int RecvCtrlMsg(int sock, void* msg, size_t len,
+                int* fds = nullptr, size_t max_fds = 0, size_t* nfds = nullptr);
+
+}  // namespace usrbio
+}  // namespace nebulastore
@@ -3,7 +3,10 @@
 #include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <new>
 #include <vector>
+#include <unistd.h>
 
 namespace nebulastore {
 namespace usrbio {
@@ -32,82 +35,341 @@ struct IoCqe {
     void* userdata;       // 用户数据
 };
 
-// 无锁环形队列
+// 缓存行大小 (x86/ARM 服务器常见值)
+constexpr size_t kCacheLineSize = 64;
+
+// 环形队列索引, 可放在跨进程共享内存中.
+// head 由消费方写、tail 由生产方写, 分处不同缓存行避免伪共享
+struct RingIndices {
+    alignas(kCacheLineSize) std::atomic<uint32_t> head{0};
+    alignas(kCacheLineSize) std::atomic<uint32_t> tail{0};
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "shared-memory rings need lock-free atomics");
+
+// 无锁环形队列 (单生产者单消费者)
+// 索引与条目可以由自身持有, 也可以指向外部 (共享内存) 存储.
+// 双方各自缓存对端下标, 只在缓存值显示满/空时才重新读取共享下标
 template <typename T>
 class LockFreeRing {
 public:
     explicit LockFreeRing(uint32_t capacity)
         : capacity_(capacity), mask_(capacity - 1),
-          head_(0), tail_(0), entries_(capacity) {
+          own_indices_(std::make_unique<RingIndices>()),
+          own_entries_(capacity),
+          indices_(own_indices_.get()),
+          entries_(own_entries_.data()) {
         // capacity 必须是 2 的幂
     }
 
+    // 外部存储: indices 与 entries[capacity] 由调用方保证生命周期
+    LockFreeRing(RingIndices* indices, T* entries, uint32_t capacity)
+        : capacity_(capacity), mask_(capacity - 1),
+          indices_(indices), entries_(entries) {}
+
     bool Push(const T& entry) {
-        uint32_t tail = tail_.load(std::memory_order_relaxed);
-        uint32_t next = (tail + 1) & mask_;
-        if (next == head_.load(std::memory_order_acquire)) {
-            return false;  // 队列满
-        }
-        entries_[tail] = entry;
-        tail_.store(next, std::memory_order_release);
-        return true;
+        return PushBatch(&entry, 1) == 1;
     }
 
     bool Pop(T& entry) {
-        uint32_t head = head_.load(std::memory_order_relaxed);
-        if (head == tail_.load(std::memory_order_acquire)) {
-            return false;  // 队列空
+        return PopBatch(&entry, 1) == 1;
+    }
+
+    // 批量入队: 一次 acquire 读对端下标, 一次 release 发布, 返回实际入队数
+    uint32_t PushBatch(const T* entries, uint32_t n) {
+        uint32_t start;
+        n = ReservePush(n, &start);
+        for (uint32_t i = 0; i < n; ++i) {
+            Slot(start + i) = entries[i];
         }
-        entry = entries_[head];
-        head_.store((head + 1) & mask_, std::memory_order_release);
-        return true;
+        CommitPush(n);
+        return n;
+    }
+
+    // 批量出队, 返回实际出队数
+    uint32_t PopBatch(T* out, uint32_t n) {
+        uint32_t start;
+        n = PeekPop(n, &start);
+        for (uint32_t i = 0; i < n; ++i) {
+            out[i] = Slot(start + i);
+        }
+        CommitPop(n);
+        return n;
+    }
+
+    // === 两阶段接口: 先预留/查看槽位, 原地读写后再发布 ===
+
+    // 生产方: 预留至多 n 个空槽, 起始位置写入 *start, 返回可用数
+    uint32_t ReservePush(uint32_t n, uint32_t* start) {
+        uint32_t tail = indices_->tail.load(std::memory_order_relaxed) & mask_;
+        uint32_t free = mask_ - ((tail - producer_.cached) & mask_);
+        if (free < n) {
+            producer_.cached = indices_->head.load(std::memory_order_acquire) & mask_;
+            free = mask_ - ((tail - producer_.cached) & mask_);
+        }
+        *start = tail;
+        return n < free ? n : free;
+    }
+
+    void CommitPush(uint32_t n) {
+        if (n == 0) return;
+        uint32_t tail = indices_->tail.load(std::memory_order_relaxed);
+        indices_->tail.store((tail + n) & mask_, std::memory_order_release);
+    }
+
+    // 消费方: 查看至多 n 个待取条目, 起始位置写入 *start, 返回可取数
+    uint32_t PeekPop(uint32_t n, uint32_t* start) {
+        uint32_t head = indices_->head.load(std::memory_order_relaxed) & mask_;
+        uint32_t avail = (consumer_.cached - head) & mask_;
+        if (avail < n) {
+            consumer_.cached = indices_->tail.load(std::memory_order_acquire) & mask_;
+            avail = (consumer_.cached - head) & mask_;
+        }
+        *start = head;
+        return n < avail ? n : avail;
+    }
+
+    void CommitPop(uint32_t n) {
+        if (n == 0) return;
+        uint32_t head = indices_->head.load(std::memory_order_relaxed);
+        indices_->head.store((head + n) & mask_, std::memory_order_release);
     }
 
+    T& Slot(uint32_t pos) { return entries_[pos & mask_]; }
+    uint32_t Mask() const { return mask_; }
+
     uint32_t Count() const {
-        uint32_t head = head_.load(std::memory_order_acquire);
-        uint32_t tail = tail_.load(std::memory_order_acquire);
+        uint32_t head = indices_->head.load(std::memory_order_acquire);
+        uint32_t tail = indices_->tail.load(std::memory_order_acquire);
         return (tail - head) & mask_;
     }
 
     uint32_t Capacity() const { return capacity_ - 1; }
 
 private:
+    // 对端下标的本地缓存, 生产方/消费方各占一个缓存行
+    struct alignas(kCacheLineSize) CachedIndex {
+        uint32_t cached = 0;
+    };
+
     uint32_t capacity_;
     uint32_t mask_;
-    std::atomic<uint32_t> head_;
-    std::atomic<uint32_t> tail_;
-    std::vector<T> entries_;
+    std::unique_ptr<RingIndices> own_indices_;
+    std::vector<T> own_entries_;
+    RingIndices* indices_;
+    T* entries_;
+    CachedIndex producer_;   // 生产方看到的 head
+    CachedIndex consumer_;   // 消费方看到的 tail
+};
+
+// ================================
+// 有界 MPMC 队列 (Vyukov)
+// ================================
+//
+// 每个槽位带序号: 序号 == pos 表示可写, == pos + 1 表示可读.
+// 生产者之间、消费者之间只在各自的下标上 CAS, 不共享锁;
+// 适合多个应用线程向同一队列提交的场景. 容量必须是 2 的幂.
+
+template <typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(uint32_t capacity)
+        : mask_(capacity - 1), cells_(new Cell[capacity]) {
+        for (uint32_t i = 0; i < capacity; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    bool Push(const T& entry) {
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            uint64_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列满
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = entry;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& entry) {
+        uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            uint64_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列空
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        entry = std::move(cell->data);
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似值: 并发修改时仅供参考
+    uint32_t Count() const {
+        uint64_t tail = enqueue_pos_.load(std::memory_order_acquire);
+        uint64_t head = dequeue_pos_.load(std::memory_order_acquire);
+        return tail > head ? static_cast<uint32_t>(tail - head) : 0;
+    }
+
+    uint32_t Capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(kCacheLineSize) Cell {
+        std::atomic<uint64_t> seq;
+        T data;
+    };
+
+    const uint64_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLineSize) std::atomic<uint64_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<uint64_t> dequeue_pos_{0};
+};
+
+// ================================
+// IoRing 共享内存布局
+// ================================
+//
+// [IoRingHeader][IoArgs x n][IoSqe x n][IoCqe x n]
+//
+// 客户端在 memfd 上创建并初始化, 通过控制通道把 fd 交给服务端,
+// 服务端 mmap 同一段内存后 Attach. 内存中的 entries 只在 Attach 时读取一次,
+// 之后所有下标都按本地保存的 mask 截断, 客户端篡改头部不会越界.
+//
+// IoArgs 与 SQ 槽位一一对应: 槽位在服务端取走 SQE (并拷贝参数) 之前不会被复用.
+//
+// 门铃 (io_uring SQPOLL 式): 对端即将休眠时置 need_wakeup,
+// 生产方发布后检查该标志, 仅在需要时写一次 eventfd.
+
+constexpr uint32_t kIoRingMagic = 0x4e42494f;  // "NBIO"
+constexpr uint32_t kIoRingVersion = 3;
+
+struct alignas(kCacheLineSize) IoRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entries;     // 每个队列的槽位数 (2 的幂)
+    uint32_t for_read;
+    RingIndices sq;
+    RingIndices cq;
+    alignas(kCacheLineSize) std::atomic<uint32_t> sq_need_wakeup;   // 服务端休眠中, 提交后需敲 SQ 门铃
+    alignas(kCacheLineSize) std::atomic<uint32_t> cq_need_wakeup;   // 客户端阻塞等待中, 完成后需敲 CQ 门铃
 };
 
 // IoRing 核心类
 class IoRing {
 public:
+    // 进程内使用: 自行分配内存
     explicit IoRing(uint32_t entries, bool for_read = true)
-        : sq_(RoundUpPow2(entries + 1)),
-          cq_(RoundUpPow2(entries + 1)),
-          for_read_(for_read),
-          io_args_(RoundUpPow2(entries + 1)),
-          next_index_(0) {}
+        : owned_(new (std::align_val_t{64}) uint8_t[BytesFor(entries)]) {
+        InitLayout(owned_.get(), RoundUpPow2(entries + 1), for_read);
+        Bind(owned_.get());
+    }
 
-    // 添加提交队列条目
-    int AddSqe(const IoArgs& args) {
-        uint32_t idx = next_index_.fetch_add(1, std::memory_order_relaxed) % io_args_.size();
-        io_args_[idx] = args;
+    // 所需共享内存大小
+    static size_t BytesFor(uint32_t entries) {
+        size_t n = RoundUpPow2(entries + 1);
+        return sizeof(IoRingHeader) + n * (sizeof(IoArgs) + sizeof(IoSqe) + sizeof(IoCqe));
+    }
+
+    // 在外部内存上初始化 (创建方)
+    static std::unique_ptr<IoRing> Create(void* mem, size_t size, uint32_t entries, bool for_read) {
+        if (!mem || size < BytesFor(entries)) return nullptr;
+        InitLayout(mem, RoundUpPow2(entries + 1), for_read);
+        return std::unique_ptr<IoRing>(new IoRing(mem));
+    }
+
+    // 挂接已初始化的外部内存 (使用方), 校验失败返回 nullptr
+    static std::unique_ptr<IoRing> Attach(void* mem, size_t size) {
+        if (!mem || size < sizeof(IoRingHeader)) return nullptr;
+        auto* hdr = static_cast<IoRingHeader*>(mem);
+        uint32_t n = hdr->entries;
+        if (hdr->magic != kIoRingMagic || hdr->version != kIoRingVersion ||
+            n < 2 || (n & (n - 1)) != 0 || size < BytesFor(n - 1)) {
+            return nullptr;
+        }
+        return std::unique_ptr<IoRing>(new IoRing(mem));
+    }
 
-        IoSqe sqe;
-        sqe.index = idx;
-        sqe.reserved = 0;
-        sqe.userdata = args.userdata;
+    // === 提交方 (单生产者) ===
 
-        if (!sq_.Push(sqe)) {
+    // 添加提交队列条目, 返回条目索引, 队列满返回 -1
+    int AddSqe(const IoArgs& args) {
+        uint32_t start;
+        if (AddSqes(&args, 1, &start) == 0) {
             return -1;  // 队列满
         }
-        return static_cast<int>(idx);
+        return static_cast<int>(start & sq_->Mask());
+    }
+
+    // 批量提交: 预留 n 个 SQ 槽位, 参数写入同下标的 IoArgs, 一次 release 发布.
+    // 返回实际提交数 (SQ 剩余空间不足时少于 n), 首个条目索引写入 *first
+    uint32_t AddSqes(const IoArgs* args, uint32_t n, uint32_t* first = nullptr) {
+        uint32_t start;
+        n = sq_->ReservePush(n, &start);
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t slot = (start + i) & sq_->Mask();
+            io_args_[slot] = args[i];
+            sq_->Slot(slot) = IoSqe{slot, 0, args[i].userdata};
+        }
+        sq_->CommitPush(n);
+        if (first) *first = start;
+        return n;
     }
 
     // 消费完成队列条目
     bool PopCqe(IoCqe& cqe) {
-        return cq_.Pop(cqe);
+        return cq_->Pop(cqe);
+    }
+
+    // 批量消费完成项, 一次 release 归还槽位
+    uint32_t PopCqes(IoCqe* cqes, uint32_t max) {
+        return cq_->PopBatch(cqes, max);
+    }
+
+    // === 处理方 (单消费者) ===
+
+    // 获取待处理的 SQE
+    bool PopSqe(IoSqe& sqe) {
+        IoArgs args;
+        return PopSqes(&sqe, &args, 1) == 1;
+    }
+
+    // 批量取 SQE 并拷贝对应参数, 拷贝完成后才归还槽位.
+    // sqe.index 按槽位重写, 不信任共享内存中的值
+    uint32_t PopSqes(IoSqe* sqes, IoArgs* args, uint32_t max) {
+        uint32_t start;
+        uint32_t n = sq_->PeekPop(max, &start);
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t slot = (start + i) & sq_->Mask();
+            sqes[i] = sq_->Slot(slot);
+            sqes[i].index = slot;
+            args[i] = io_args_[slot];
+        }
+        sq_->CommitPop(n);
+        return n;
     }
 
     // 完成一个 IO (由 IO 处理线程调用)
@@ -116,24 +378,86 @@ public:
         cqe.index = index;
         cqe.result = result;
         cqe.userdata = userdata;
-        return cq_.Push(cqe);
+        return cq_->Push(cqe);
     }
 
-    // 获取待处理的 SQE
-    bool PopSqe(IoSqe& sqe) {
-        return sq_.Pop(sqe);
+    // 批量投递完成项, 返回实际投递数
+    uint32_t CompleteSqes(const IoCqe* cqes, uint32_t n) {
+        return cq_->PushBatch(cqes, n);
     }
 
-    // 获取 IO 参数
+    // 获取 IO 参数 (仅在对应 SQE 未被取走前有效)
     const IoArgs& GetIoArgs(uint32_t index) const {
-        return io_args_[index % io_args_.size()];
+        return io_args_[index & (entries_ - 1)];
+    }
+
+    // === 门铃 ===
+
+    // 绑定本进程内的门铃 eventfd (-1 表示不使用), fd 生命周期由调用方管理
+    void SetDoorbells(int sq_fd, int cq_fd) {
+        sq_doorbell_ = sq_fd;
+        cq_doorbell_ = cq_fd;
     }
+    int SqDoorbell() const { return sq_doorbell_; }
+    int CqDoorbell() const { return cq_doorbell_; }
+
+    // 提交方发布 SQE 后调用: 服务端休眠时敲一次门铃
+    void NotifySq() { Notify(hdr_->sq_need_wakeup, sq_doorbell_); }
+    // 处理方发布 CQE 后调用: 客户端阻塞时敲一次门铃
+    void NotifyCq() { Notify(hdr_->cq_need_wakeup, cq_doorbell_); }
 
-    uint32_t SqeCount() const { return sq_.Count(); }
-    uint32_t CqeCount() const { return cq_.Count(); }
+    // 休眠前登记/休眠后撤销. 登记后必须重新检查队列再休眠, 避免丢失唤醒
+    void SetSqNeedWakeup(bool on) { SetNeedWakeup(hdr_->sq_need_wakeup, on); }
+    void SetCqNeedWakeup(bool on) { SetNeedWakeup(hdr_->cq_need_wakeup, on); }
+
+    uint32_t SqeCount() const { return sq_->Count(); }
+    uint32_t CqeCount() const { return cq_->Count(); }
+    uint32_t CqCapacity() const { return cq_->Capacity(); }
     bool IsForRead() const { return for_read_; }
 
 private:
+    explicit IoRing(void* mem) { Bind(mem); }
+
+    struct AlignedDelete {
+        void operator()(uint8_t* p) const { ::operator delete[](p, std::align_val_t{64}); }
+    };
+
+    // 与对端的 "置标志 -> 再检查队列" 配对, 两侧都需要全屏障
+    static void Notify(std::atomic<uint32_t>& need_wakeup, int fd) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (fd >= 0 && need_wakeup.load(std::memory_order_relaxed)) {
+            uint64_t one = 1;
+            (void)!::write(fd, &one, sizeof(one));
+        }
+    }
+
+    static void SetNeedWakeup(std::atomic<uint32_t>& need_wakeup, bool on) {
+        need_wakeup.store(on ? 1 : 0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    static void InitLayout(void* mem, uint32_t n, bool for_read) {
+        auto* hdr = new (mem) IoRingHeader{};
+        hdr->magic = kIoRingMagic;
+        hdr->version = kIoRingVersion;
+        hdr->entries = n;
+        hdr->for_read = for_read ? 1 : 0;
+    }
+
+    void Bind(void* mem) {
+        hdr_ = static_cast<IoRingHeader*>(mem);
+        entries_ = hdr_->entries;
+        for_read_ = hdr_->for_read != 0;
+        auto* p = reinterpret_cast<uint8_t*>(hdr_ + 1);
+        io_args_ = reinterpret_cast<IoArgs*>(p);
+        p += entries_ * sizeof(IoArgs);
+        auto* sqes = reinterpret_cast<IoSqe*>(p);
+        p += entries_ * sizeof(IoSqe);
+        auto* cqes = reinterpret_cast<IoCqe*>(p);
+        sq_ = std::make_unique<LockFreeRing<IoSqe>>(&hdr_->sq, sqes, entries_);
+        cq_ = std::make_unique<LockFreeRing<IoCqe>>(&hdr_->cq, cqes, entries_);
+    }
+
     static uint32_t RoundUpPow2(uint32_t v) {
         v--;
         v |= v >> 1;
@@ -144,11 +468,15 @@ private:
         return v + 1;
     }
 
-    LockFreeRing<IoSqe> sq_;  // 提交队列
-    LockFreeRing<IoCqe> cq_;  // 完成队列
-    bool for_read_;
-    std::vector<IoArgs> io_args_;
-    std::atomic<uint32_t> next_index_;
+    std::unique_ptr<uint8_t[], AlignedDelete> owned_;
+    IoRingHeader* hdr_ = nullptr;
+    uint32_t entries_ = 0;
+    bool for_read_ = true;
+    IoArgs* io_args_ = nullptr;
+    std::unique_ptr<LockFreeRing<IoSqe>> sq_;  // 提交队列
+    std::unique_ptr<LockFreeRing<IoCqe>> cq_;  // 完成队列
+    int sq_doorbell_ = -1;
+    int cq_doorbell_ = -1;
 };
 
 }  // namespace usrbio
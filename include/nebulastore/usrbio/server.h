@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "nebulastore/common/async.h"
+#include "nebulastore/common/types.h"
+#include "nebulastore/metadata/metadata_service.h"
+#include "nebulastore/namespace/read_planner.h"
+#include "nebulastore/storage/backend.h"
+#include "nebulastore/usrbio/ioring.h"
+
+namespace nebulastore {
+namespace usrbio {
+
+// ================================
+// usrbio 服务端 (3FS USRBIO 风格)
+// ================================
+//
+// 客户端进程通过控制通道注册共享内存 IoRing 与数据缓冲区,
+// IO 线程批量取各 ring 的 SQE: 按 file_iid/file_off 解析文件布局,
+// 把数据直接读入 (或从) buf_id/buf_off 指向的共享缓冲区, 再攒批投递 CQE.
+// 所有 SQ 空闲时 IO 线程休眠在各 ring 的 SQ 门铃 (eventfd) 上.
+
+class UsrbioServer {
+public:
+    struct Config {
+        std::string socket_path = "/run/nebulastore/usrbio.sock";
+        uint32_t max_ring_entries = 4096;
+        uint64_t max_buffer_size = 1ULL << 34;   // 单个缓冲区上限 16GB
+        uint32_t max_rings_per_client = 64;
+        uint32_t max_buffers_per_client = 1024;
+        uint32_t spin_rounds = 64;               // 所有 SQ 为空时先空转的轮数, 之后等门铃
+        uint32_t idle_timeout_ms = 100;          // 等门铃的超时 (兜底)
+    };
+
+    UsrbioServer(Config config,
+                 metadata::MetadataService* metadata,
+                 storage::StorageBackend* backend);
+    ~UsrbioServer();
+
+    UsrbioServer(const UsrbioServer&) = delete;
+    UsrbioServer& operator=(const UsrbioServer&) = delete;
+
+    // 监听控制 socket 并启动控制线程与 IO 线程
+    Status Start();
+    void Stop();
+
+    // 当前所有 ring 上的在途 IO 数
+    uint64_t InflightIos() const { return inflight_total_.load(std::memory_order_relaxed); }
+
+private:
+    struct Mapping;   // mmap 的共享内存段
+    struct Ring;
+    struct Session;   // 一个客户端连接
+
+    void ControlLoop();
+    void IoLoop();
+
+    void HandleRequest(const std::shared_ptr<Session>& session, int fd);
+    void CloseSession(const std::shared_ptr<Session>& session);
+    void RefreshRings();
+    void WakeIoThread();
+
+    // 处理 ring 上可消费的 SQE, 返回本轮取出的条目数
+    uint32_t DrainRing(const std::shared_ptr<Ring>& ring);
+    DetachedTask ProcessSqe(std::shared_ptr<Ring> ring, IoSqe sqe, IoArgs args);
+
+    // 解析布局并读入目标内存, 返回字节数或 -errno
+    AsyncTask<int64_t> ReadFile(InodeID inode, uint64_t offset, uint64_t len, uint8_t* dst);
+    AsyncTask<int64_t> WriteFile(InodeID inode, uint64_t offset, ByteBuffer data);
+
+    Config config_;
+    metadata::MetadataService* metadata_;
+    storage::StorageBackend* backend_;
+    namespace_::ReadPlanner planner_;
+
+    int listen_fd_ = -1;
+    int wake_fd_ = -1;        // eventfd, 用于唤醒控制线程退出
+    int io_wake_fd_ = -1;     // eventfd, 唤醒 IO 线程 (退出或 ring 变化)
+    std::atomic<bool> running_{false};
+    std::thread control_thread_;
+    std::thread io_thread_;
+
+    std::mutex sessions_mutex_;
+    std::unordered_map<int, std::shared_ptr<Session>> sessions_;  // 按 socket fd
+
+    // IO 线程使用的 ring 快照, 注册/注销后递增版本号触发刷新
+    std::atomic<uint64_t> rings_version_{0};
+    uint64_t io_rings_version_ = 0;
+    std::vector<std::shared_ptr<Ring>> io_rings_;
+    std::vector<pollfd> io_pollfds_;
+
+    std::atomic<uint64_t> inflight_total_{0};
+};
+
+}  // namespace usrbio
+}  // namespace nebulastore
@@ -0,0 +1,267 @@
+// ================================
+// 元数据写入合批实现
+// ================================
+
+#include "nebulastore/metadata/group_commit.h"
+#include "nebulastore/common/logger.h"
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+namespace nebulastore::metadata {
+
+namespace {
+
+// 同组排在前面的提交写过的 key, 后面的提交读到它们时视为冲突
+struct GroupWrites {
+    std::set<std::string, std::less<>> keys;
+    std::vector<std::pair<std::string, std::string>> ranges;    // DeleteRange [begin, end)
+
+    bool Contains(std::string_view key) const {
+        if (keys.find(key) != keys.end()) return true;
+        for (const auto& [begin, end] : ranges) {
+            if (key >= begin && key < end) return true;
+        }
+        return false;
+    }
+};
+
+// 把一个 WriteBatch 的操作按序追加到合并批次 (只用默认列族); writes 非空时记录写过的 key
+class BatchAppender : public rocksdb::WriteBatch::Handler {
+public:
+    BatchAppender(rocksdb::WriteBatch* dst, GroupWrites* writes) : dst_(dst), writes_(writes) {}
+
+    rocksdb::Status PutCF(uint32_t cf, const rocksdb::Slice& key,
+                          const rocksdb::Slice& value) override {
+        if (cf != 0) return rocksdb::Status::NotSupported("column family");
+        Record(key);
+        return dst_->Put(key, value);
+    }
+
+    rocksdb::Status DeleteCF(uint32_t cf, const rocksdb::Slice& key) override {
+        if (cf != 0) return rocksdb::Status::NotSupported("column family");
+        Record(key);
+        return dst_->Delete(key);
+    }
+
+    rocksdb::Status MergeCF(uint32_t cf, const rocksdb::Slice& key,
+                            const rocksdb::Slice& value) override {
+        if (cf != 0) return rocksdb::Status::NotSupported("column family");
+        Record(key);
+        return dst_->Merge(key, value);
+    }
+
+    rocksdb::Status DeleteRangeCF(uint32_t cf, const rocksdb::Slice& begin,
+                                  const rocksdb::Slice& end) override {
+        if (cf != 0) return rocksdb::Status::NotSupported("column family");
+        if (writes_) writes_->ranges.emplace_back(begin.ToString(), end.ToString());
+        return dst_->DeleteRange(begin, end);
+    }
+
+private:
+    void Record(const rocksdb::Slice& key) {
+        if (writes_) writes_->keys.insert(key.ToString());
+    }
+
+    rocksdb::WriteBatch* dst_;
+    GroupWrites* writes_;
+};
+
+// 读集合仍与库中一致且未被同组写过时返回 OK, 否则 kAgain
+Status ValidateReads(rocksdb::DB* db, const std::vector<GroupCommitter::ReadCheck>& reads,
+                     const GroupWrites& writes) {
+    rocksdb::PinnableSlice value;
+    for (const auto& read : reads) {
+        if (writes.Contains(read.key)) {
+            return Status::Again("Transaction conflict: key written by concurrent commit");
+        }
+        value.Reset();
+        auto s = db->Get(rocksdb::ReadOptions(), db->DefaultColumnFamily(), read.key, &value);
+        if (s.IsNotFound()) {
+            if (read.exists) return Status::Again("Transaction conflict: key deleted");
+            continue;
+        }
+        if (!s.ok()) {
+            return Status::IO("Failed to validate transaction: " + s.ToString());
+        }
+        if (!read.exists || std::string_view(value.data(), value.size()) != read.value) {
+            return Status::Again("Transaction conflict: key modified");
+        }
+    }
+    return Status::Ok();
+}
+
+// CommitSync 的等待状态
+struct SyncRequest : GroupCommitter::Request {
+    std::mutex mu;
+    std::condition_variable cv;
+    bool done = false;
+
+    static void Complete(GroupCommitter::Request* r) {
+        auto* self = static_cast<SyncRequest*>(r);
+        std::lock_guard<std::mutex> lock(self->mu);
+        self->done = true;
+        self->cv.notify_one();
+    }
+};
+
+} // namespace
+
+GroupCommitter::GroupCommitter(rocksdb::DB* db, Options options, std::mutex* write_mutex)
+    : db_(db), options_(options), write_mutex_(write_mutex) {
+    options_.max_batch = std::max<uint32_t>(options_.max_batch, 1);
+    worker_ = std::thread([this] { Loop(); });
+}
+
+GroupCommitter::~GroupCommitter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool GroupCommitter::Enqueue(Request* r) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_) {
+            r->status = Status::IO("Group committer stopped");
+            return false;
+        }
+        queue_.push_back(r);
+    }
+    cv_.notify_one();
+    return true;
+}
+
+Status GroupCommitter::CommitSync(rocksdb::WriteBatch* batch,
+                                  const std::vector<ReadCheck>* reads) {
+    // 写线程上 (协程恢复后再提交) 排队会等待自己, 直接写入
+    if (std::this_thread::get_id() == worker_.get_id()) {
+        std::deque<Request*> group;
+        Request r;
+        r.batch = batch;
+        r.reads = reads;
+        group.push_back(&r);
+        WriteGroup(group);
+        return std::move(r.status);
+    }
+
+    SyncRequest r;
+    r.batch = batch;
+    r.reads = reads;
+    r.on_complete = &SyncRequest::Complete;
+    if (!Enqueue(&r)) {
+        return std::move(r.status);
+    }
+    std::unique_lock<std::mutex> lock(r.mu);
+    r.cv.wait(lock, [&r] { return r.done; });
+    return std::move(r.status);
+}
+
+GroupCommitter::Stats GroupCommitter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void GroupCommitter::Loop() {
+    std::deque<Request*> group;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return;  // 已停止且写完
+            if (options_.max_delay_us > 0 && !stop_ && queue_.size() < options_.max_batch) {
+                cv_.wait_for(lock, std::chrono::microseconds(options_.max_delay_us), [this] {
+                    return stop_ || queue_.size() >= options_.max_batch;
+                });
+            }
+            size_t n = std::min<size_t>(queue_.size(), options_.max_batch);
+            group.assign(queue_.begin(), queue_.begin() + n);
+            queue_.erase(queue_.begin(), queue_.begin() + n);
+        }
+        WriteGroup(group);
+        group.clear();
+    }
+}
+
+void GroupCommitter::WriteGroup(std::deque<Request*>& group) {
+    rocksdb::WriteOptions write_options;
+    write_options.sync = options_.sync;
+
+    // 有读集合时, 校验到写入完成期间与外部读-改-写互斥
+    bool validate = std::any_of(group.begin(), group.end(), [](const Request* r) {
+        return r->reads != nullptr && !r->reads->empty();
+    });
+    std::unique_lock<std::mutex> guard;
+    if (validate && write_mutex_ != nullptr) {
+        guard = std::unique_lock<std::mutex>(*write_mutex_);
+    }
+
+    rocksdb::WriteBatch merged;
+    rocksdb::WriteBatch* batch = &merged;
+    GroupWrites writes;
+    size_t members = 0;
+    for (auto* r : group) {
+        if (r->reads != nullptr && !r->reads->empty()) {
+            r->status = ValidateReads(db_, *r->reads, writes);
+            if (!r->status.OK()) {
+                r->batch = nullptr;
+                continue;
+            }
+        }
+
+        // 单个提交直接写入, 不做拷贝
+        if (group.size() == 1) {
+            batch = r->batch;
+            members = 1;
+            break;
+        }
+
+        BatchAppender appender(&merged, validate ? &writes : nullptr);
+        merged.SetSavePoint();
+        auto s = r->batch->Iterate(&appender);
+        if (!s.ok()) {
+            merged.RollbackToSavePoint();
+            r->status = Status::IO("Invalid write batch: " + s.ToString());
+            r->batch = nullptr;
+            continue;
+        }
+        merged.PopSavePoint();
+        ++members;
+    }
+
+    Status result;
+    if (members > 0) {
+        auto s = db_->Write(write_options, batch);
+        if (!s.ok()) {
+            LOG_ERROR("Group commit of %zu batches failed: %s", members, s.ToString().c_str());
+            result = Status::IO("Transaction commit failed: " + s.ToString());
+        }
+    }
+    // 完成回调会恢复协程, 其中可能再做读-改-写, 先放锁
+    if (guard.owns_lock()) guard.unlock();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.commits += group.size();
+        if (members > 0) ++stats_.groups;
+        stats_.max_group = std::max<uint64_t>(stats_.max_group, members);
+        for (auto* r : group) {
+            if (r->batch == nullptr && r->status.code() == ErrorCode::kAgain) {
+                ++stats_.conflicts;
+            } else if (r->batch == nullptr || !result.OK()) {
+                ++stats_.failures;
+            }
+        }
+    }
+
+    // 逐个完成; 回调可能恢复协程并在其中再次提交 (入队, 下一组处理)
+    for (auto* r : group) {
+        if (r->batch != nullptr) r->status = result;
+        if (r->on_complete) r->on_complete(r);
+    }
+}
+
+} // namespace nebulastore::metadata
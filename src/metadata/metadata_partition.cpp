@@ -20,9 +20,12 @@ MetaPartition::MetaPartition(const Config& config)
 MetaPartition::~MetaPartition() = default;
 
 Status MetaPartition::Init() {
-    auto store = std::make_unique<RocksDBStore>(
-        RocksDBStore::Config{config_.data_dir}
-    );
+    RocksDBStore::Config store_config;
+    store_config.db_path = config_.data_dir;
+    store_config.group_commit.max_batch = config_.batch_size;
+    store_config.group_commit.max_delay_us = config_.batch_max_delay_us;
+    store_config.group_commit.sync = config_.sync_wal;
+    auto store = std::make_unique<RocksDBStore>(store_config);
     auto status = store->Init();
     if (!status.OK()) {
         return status;
@@ -35,6 +38,17 @@ Status MetaPartition::Init() {
     return Status::Ok();
 }
 
+std::unique_ptr<MetadataStore::Transaction> MetaPartition::BeginTransaction() {
+    return store_ ? store_->BeginTransaction() : nullptr;
+}
+
+AsyncTask<Status> MetaPartition::Commit(MetadataStore::Transaction* txn) {
+    if (!txn) {
+        co_return Status::IO("Store not initialized");
+    }
+    co_return co_await txn->CommitAsync();
+}
+
 AsyncTask<Status> MetaPartition::Lookup(
     InodeID inode_id,
     InodeAttr* attr
@@ -71,7 +85,7 @@ AsyncTask<Status> MetaPartition::CreateDentry(
     if (!status.OK()) {
         co_return status;
     }
-    co_return txn->Commit();
+    co_return co_await txn->CommitAsync();
 }
 
 AsyncTask<Status> MetaPartition::CreateInode(
@@ -93,7 +107,7 @@ AsyncTask<Status> MetaPartition::CreateInode(
     if (!status.OK()) {
         co_return status;
     }
-    co_return txn->Commit();
+    co_return co_await txn->CommitAsync();
 }
 
 AsyncTask<Status> MetaPartition::DeleteDentry(
@@ -135,6 +149,86 @@ AsyncTask<Status> MetaPartition::ListDentries(
     co_return rocksdb_store->ListDentries(parent, entries);
 }
 
+AsyncTask<Status> MetaPartition::GetLayout(InodeID inode, FileLayout* layout) {
+    if (!store_) {
+        co_return Status::IO("Store not initialized");
+    }
+    co_return store_->LookupLayout(inode, layout);
+}
+
+AsyncTask<Status> MetaPartition::GetLayoutRange(
+    InodeID inode,
+    uint64_t offset,
+    uint64_t size,
+    FileLayout* layout
+) {
+    if (!store_) {
+        co_return Status::IO("Store not initialized");
+    }
+    auto* rocksdb_store = dynamic_cast<RocksDBStore*>(store_.get());
+    if (!rocksdb_store) {
+        co_return store_->LookupLayout(inode, layout);
+    }
+    co_return rocksdb_store->LookupLayoutRange(inode, offset, size, layout);
+}
+
+AsyncTask<Status> MetaPartition::GetChunkSize(InodeID inode, uint64_t* chunk_size) {
+    if (!store_) {
+        co_return Status::IO("Store not initialized");
+    }
+    auto* rocksdb_store = dynamic_cast<RocksDBStore*>(store_.get());
+    if (!rocksdb_store) {
+        FileLayout layout;
+        auto status = store_->LookupLayout(inode, &layout);
+        if (status.OK()) {
+            *chunk_size = layout.chunk_size;
+        }
+        co_return status;
+    }
+    co_return rocksdb_store->LookupChunkSize(inode, chunk_size);
+}
+
+AsyncTask<Status> MetaPartition::AppendSlices(
+    InodeID inode,
+    const std::vector<SliceInfo>& slices,
+    uint64_t min_size
+) {
+    if (!store_) {
+        co_return Status::IO("Store not initialized");
+    }
+    auto* rocksdb_store = dynamic_cast<RocksDBStore*>(store_.get());
+    if (!rocksdb_store) {
+        co_return Status::IO("Invalid store type");
+    }
+    co_return rocksdb_store->AppendSlices(inode, slices, min_size);
+}
+
+AsyncTask<Status> MetaPartition::SetSize(InodeID inode, uint64_t size) {
+    if (!store_) {
+        co_return Status::IO("Store not initialized");
+    }
+    auto* rocksdb_store = dynamic_cast<RocksDBStore*>(store_.get());
+    if (!rocksdb_store) {
+        co_return Status::IO("Invalid store type");
+    }
+    co_return rocksdb_store->SetSize(inode, size);
+}
+
+AsyncTask<Status> MetaPartition::ReplaceSlices(
+    InodeID inode,
+    const std::vector<SliceInfo>& expected,
+    const std::vector<SliceInfo>& replacement
+) {
+    if (!store_) {
+        co_return Status::IO("Store not initialized");
+    }
+    auto* rocksdb_store = dynamic_cast<RocksDBStore*>(store_.get());
+    if (!rocksdb_store) {
+        co_return Status::IO("Invalid store type");
+    }
+    co_return rocksdb_store->ReplaceSlices(inode, expected, replacement);
+}
+
 bool MetaPartition::ShouldSplit() const {
     return false;
 }
@@ -106,6 +106,95 @@ std::pair<std::string, std::string> SplitParentChild(const std::string& path) {
     return {path.substr(0, pos), path.substr(pos + 1)};
 }
 
+namespace {
+
+// 读集合冲突 (kAgain) 时重新读取并重试的次数上限
+constexpr int kMaxTxnRetries = 8;
+
+// 在事务中去掉 inode 的一个链接: 最后一个链接时删除 inode 及其布局, 否则 nlink 减一.
+// inode 已不存在 (孤儿 dentry) 时不做修改
+Status DropLink(MetadataStore::Transaction* txn, InodeID inode) {
+    InodeAttr attr;
+    auto status = txn->ReadInode(inode, &attr);
+    if (status.code() == ErrorCode::kNotFound) {
+        return Status::Ok();
+    }
+    if (!status.OK()) {
+        return status;
+    }
+    if (attr.nlink > 1) {
+        --attr.nlink;
+        attr.ctime = NowInSeconds();
+        return txn->UpdateInode(attr);
+    }
+    status = txn->DeleteInode(inode);
+    if (!status.OK()) {
+        return status;
+    }
+    return txn->DeleteLayout(inode);
+}
+
+// inode 与 dentry 不在同一分区时 (原子提交需要两阶段提交), dentry 提交后在 inode
+// 所在分区单独 DropLink: 中途失败只留下孤儿 inode, 不会有指向不存在 inode 的 dentry
+AsyncTask<Status> DropLinkIn(MetaPartition* partition, InodeID inode) {
+    Status status;
+    for (int attempt = 0; attempt < kMaxTxnRetries; ++attempt) {
+        auto txn = partition->BeginTransaction();
+        if (!txn) {
+            co_return Status::IO("Store not initialized");
+        }
+        status = DropLink(txn.get(), inode);
+        if (status.OK()) {
+            status = co_await partition->Commit(txn.get());
+        }
+        if (status.code() != ErrorCode::kAgain) {
+            co_return status;
+        }
+    }
+    co_return status;
+}
+
+// 源与目标目录在不同分区: 先建新 dentry 再删旧 dentry, 中途失败时文件同时出现在
+// 两处而不会丢失. 不支持覆盖已存在的目标
+AsyncTask<Status> RenameAcrossPartitions(
+    MetaPartition* src_partition, InodeID src_parent, const std::string& src_name,
+    MetaPartition* dst_partition, InodeID dst_parent, const std::string& dst_name
+) {
+    Dentry src;
+    auto status = co_await src_partition->LookupDentry(src_parent, src_name, &src);
+    if (!status.OK()) {
+        co_return Status::NotFound("Source not found");
+    }
+
+    for (int attempt = 0; attempt < kMaxTxnRetries; ++attempt) {
+        auto txn = dst_partition->BeginTransaction();
+        if (!txn) {
+            co_return Status::IO("Store not initialized");
+        }
+        Dentry dst;
+        status = txn->ReadDentry(dst_parent, dst_name, &dst);
+        if (status.OK()) {
+            co_return Status::Exist("Target exists in another partition");
+        }
+        if (status.code() != ErrorCode::kNotFound) {
+            co_return status;
+        }
+        status = txn->CreateDentry(dst_parent, dst_name, src.inode_id, src.type);
+        if (status.OK()) {
+            status = co_await dst_partition->Commit(txn.get());
+        }
+        if (status.code() != ErrorCode::kAgain) {
+            break;
+        }
+    }
+    if (!status.OK()) {
+        co_return status;
+    }
+    co_return co_await src_partition->DeleteDentry(src_parent, src_name);
+}
+
+} // namespace
+
 // === Create ===
 
 AsyncTask<Status> MetadataServiceImpl::Create(
@@ -126,31 +215,57 @@ AsyncTask<Status> MetadataServiceImpl::Create(
         co_return Status::NotFound("Parent directory not found");
     }
 
-    // 检查是否已存在
     auto partition = LocatePartition(parent_inode);
     if (!partition) {
         co_return Status::IO("No partition available");
     }
 
-    Dentry existing;
-    auto exist_status = co_await partition->LookupDentry(parent_inode, name, &existing);
-    if (exist_status.OK()) {
-        co_return Status::Exist("File already exists");
-    }
-
     // 分配新 inode
     auto new_inode = GenerateInodeID();
     auto target_partition = LocatePartition(new_inode);
+    auto file_type = mode.IsDirectory() ? FileType::kDirectory : FileType::kRegular;
 
-    // 创建 inode
-    auto create_status = co_await target_partition->CreateInode(new_inode, mode, uid, gid);
-    if (!create_status.OK()) {
-        co_return create_status;
+    if (target_partition != partition) {
+        // 跨分区 (原子提交需要两阶段提交): 先 inode 后 dentry 分两次提交,
+        // 中途失败只留下孤儿 inode
+        Dentry existing;
+        auto exist_status = co_await partition->LookupDentry(parent_inode, name, &existing);
+        if (exist_status.OK()) {
+            co_return Status::Exist("File already exists");
+        }
+        auto create_status = co_await target_partition->CreateInode(new_inode, mode, uid, gid);
+        if (!create_status.OK()) {
+            co_return create_status;
+        }
+        co_return co_await partition->CreateDentry(parent_inode, name, new_inode, file_type);
     }
 
-    // 创建 dentry
-    auto file_type = mode.IsDirectory() ? FileType::kDirectory : FileType::kRegular;
-    co_return co_await partition->CreateDentry(parent_inode, name, new_inode, file_type);
+    // inode 与 dentry 一次原子提交; 新 dentry 在读集合中, 并发同名创建只有一个成功
+    for (int attempt = 0; attempt < kMaxTxnRetries; ++attempt) {
+        auto txn = partition->BeginTransaction();
+        if (!txn) {
+            co_return Status::IO("Store not initialized");
+        }
+        Dentry existing;
+        status = txn->ReadDentry(parent_inode, name, &existing);
+        if (status.OK()) {
+            co_return Status::Exist("File already exists");
+        }
+        if (status.code() != ErrorCode::kNotFound) {
+            co_return status;
+        }
+        status = txn->CreateInode(new_inode, mode, uid, gid);
+        if (status.OK()) {
+            status = txn->CreateDentry(parent_inode, name, new_inode, file_type);
+        }
+        if (status.OK()) {
+            status = co_await partition->Commit(txn.get());
+        }
+        if (status.code() != ErrorCode::kAgain) {
+            co_return status;
+        }
+    }
+    co_return status;
 }
 
 // === GetAttr ===
@@ -191,13 +306,6 @@ AsyncTask<Status> MetadataServiceImpl::SetAttr(
         co_return Status::IO("No partition available");
     }
 
-    // 获取当前属性
-    InodeAttr current;
-    status = co_await partition->Lookup(inode_id, &current);
-    if (!status.OK()) {
-        co_return status;
-    }
-
     // 合并属性 (to_set 位掩码)
     constexpr uint32_t ATTR_MODE  = 1 << 0;
     constexpr uint32_t ATTR_UID   = 1 << 1;
@@ -205,16 +313,34 @@ AsyncTask<Status> MetadataServiceImpl::SetAttr(
     constexpr uint32_t ATTR_SIZE  = 1 << 3;
     constexpr uint32_t ATTR_MTIME = 1 << 4;
 
-    if (to_set & ATTR_MODE)  current.mode = attr.mode;
-    if (to_set & ATTR_UID)   current.uid = attr.uid;
-    if (to_set & ATTR_GID)   current.gid = attr.gid;
-    if (to_set & ATTR_SIZE)  current.size = attr.size;
-    if (to_set & ATTR_MTIME) current.mtime = attr.mtime;
+    // 读-改-写在一个事务中, 与并发修改 (如写入提升大小) 冲突时重新读取
+    for (int attempt = 0; attempt < kMaxTxnRetries; ++attempt) {
+        auto txn = partition->BeginTransaction();
+        if (!txn) {
+            co_return Status::IO("Store not initialized");
+        }
+        InodeAttr current;
+        status = txn->ReadInode(inode_id, &current);
+        if (!status.OK()) {
+            co_return status;
+        }
 
-    // 更新 inode (重新创建)
-    co_return co_await partition->CreateInode(
-        current.inode_id, current.mode, current.uid, current.gid
-    );
+        if (to_set & ATTR_MODE)  current.mode = attr.mode;
+        if (to_set & ATTR_UID)   current.uid = attr.uid;
+        if (to_set & ATTR_GID)   current.gid = attr.gid;
+        if (to_set & ATTR_SIZE)  current.size = attr.size;
+        if (to_set & ATTR_MTIME) current.mtime = attr.mtime;
+        current.ctime = NowInSeconds();
+
+        status = txn->UpdateInode(current);
+        if (status.OK()) {
+            status = co_await partition->Commit(txn.get());
+        }
+        if (status.code() != ErrorCode::kAgain) {
+            co_return status;
+        }
+    }
+    co_return status;
 }
 
 // === Mkdir ===
@@ -250,21 +376,43 @@ AsyncTask<Status> MetadataServiceImpl::Unlink(const std::string& path) {
         co_return Status::IO("No partition available");
     }
 
-    // 查找目标文件
-    Dentry dentry;
-    status = co_await partition->LookupDentry(parent_inode, name, &dentry);
-    if (!status.OK()) {
-        co_return Status::NotFound("File not found");
-    }
+    // 删除 dentry 与更新 inode 链接数一次原子提交
+    for (int attempt = 0; attempt < kMaxTxnRetries; ++attempt) {
+        auto txn = partition->BeginTransaction();
+        if (!txn) {
+            co_return Status::IO("Store not initialized");
+        }
+        Dentry dentry;
+        status = txn->ReadDentry(parent_inode, name, &dentry);
+        if (status.code() == ErrorCode::kNotFound) {
+            co_return Status::NotFound("File not found");
+        }
+        if (!status.OK()) {
+            co_return status;
+        }
 
-    // 检查不是目录
-    if (dentry.type == FileType::kDirectory) {
-        co_return Status::InvalidArgument("Cannot unlink directory, use rmdir");
-    }
+        // 检查不是目录
+        if (dentry.type == FileType::kDirectory) {
+            co_return Status::InvalidArgument("Cannot unlink directory, use rmdir");
+        }
 
-    // 删除 dentry (需要扩展 MetaPartition)
-    // TODO: 实现 DeleteDentry
-    co_return Status::Ok();
+        auto inode_partition = LocatePartition(dentry.inode_id);
+        status = txn->DeleteDentry(parent_inode, name);
+        if (status.OK() && inode_partition == partition) {
+            status = DropLink(txn.get(), dentry.inode_id);
+        }
+        if (status.OK()) {
+            status = co_await partition->Commit(txn.get());
+        }
+        if (status.code() == ErrorCode::kAgain) {
+            continue;
+        }
+        if (!status.OK() || inode_partition == partition) {
+            co_return status;
+        }
+        co_return co_await DropLinkIn(inode_partition, dentry.inode_id);
+    }
+    co_return status;
 }
 
 // === Rmdir ===
@@ -287,21 +435,54 @@ AsyncTask<Status> MetadataServiceImpl::Rmdir(const std::string& path) {
         co_return Status::IO("No partition available");
     }
 
-    // 查找目标目录
-    Dentry dentry;
-    status = co_await partition->LookupDentry(parent_inode, name, &dentry);
-    if (!status.OK()) {
-        co_return Status::NotFound("Directory not found");
-    }
+    // 删除 dentry 与目录 inode 一次原子提交. 目录为空的检查不在读集合中,
+    // 与目录内的并发创建竞争时新建项可能成为孤儿 (需要范围校验或子项计数)
+    for (int attempt = 0; attempt < kMaxTxnRetries; ++attempt) {
+        auto txn = partition->BeginTransaction();
+        if (!txn) {
+            co_return Status::IO("Store not initialized");
+        }
+        Dentry dentry;
+        status = txn->ReadDentry(parent_inode, name, &dentry);
+        if (status.code() == ErrorCode::kNotFound) {
+            co_return Status::NotFound("Directory not found");
+        }
+        if (!status.OK()) {
+            co_return status;
+        }
 
-    // 检查是目录
-    if (dentry.type != FileType::kDirectory) {
-        co_return Status::NotDirectory("Not a directory");
-    }
+        // 检查是目录
+        if (dentry.type != FileType::kDirectory) {
+            co_return Status::NotDirectory("Not a directory");
+        }
 
-    // TODO: 检查目录是否为空
-    // TODO: 实现 DeleteDentry
-    co_return Status::Ok();
+        // 子项 dentry 在目录 inode 所在分区
+        auto dir_partition = LocatePartition(dentry.inode_id);
+        std::vector<Dentry> children;
+        status = co_await dir_partition->ListDentries(dentry.inode_id, &children);
+        if (!status.OK()) {
+            co_return status;
+        }
+        if (!children.empty()) {
+            co_return Status::Exist("Directory not empty");
+        }
+
+        status = txn->DeleteDentry(parent_inode, name);
+        if (status.OK() && dir_partition == partition) {
+            status = txn->DeleteInode(dentry.inode_id);
+        }
+        if (status.OK()) {
+            status = co_await partition->Commit(txn.get());
+        }
+        if (status.code() == ErrorCode::kAgain) {
+            continue;
+        }
+        if (!status.OK() || dir_partition == partition) {
+            co_return status;
+        }
+        co_return co_await dir_partition->DeleteInode(dentry.inode_id);
+    }
+    co_return status;
 }
 
 // === Rename ===
@@ -317,6 +498,11 @@ AsyncTask<Status> MetadataServiceImpl::Rename(
         co_return Status::InvalidArgument("Cannot rename root");
     }
 
+    // 目录不能移动到自己的子树下
+    if (new_parent == oldpath || new_parent.starts_with(oldpath + "/")) {
+        co_return Status::InvalidArgument("Cannot move a directory into itself");
+    }
+
     // 查找源父目录
     InodeID old_parent_inode;
     auto status = co_await LookupPath(old_parent, &old_parent_inode);
@@ -332,28 +518,77 @@ AsyncTask<Status> MetadataServiceImpl::Rename(
     }
 
     auto partition = LocatePartition(old_parent_inode);
-    if (!partition) {
+    auto new_partition = LocatePartition(new_parent_inode);
+    if (!partition || !new_partition) {
         co_return Status::IO("No partition available");
     }
-
-    // 查找源文件
-    Dentry src_dentry;
-    status = co_await partition->LookupDentry(old_parent_inode, old_name, &src_dentry);
-    if (!status.OK()) {
-        co_return Status::NotFound("Source not found");
+    if (new_partition != partition) {
+        co_return co_await RenameAcrossPartitions(partition, old_parent_inode, old_name,
+                                                  new_partition, new_parent_inode, new_name);
     }
 
-    // 创建新 dentry
-    auto new_partition = LocatePartition(new_parent_inode);
-    status = co_await new_partition->CreateDentry(
-        new_parent_inode, new_name, src_dentry.inode_id, src_dentry.type
-    );
-    if (!status.OK()) {
-        co_return status;
-    }
+    // 删除旧 dentry、写入新 dentry (覆盖目标时连同目标 inode 的链接数) 一次原子提交
+    for (int attempt = 0; attempt < kMaxTxnRetries; ++attempt) {
+        auto txn = partition->BeginTransaction();
+        if (!txn) {
+            co_return Status::IO("Store not initialized");
+        }
+        Dentry src;
+        status = txn->ReadDentry(old_parent_inode, old_name, &src);
+        if (status.code() == ErrorCode::kNotFound) {
+            co_return Status::NotFound("Source not found");
+        }
+        if (!status.OK()) {
+            co_return status;
+        }
+        if (old_parent_inode == new_parent_inode && old_name == new_name) {
+            co_return Status::Ok();
+        }
 
-    // TODO: 删除旧 dentry
-    co_return Status::Ok();
+        // 目标已存在: 文件被替换, 去掉其 inode 的一个链接; 目录覆盖目录需检查
+        // 目标为空, 暂不支持
+        Dentry dst;
+        MetaPartition* replaced_partition = nullptr;
+        status = txn->ReadDentry(new_parent_inode, new_name, &dst);
+        if (status.OK()) {
+            if (dst.inode_id == src.inode_id) {
+                co_return Status::Ok();     // 同一 inode 的两个链接, 不做修改
+            }
+            if (dst.type == FileType::kDirectory) {
+                co_return src.type == FileType::kDirectory
+                    ? Status::Exist("Target directory exists")
+                    : Status(ErrorCode::kIsDirectory, "Target is a directory");
+            }
+            if (src.type == FileType::kDirectory) {
+                co_return Status::NotDirectory("Target is not a directory");
+            }
+            replaced_partition = LocatePartition(dst.inode_id);
+            if (replaced_partition == partition) {
+                status = DropLink(txn.get(), dst.inode_id);
+            }
+        } else if (status.code() == ErrorCode::kNotFound) {
+            status = Status::Ok();
+        }
+
+        // 新 dentry 直接覆盖目标 dentry
+        if (status.OK()) {
+            status = txn->DeleteDentry(old_parent_inode, old_name);
+        }
+        if (status.OK()) {
+            status = txn->CreateDentry(new_parent_inode, new_name, src.inode_id, src.type);
+        }
+        if (status.OK()) {
+            status = co_await partition->Commit(txn.get());
+        }
+        if (status.code() == ErrorCode::kAgain) {
+            continue;
+        }
+        if (!status.OK() || replaced_partition == nullptr || replaced_partition == partition) {
+            co_return status;
+        }
+        co_return co_await DropLinkIn(replaced_partition, dst.inode_id);
+    }
+    co_return status;
 }
 
 // === Readdir ===
@@ -400,13 +635,31 @@ AsyncTask<Status> MetadataServiceImpl::GetLayout(
     if (!partition) {
         co_return Status::IO("No partition available");
     }
+    co_return co_await partition->GetLayout(inode, layout);
+}
 
-    // 直接从 store 获取 layout
-    // 需要访问 partition 的 store_
-    layout->inode_id = inode;
-    layout->chunk_size = 4 * 1024 * 1024;  // 4MB default
-    layout->slices.clear();
-    co_return Status::Ok();
+AsyncTask<Status> MetadataServiceImpl::GetLayoutRange(
+    InodeID inode,
+    uint64_t offset,
+    uint64_t size,
+    FileLayout* layout
+) {
+    auto partition = LocatePartition(inode);
+    if (!partition) {
+        co_return Status::IO("No partition available");
+    }
+    co_return co_await partition->GetLayoutRange(inode, offset, size, layout);
+}
+
+AsyncTask<Status> MetadataServiceImpl::GetChunkSize(
+    InodeID inode,
+    uint64_t* chunk_size
+) {
+    auto partition = LocatePartition(inode);
+    if (!partition) {
+        co_return Status::IO("No partition available");
+    }
+    co_return co_await partition->GetChunkSize(inode, chunk_size);
 }
 
 // === AddSlice ===
@@ -419,38 +672,50 @@ AsyncTask<Status> MetadataServiceImpl::AddSlice(
     if (!partition) {
         co_return Status::IO("No partition available");
     }
-
-    // TODO: 获取现有 layout，添加 slice，保存
-    (void)slice;
-    co_return Status::Ok();
+    // 大小由 UpdateSize/AddSlices 维护, 这里只追加布局
+    std::vector<SliceInfo> slices{slice};
+    co_return co_await partition->AppendSlices(inode, slices, 0);
 }
 
-// === UpdateSize ===
+// === AddSlices ===
 
-AsyncTask<Status> MetadataServiceImpl::UpdateSize(
+AsyncTask<Status> MetadataServiceImpl::AddSlices(
     InodeID inode,
-    uint64_t new_size
+    const std::vector<SliceInfo>& slices,
+    uint64_t min_size
 ) {
     auto partition = LocatePartition(inode);
     if (!partition) {
         co_return Status::IO("No partition available");
     }
+    co_return co_await partition->AppendSlices(inode, slices, min_size);
+}
 
-    // 获取当前属性
-    InodeAttr attr;
-    auto status = co_await partition->Lookup(inode, &attr);
-    if (!status.OK()) {
-        co_return status;
+// === ReplaceSlices ===
+
+AsyncTask<Status> MetadataServiceImpl::ReplaceSlices(
+    InodeID inode,
+    const std::vector<SliceInfo>& expected,
+    const std::vector<SliceInfo>& replacement
+) {
+    auto partition = LocatePartition(inode);
+    if (!partition) {
+        co_return Status::IO("No partition available");
     }
+    co_return co_await partition->ReplaceSlices(inode, expected, replacement);
+}
 
-    // 更新大小
-    attr.size = new_size;
-    attr.mtime = NowInSeconds();
+// === UpdateSize ===
 
-    // 重新写入
-    co_return co_await partition->CreateInode(
-        attr.inode_id, attr.mode, attr.uid, attr.gid
-    );
+AsyncTask<Status> MetadataServiceImpl::UpdateSize(
+    InodeID inode,
+    uint64_t new_size
+) {
+    auto partition = LocatePartition(inode);
+    if (!partition) {
+        co_return Status::IO("No partition available");
+    }
+    co_return co_await partition->SetSize(inode, new_size);
 }
 
 } // namespace nebulastore::metadata
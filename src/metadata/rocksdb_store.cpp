@@ -4,11 +4,93 @@
 // ================================
 
 #include "nebulastore/metadata/rocksdb_store.h"
+#include "nebulastore/metadata/value_codec.h"
 #include "nebulastore/common/logger.h"
+#include <rocksdb/merge_operator.h>
+#include <algorithm>
 #include <cstring>
+#include <map>
 
 namespace nebulastore::metadata {
 
+namespace {
+
+// 布局头 value: ver | chunk_size | next_seq
+std::string EncodeLayoutHeader(uint64_t chunk_size, uint64_t next_seq) {
+    std::string value;
+    value.push_back(static_cast<char>(kValueFormatV2));
+    codec::PutVarint64(&value, chunk_size);
+    codec::PutVarint64(&value, next_seq);
+    return value;
+}
+
+// chunk key 末尾 8 字节为大端 chunk 下标
+uint64_t DecodeChunkIndex(const rocksdb::Slice& key) {
+    uint64_t idx = 0;
+    for (size_t i = key.size() - 8; i < key.size(); ++i) {
+        idx = (idx << 8) | static_cast<uint8_t>(key[i]);
+    }
+    return idx;
+}
+
+// 前缀的后继: 以 prefix 开头的 key 都小于它
+std::string PrefixSuccessor(std::string prefix) {
+    while (!prefix.empty()) {
+        auto& last = reinterpret_cast<unsigned char&>(prefix.back());
+        if (last != 0xFF) {
+            ++last;
+            return prefix;
+        }
+        prefix.pop_back();
+    }
+    return prefix;
+}
+
+// 点查 value: 借用线程内复用的 PinnableSlice. value 在 memtable 中时 RocksDB 会拷贝到
+// 它自带的缓冲, 复用后容量保留, 不再分配; 析构时 Reset 释放对 block cache 的 pin.
+// 同一线程内不可嵌套使用
+class PointRead {
+public:
+    PointRead() : value_(Slot()) {}
+    ~PointRead() { value_.Reset(); }
+
+    PointRead(const PointRead&) = delete;
+    PointRead& operator=(const PointRead&) = delete;
+
+    rocksdb::PinnableSlice* value() { return &value_; }
+    std::string_view view() const { return std::string_view(value_.data(), value_.size()); }
+
+private:
+    static rocksdb::PinnableSlice& Slot() {
+        thread_local rocksdb::PinnableSlice slot;
+        return slot;
+    }
+
+    rocksdb::PinnableSlice& value_;
+};
+
+// chunk 的 slice 列表追加: 记录首尾相接, 合并即拼接
+class SliceListAppendOperator : public rocksdb::AssociativeMergeOperator {
+public:
+    bool Merge(const rocksdb::Slice& key, const rocksdb::Slice* existing_value,
+               const rocksdb::Slice& value, std::string* new_value,
+               rocksdb::Logger* logger) const override {
+        (void)key;
+        (void)logger;
+        new_value->clear();
+        if (existing_value) {
+            new_value->reserve(existing_value->size() + value.size());
+            new_value->append(existing_value->data(), existing_value->size());
+        }
+        new_value->append(value.data(), value.size());
+        return true;
+    }
+
+    const char* Name() const override { return "nebulastore.SliceListAppend"; }
+};
+
+} // namespace
+
 // ================================
 // RocksDBStore
 // ================================
@@ -17,6 +99,7 @@ RocksDBStore::RocksDBStore(const Config& config)
     : config_(config), db_(nullptr) {}
 
 RocksDBStore::~RocksDBStore() {
+    committer_.reset();
     if (db_) {
         delete db_;
         db_ = nullptr;
@@ -28,6 +111,7 @@ Status RocksDBStore::Init() {
     options.create_if_missing = config_.create_if_missing;
     options.OptimizeLevelStyleCompaction();
     options.IncreaseParallelism(4);
+    options.merge_operator = std::make_shared<SliceListAppendOperator>();
 
     // RocksDB 9.x 简化配置 - 使用默认 table factory
     // 如果需要自定义缓存，可以设置 options.env->SetBackgroundThreads()
@@ -40,6 +124,7 @@ Status RocksDBStore::Init() {
     }
 
     options_ = options;
+    committer_ = std::make_unique<GroupCommitter>(db_, config_.group_commit, &update_mutex_);
     LOG_INFO("RocksDB initialized: %s", config_.db_path.c_str());
     return Status::Ok();
 }
@@ -54,9 +139,11 @@ Status RocksDBStore::LookupDentry(
     const std::string& name,
     Dentry* dentry
 ) {
-    auto key = EncodeDentryKey(parent, name);
-    std::string value;
-    auto status = db_->Get(rocksdb::ReadOptions(), key, &value);
+    KeyBuffer key;
+    EncodeDentryKey(parent, name, &key);
+    PointRead read;
+    auto status = db_->Get(rocksdb::ReadOptions(), db_->DefaultColumnFamily(),
+                           rocksdb::Slice(key.data(), key.size()), read.value());
 
     if (status.IsNotFound()) {
         return Status::NotFound("Dentry not found: " + name);
@@ -66,7 +153,11 @@ Status RocksDBStore::LookupDentry(
         return Status::IO("Failed to lookup dentry: " + status.ToString());
     }
 
-    *dentry = DecodeDentryValue(value);
+    // 直接从 block cache 内存解码
+    if (!metadata::DecodeDentryValue(read.view(), dentry)) {
+        return Status::IO("Corrupted dentry: " + name);
+    }
+    dentry->name = name;
     return Status::Ok();
 }
 
@@ -74,9 +165,11 @@ Status RocksDBStore::LookupInode(
     InodeID inode,
     InodeAttr* attr
 ) {
-    auto key = EncodeInodeKey(inode);
-    std::string value;
-    auto status = db_->Get(rocksdb::ReadOptions(), key, &value);
+    KeyBuffer key;
+    EncodeInodeKey(inode, &key);
+    PointRead read;
+    auto status = db_->Get(rocksdb::ReadOptions(), db_->DefaultColumnFamily(),
+                           rocksdb::Slice(key.data(), key.size()), read.value());
 
     if (status.IsNotFound()) {
         return Status::NotFound("Inode not found: " + std::to_string(inode));
@@ -86,7 +179,9 @@ Status RocksDBStore::LookupInode(
         return Status::IO("Failed to lookup inode: " + status.ToString());
     }
 
-    *attr = DecodeInodeValue(value);
+    if (!metadata::DecodeInodeValue(read.view(), attr)) {
+        return Status::IO("Corrupted inode: " + std::to_string(inode));
+    }
     return Status::Ok();
 }
 
@@ -94,328 +189,328 @@ Status RocksDBStore::LookupLayout(
     InodeID inode,
     FileLayout* layout
 ) {
-    auto key = EncodeLayoutKey(inode);
-    std::string value;
-    auto status = db_->Get(rocksdb::ReadOptions(), key, &value);
-
-    if (status.IsNotFound()) {
-        // 没有布局是正常的（新文件）
-        layout->inode_id = inode;
-        layout->chunk_size = 4 * 1024 * 1024;  // 默认 4MB
-        layout->slices.clear();
-        return Status::Ok();
+    // 没有布局是正常的（新文件）, 此时头取默认值且没有 chunk
+    LayoutHeader header;
+    auto status = LookupLayoutHeader(inode, &header);
+    if (!status.OK()) {
+        return status;
     }
-    if (!status.ok()) {
-        LOG_ERROR("Failed to lookup layout: %s", status.ToString().c_str());
-        return Status::IO("Failed to lookup layout: " + status.ToString());
+
+    std::vector<SliceRecord> records = std::move(header.legacy);
+    status = ScanLayoutChunks(inode, header.chunk_size, EncodeLayoutChunkKey(inode, 0),
+                              PrefixSuccessor(EncodeLayoutKey(inode)), &records);
+    if (!status.OK()) {
+        return status;
     }
 
-    *layout = DecodeLayoutValue(value);
+    FillLayout(inode, header, &records, layout);
     return Status::Ok();
 }
 
-// ================================
-// Key 编码 (public for RocksDBTransaction)
-// ================================
-
-std::string RocksDBStore::EncodeDentryKey(InodeID parent, const std::string& name) {
-    // 格式: "D" + parent(8字节小端) + "/" + name
-    std::string key;
-    key.reserve(1 + 8 + 1 + name.size());
-    key.push_back('D');
-
-    // 小端序写入 parent inode
-    for (int i = 0; i < 8; ++i) {
-        key.push_back((parent >> (i * 8)) & 0xFF);
+Status RocksDBStore::LookupLayoutRange(
+    InodeID inode,
+    uint64_t offset,
+    uint64_t size,
+    FileLayout* layout
+) {
+    LayoutHeader header;
+    auto status = LookupLayoutHeader(inode, &header);
+    if (!status.OK()) {
+        return status;
+    }
+
+    uint64_t first = offset / header.chunk_size;
+    uint64_t last = (size == 0 ? offset : offset + std::min(size, UINT64_MAX - offset) - 1) /
+                    header.chunk_size;
+    std::string end = last == UINT64_MAX ? PrefixSuccessor(EncodeLayoutKey(inode))
+                                         : EncodeLayoutChunkKey(inode, last + 1);
+    // v1 布局整份返回, 多出范围的 slice 不影响读取
+    std::vector<SliceRecord> records = std::move(header.legacy);
+    status = ScanLayoutChunks(inode, header.chunk_size, EncodeLayoutChunkKey(inode, first), end,
+                              &records);
+    if (!status.OK()) {
+        return status;
+    }
+
+    // 文件最后一个 chunk 在范围之后时一并读取, 否则读取方会把范围内的末尾当成 EOF
+    if (last != UINT64_MAX) {
+        std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+        it->SeekForPrev(EncodeLayoutChunkKey(inode, UINT64_MAX));
+        if (it->Valid() && it->key().size() == end.size() && it->key().compare(end) >= 0 &&
+            it->key().starts_with(EncodeLayoutKey(inode))) {
+            std::string tail = it->key().ToString();
+            status = ScanLayoutChunks(inode, header.chunk_size, tail, PrefixSuccessor(tail),
+                                      &records);
+            if (!status.OK()) {
+                return status;
+            }
+        } else if (!it->status().ok()) {
+            return Status::IO("Failed to lookup layout: " + it->status().ToString());
+        }
     }
 
-    key.push_back('/');
-    key.append(name);
-    return key;
+    FillLayout(inode, header, &records, layout);
+    return Status::Ok();
 }
 
-std::string RocksDBStore::EncodeInodeKey(InodeID inode) {
-    // 格式: "I" + inode_id(8字节小端)
-    std::string key;
-    key.reserve(9);
-    key.push_back('I');
-
-    for (int i = 0; i < 8; ++i) {
-        key.push_back((inode >> (i * 8)) & 0xFF);
+Status RocksDBStore::LookupChunkSize(InodeID inode, uint64_t* chunk_size) {
+    LayoutHeader header;
+    auto status = LookupLayoutHeader(inode, &header);
+    if (status.OK()) {
+        *chunk_size = header.chunk_size;
     }
-    return key;
+    return status;
 }
 
-std::string RocksDBStore::EncodeLayoutKey(InodeID inode) {
-    // 格式: "L" + inode_id(8字节小端)
-    std::string key;
-    key.reserve(9);
-    key.push_back('L');
-
-    for (int i = 0; i < 8; ++i) {
-        key.push_back((inode >> (i * 8)) & 0xFF);
-    }
-    return key;
-}
-
-// ================================
-// Value 编码 (public for RocksDBTransaction)
-// ================================
-
-// Dentry Value: inode_id(8) + type(4)
-std::string RocksDBStore::EncodeDentryValue(const Dentry& dentry) {
-    std::string value;
-    value.reserve(12);
-
-    // inode_id (8 bytes, little endian)
-    for (int i = 0; i < 8; ++i) {
-        value.push_back((dentry.inode_id >> (i * 8)) & 0xFF);
+Status RocksDBStore::LookupLayoutHeader(InodeID inode, LayoutHeader* header) {
+    KeyBuffer key;
+    EncodeLayoutKey(inode, &key);
+    PointRead read;
+    auto status = db_->Get(rocksdb::ReadOptions(), db_->DefaultColumnFamily(),
+                           rocksdb::Slice(key.data(), key.size()), read.value());
+    if (status.IsNotFound()) {
+        *header = LayoutHeader{};
+        return Status::Ok();
     }
-
-    // type (4 bytes)
-    uint32_t type = static_cast<uint32_t>(dentry.type);
-    for (int i = 0; i < 4; ++i) {
-        value.push_back((type >> (i * 8)) & 0xFF);
+    if (!status.ok()) {
+        LOG_ERROR("Failed to lookup layout: %s", status.ToString().c_str());
+        return Status::IO("Failed to lookup layout: " + status.ToString());
     }
-
-    return value;
+    return DecodeLayoutHeader(read.view(), inode, header);
 }
 
-Dentry RocksDBStore::DecodeDentryValue(const std::string& value) {
-    Dentry dentry;
-
-    if (value.size() < 12) {
-        LOG_ERROR("Invalid dentry value size: %zu", value.size());
-        return dentry;
+Status RocksDBStore::DecodeLayoutHeader(std::string_view value, InodeID inode,
+                                        LayoutHeader* header) {
+    header->legacy.clear();
+    codec::Reader reader(value);
+    uint8_t version;
+    if (reader.GetByte(&version) && version == kValueFormatV2 &&
+        reader.GetVarint64(&header->chunk_size) && reader.GetVarint64(&header->next_seq) &&
+        reader.empty() && header->chunk_size != 0) {
+        return Status::Ok();
     }
 
-    // inode_id
-    dentry.inode_id = 0;
-    for (int i = 0; i < 8; ++i) {
-        dentry.inode_id |= (static_cast<uint8_t>(value[i]) << (i * 8));
+    // v1: 整份布局, 这时还没有 chunk key
+    FileLayout layout;
+    if (!DecodeLayoutValueV1(value, &layout) || layout.chunk_size == 0) {
+        return Status::IO("Corrupted layout header of inode " + std::to_string(inode));
     }
-
-    // type
-    uint32_t type = 0;
-    for (int i = 0; i < 4; ++i) {
-        type |= (static_cast<uint8_t>(value[8 + i]) << (i * 8));
+    header->chunk_size = layout.chunk_size;
+    header->next_seq = layout.slices.size();
+    header->legacy.reserve(layout.slices.size());
+    for (auto& slice : layout.slices) {
+        header->legacy.push_back({header->legacy.size(), std::move(slice)});
     }
-    dentry.type = static_cast<FileType>(type);
-
-    return dentry;
+    return Status::Ok();
 }
 
-// Inode Value: inode_id(8) + mode(4) + uid(4) + gid(4) + size(8) + mtime(8) + ctime(8) + nlink(8)
-std::string RocksDBStore::EncodeInodeValue(const InodeAttr& inode) {
-    std::string value;
-    value.reserve(52);
+Status RocksDBStore::ReadForUpdate(std::string key,
+                                   std::vector<GroupCommitter::ReadCheck>* reads) {
+    GroupCommitter::ReadCheck check;
+    auto status = db_->Get(rocksdb::ReadOptions(), key, &check.value);
+    if (!status.ok() && !status.IsNotFound()) {
+        LOG_ERROR("Failed to read for update: %s", status.ToString().c_str());
+        return Status::IO("Failed to read for update: " + status.ToString());
+    }
+    check.exists = status.ok();
+    check.key = std::move(key);
+    reads->push_back(std::move(check));
+    return Status::Ok();
+}
 
-    // inode_id (8 bytes)
-    for (int i = 0; i < 8; ++i) {
-        value.push_back((inode.inode_id >> (i * 8)) & 0xFF);
+Status RocksDBStore::ReadInodeForUpdate(InodeID inode, InodeAttr* attr,
+                                        std::vector<GroupCommitter::ReadCheck>* reads) {
+    auto status = ReadForUpdate(EncodeInodeKey(inode), reads);
+    if (!status.OK()) {
+        return status;
     }
-
-    // mode (4 bytes)
-    for (int i = 0; i < 4; ++i) {
-        value.push_back((inode.mode.mode >> (i * 8)) & 0xFF);
+    if (!reads->back().exists) {
+        return Status::NotFound("Inode not found: " + std::to_string(inode));
     }
-
-    // uid (4 bytes)
-    for (int i = 0; i < 4; ++i) {
-        value.push_back((inode.uid >> (i * 8)) & 0xFF);
+    if (!metadata::DecodeInodeValue(reads->back().value, attr)) {
+        return Status::IO("Corrupted inode: " + std::to_string(inode));
     }
+    return Status::Ok();
+}
 
-    // gid (4 bytes)
-    for (int i = 0; i < 4; ++i) {
-        value.push_back((inode.gid >> (i * 8)) & 0xFF);
+Status RocksDBStore::ReadLayoutHeaderForUpdate(InodeID inode, LayoutHeader* header,
+                                               std::vector<GroupCommitter::ReadCheck>* reads) {
+    // 每次布局变更都会改写或删除布局头, 校验它即可覆盖所有 chunk
+    auto status = ReadForUpdate(EncodeLayoutKey(inode), reads);
+    if (!status.OK()) {
+        return status;
     }
-
-    // size (8 bytes)
-    for (int i = 0; i < 8; ++i) {
-        value.push_back((inode.size >> (i * 8)) & 0xFF);
+    if (!reads->back().exists) {
+        *header = LayoutHeader{};
+        return Status::Ok();
     }
+    return DecodeLayoutHeader(reads->back().value, inode, header);
+}
 
-    // mtime (8 bytes)
-    for (int i = 0; i < 8; ++i) {
-        value.push_back((inode.mtime >> (i * 8)) & 0xFF);
-    }
+Status RocksDBStore::ScanLayoutChunks(
+    InodeID inode,
+    uint64_t chunk_size,
+    const std::string& begin,
+    const std::string& end,
+    std::vector<SliceRecord>* records,
+    std::vector<std::string>* keys
+) {
+    rocksdb::Slice upper(end);
+    rocksdb::ReadOptions read_options;
+    read_options.iterate_upper_bound = &upper;
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(read_options));
 
-    // ctime (8 bytes)
-    for (int i = 0; i < 8; ++i) {
-        value.push_back((inode.ctime >> (i * 8)) & 0xFF);
+    for (it->Seek(begin); it->Valid(); it->Next()) {
+        // 记录: seq | slice, offset 相对 chunk 起点
+        uint64_t base = DecodeChunkIndex(it->key()) * chunk_size;
+        codec::Reader reader(it->value().ToStringView());
+        while (!reader.empty()) {
+            SliceRecord r;
+            if (!reader.GetVarint64(&r.seq) ||
+                !DecodeSliceRecord(&reader, inode, base, &r.slice)) {
+                return Status::IO("Corrupted layout chunk of inode " + std::to_string(inode));
+            }
+            records->push_back(std::move(r));
+        }
+        if (keys) {
+            keys->push_back(it->key().ToString());
+        }
     }
-
-    // nlink (8 bytes)
-    for (int i = 0; i < 8; ++i) {
-        value.push_back((inode.nlink >> (i * 8)) & 0xFF);
+    if (!it->status().ok()) {
+        LOG_ERROR("Iterator error: %s", it->status().ToString().c_str());
+        return Status::IO("Failed to lookup layout: " + it->status().ToString());
     }
 
-    return value;
+    return Status::Ok();
 }
 
-InodeAttr RocksDBStore::DecodeInodeValue(const std::string& value) {
-    InodeAttr attr{};
-
-    if (value.size() < 52) {
-        LOG_ERROR("Invalid inode value size: %zu", value.size());
-        return attr;
-    }
-
-    size_t pos = 0;
-
-    // inode_id
-    attr.inode_id = 0;
-    for (int i = 0; i < 8; ++i, ++pos) {
-        attr.inode_id |= (static_cast<uint8_t>(value[pos]) << (i * 8));
-    }
-
-    // mode
-    attr.mode.mode = 0;
-    for (int i = 0; i < 4; ++i, ++pos) {
-        attr.mode.mode |= (static_cast<uint8_t>(value[pos]) << (i * 8));
+void RocksDBStore::FillLayout(
+    InodeID inode,
+    const LayoutHeader& header,
+    std::vector<SliceRecord>* records,
+    FileLayout* layout
+) {
+    // 跨 chunk 的 slice 会重复出现: 按提交序号排序去重, 还原写入顺序
+    std::sort(records->begin(), records->end(),
+              [](const SliceRecord& a, const SliceRecord& b) { return a.seq < b.seq; });
+    records->erase(std::unique(records->begin(), records->end(),
+                               [](const SliceRecord& a, const SliceRecord& b) { return a.seq == b.seq; }),
+                   records->end());
+
+    layout->inode_id = inode;
+    layout->chunk_size = header.chunk_size;
+    layout->slices.clear();
+    layout->slices.reserve(records->size());
+    for (auto& r : *records) {
+        layout->slices.push_back(std::move(r.slice));
     }
+}
 
-    // uid
-    attr.uid = 0;
-    for (int i = 0; i < 4; ++i, ++pos) {
-        attr.uid |= (static_cast<uint8_t>(value[pos]) << (i * 8));
+void RocksDBStore::AppendLayoutRecords(
+    InodeID inode,
+    uint64_t chunk_size,
+    const std::vector<SliceRecord>& records,
+    rocksdb::WriteBatch* batch
+) {
+    // 同一 chunk 的记录合成一个 merge 操作数
+    std::map<uint64_t, std::string> chunks;
+    for (const auto& r : records) {
+        uint64_t first = r.slice.offset / chunk_size;
+        uint64_t last = r.slice.size == 0 ? first : (r.slice.offset + r.slice.size - 1) / chunk_size;
+        for (uint64_t idx = first; idx <= last; ++idx) {
+            auto& value = chunks[idx];
+            codec::PutVarint64(&value, r.seq);
+            EncodeSliceRecord(r.slice, inode, idx * chunk_size, &value);
+            if (idx == UINT64_MAX) break;
+        }
     }
-
-    // gid
-    attr.gid = 0;
-    for (int i = 0; i < 4; ++i, ++pos) {
-        attr.gid |= (static_cast<uint8_t>(value[pos]) << (i * 8));
+    for (const auto& [idx, value] : chunks) {
+        batch->Merge(EncodeLayoutChunkKey(inode, idx), value);
     }
+}
 
-    // size
-    attr.size = 0;
-    for (int i = 0; i < 8; ++i, ++pos) {
-        attr.size |= (static_cast<uint64_t>(value[pos]) << (i * 8));
-    }
+// ================================
+// Key 编码 (public for RocksDBTransaction)
+// ================================
 
-    // mtime
-    attr.mtime = 0;
-    for (int i = 0; i < 8; ++i, ++pos) {
-        attr.mtime |= (static_cast<uint64_t>(value[pos]) << (i * 8));
-    }
+std::string RocksDBStore::EncodeDentryKey(InodeID parent, const std::string& name) {
+    KeyBuffer key;
+    EncodeDentryKey(parent, name, &key);
+    return key.ToString();
+}
 
-    // ctime
-    attr.ctime = 0;
-    for (int i = 0; i < 8; ++i, ++pos) {
-        attr.ctime |= (static_cast<uint64_t>(value[pos]) << (i * 8));
-    }
+void RocksDBStore::EncodeDentryKey(InodeID parent, std::string_view name, KeyBuffer* key) {
+    // 格式: "D" + parent(8字节小端) + "/" + name
+    key->Push('D');
+    key->PutFixed64LE(parent);
+    key->Push('/');
+    key->Append(name);
+}
 
-    // nlink
-    attr.nlink = 0;
-    for (int i = 0; i < 8; ++i, ++pos) {
-        attr.nlink |= (static_cast<uint64_t>(value[pos]) << (i * 8));
-    }
+std::string RocksDBStore::EncodeInodeKey(InodeID inode) {
+    KeyBuffer key;
+    EncodeInodeKey(inode, &key);
+    return key.ToString();
+}
 
-    return attr;
+void RocksDBStore::EncodeInodeKey(InodeID inode, KeyBuffer* key) {
+    // 格式: "I" + inode_id(8字节小端)
+    key->Push('I');
+    key->PutFixed64LE(inode);
 }
 
-// FileLayout Value: chunk_size(8) + slice_count(4) + [slice_id(8) + offset(8) + size(8) + key_len(4) + key_bytes]*
-std::string RocksDBStore::EncodeLayoutValue(const FileLayout& layout) {
-    std::string value;
+std::string RocksDBStore::EncodeLayoutKey(InodeID inode) {
+    KeyBuffer key;
+    EncodeLayoutKey(inode, &key);
+    return key.ToString();
+}
 
-    // chunk_size (8 bytes)
-    for (int i = 0; i < 8; ++i) {
-        value.push_back((layout.chunk_size >> (i * 8)) & 0xFF);
-    }
+void RocksDBStore::EncodeLayoutKey(InodeID inode, KeyBuffer* key) {
+    // 格式: "L" + inode_id(8字节小端)
+    key->Push('L');
+    key->PutFixed64LE(inode);
+}
 
-    // slice_count (4 bytes)
-    uint32_t count = static_cast<uint32_t>(layout.slices.size());
-    for (int i = 0; i < 4; ++i) {
-        value.push_back((count >> (i * 8)) & 0xFF);
-    }
+std::string RocksDBStore::EncodeLayoutChunkKey(InodeID inode, uint64_t chunk_idx) {
+    // 格式: "L" + inode_id(8字节小端) + chunk_idx(8字节大端)
+    KeyBuffer key;
+    EncodeLayoutKey(inode, &key);
+    key.PutFixed64BE(chunk_idx);
+    return key.ToString();
+}
 
-    // slices
-    for (const auto& slice : layout.slices) {
-        // slice_id (8 bytes)
-        for (int i = 0; i < 8; ++i) {
-            value.push_back((slice.slice_id >> (i * 8)) & 0xFF);
-        }
-        // offset (8 bytes)
-        for (int i = 0; i < 8; ++i) {
-            value.push_back((slice.offset >> (i * 8)) & 0xFF);
-        }
-        // size (8 bytes)
-        for (int i = 0; i < 8; ++i) {
-            value.push_back((slice.size >> (i * 8)) & 0xFF);
-        }
-        // key_len (4 bytes)
-        uint32_t key_len = static_cast<uint32_t>(slice.storage_key.size());
-        for (int i = 0; i < 4; ++i) {
-            value.push_back((key_len >> (i * 8)) & 0xFF);
-        }
-        // key_bytes
-        value.append(slice.storage_key);
-    }
+// ================================
+// Value 编码 (public for RocksDBTransaction), 格式见 value_codec.h
+// ================================
 
+std::string RocksDBStore::EncodeDentryValue(const Dentry& dentry) {
+    std::string value;
+    metadata::EncodeDentryValue(dentry, &value);
     return value;
 }
 
-FileLayout RocksDBStore::DecodeLayoutValue(const std::string& value) {
-    FileLayout layout{};
-    layout.slices.clear();
-
-    if (value.size() < 12) {
-        return layout;
-    }
-
-    size_t pos = 0;
-
-    // chunk_size
-    layout.chunk_size = 0;
-    for (int i = 0; i < 8; ++i, ++pos) {
-        layout.chunk_size |= (static_cast<uint64_t>(value[pos]) << (i * 8));
-    }
-
-    // slice_count
-    uint32_t count = 0;
-    for (int i = 0; i < 4; ++i, ++pos) {
-        count |= (static_cast<uint8_t>(value[pos]) << (i * 8));
+Dentry RocksDBStore::DecodeDentryValue(std::string_view value) {
+    Dentry dentry{};
+    if (!metadata::DecodeDentryValue(value, &dentry)) {
+        LOG_ERROR("Invalid dentry value (%zu bytes)", value.size());
+        return Dentry{};
     }
+    return dentry;
+}
 
-    // slices
-    for (uint32_t s = 0; s < count && pos + 28 <= value.size(); ++s) {
-        SliceInfo slice{};
-
-        // slice_id
-        slice.slice_id = 0;
-        for (int i = 0; i < 8; ++i, ++pos) {
-            slice.slice_id |= (static_cast<uint64_t>(value[pos]) << (i * 8));
-        }
-
-        // offset
-        slice.offset = 0;
-        for (int i = 0; i < 8; ++i, ++pos) {
-            slice.offset |= (static_cast<uint64_t>(value[pos]) << (i * 8));
-        }
-
-        // size
-        slice.size = 0;
-        for (int i = 0; i < 8; ++i, ++pos) {
-            slice.size |= (static_cast<uint64_t>(value[pos]) << (i * 8));
-        }
-
-        // key_len
-        uint32_t key_len = 0;
-        for (int i = 0; i < 4; ++i, ++pos) {
-            key_len |= (static_cast<uint8_t>(value[pos]) << (i * 8));
-        }
+std::string RocksDBStore::EncodeInodeValue(const InodeAttr& inode) {
+    std::string value;
+    metadata::EncodeInodeValue(inode, &value);
+    return value;
+}
 
-        // key_bytes
-        if (pos + key_len <= value.size()) {
-            slice.storage_key = value.substr(pos, key_len);
-            pos += key_len;
-            layout.slices.push_back(slice);
-        } else {
-            break;
-        }
+InodeAttr RocksDBStore::DecodeInodeValue(std::string_view value) {
+    InodeAttr attr{};
+    if (!metadata::DecodeInodeValue(value, &attr)) {
+        LOG_ERROR("Invalid inode value (%zu bytes)", value.size());
+        return InodeAttr{};
     }
-
-    return layout;
+    return attr;
 }
 
 // ================================
@@ -474,22 +569,105 @@ Status RocksDBTransaction::CreateInode(
     return Status::Ok();
 }
 
-Status RocksDBTransaction::Commit() {
-    rocksdb::WriteOptions write_options;
-    write_options.sync = true;  // WAL 同步
+Status RocksDBTransaction::UpdateInode(const InodeAttr& attr) {
+    batch_.Put(store_->EncodeInodeKey(attr.inode_id), store_->EncodeInodeValue(attr));
+    return Status::Ok();
+}
 
-    auto status = db_->Write(write_options, &batch_);
-    if (!status.ok()) {
-        LOG_ERROR("Failed to commit transaction: %s", status.ToString().c_str());
-        return Status::IO("Transaction commit failed: " + status.ToString());
+Status RocksDBTransaction::DeleteDentry(InodeID parent, const std::string& name) {
+    batch_.Delete(store_->EncodeDentryKey(parent, name));
+    return Status::Ok();
+}
+
+Status RocksDBTransaction::DeleteInode(InodeID inode) {
+    batch_.Delete(store_->EncodeInodeKey(inode));
+    return Status::Ok();
+}
+
+Status RocksDBTransaction::DeleteLayout(InodeID inode) {
+    // 布局头记入读集合: 提交前有并发追加时整个事务返回 kAgain, 不会漏删新 chunk
+    return store_->DeleteLayoutKeys(inode, &batch_, &reads_);
+}
+
+Status RocksDBTransaction::RecordRead(std::string key, const GroupCommitter::ReadCheck** read) {
+    for (const auto& r : reads_) {
+        if (r.key == key) {
+            *read = &r;
+            return Status::Ok();
+        }
+    }
+
+    GroupCommitter::ReadCheck check;
+    auto status = db_->Get(rocksdb::ReadOptions(), key, &check.value);
+    if (!status.ok() && !status.IsNotFound()) {
+        LOG_ERROR("Failed to read in transaction: %s", status.ToString().c_str());
+        return Status::IO("Failed to read in transaction: " + status.ToString());
+    }
+    check.exists = status.ok();
+    check.key = std::move(key);
+    reads_.push_back(std::move(check));
+    *read = &reads_.back();
+    return Status::Ok();
+}
+
+Status RocksDBTransaction::ReadDentry(
+    InodeID parent,
+    const std::string& name,
+    Dentry* dentry
+) {
+    const GroupCommitter::ReadCheck* read;
+    auto status = RecordRead(store_->EncodeDentryKey(parent, name), &read);
+    if (!status.OK()) {
+        return status;
+    }
+    if (!read->exists) {
+        return Status::NotFound("Dentry not found: " + name);
+    }
+    if (!metadata::DecodeDentryValue(read->value, dentry)) {
+        return Status::IO("Corrupted dentry: " + name);
+    }
+    dentry->name = name;
+    return Status::Ok();
+}
+
+Status RocksDBTransaction::ReadInode(InodeID inode, InodeAttr* attr) {
+    const GroupCommitter::ReadCheck* read;
+    auto status = RecordRead(store_->EncodeInodeKey(inode), &read);
+    if (!status.OK()) {
+        return status;
+    }
+    if (!read->exists) {
+        return Status::NotFound("Inode not found: " + std::to_string(inode));
+    }
+    if (!metadata::DecodeInodeValue(read->value, attr)) {
+        return Status::IO("Corrupted inode: " + std::to_string(inode));
+    }
+    return Status::Ok();
+}
+
+Status RocksDBTransaction::Commit() {
+    auto status = store_->committer()->CommitSync(&batch_, &reads_);
+    if (!status.OK()) {
+        return status;
     }
 
     committed_ = true;
     return Status::Ok();
 }
 
+AsyncTask<Status> RocksDBTransaction::CommitAsync() {
+    auto status = co_await store_->committer()->Commit(&batch_, &reads_);
+    if (!status.OK()) {
+        co_return status;
+    }
+
+    committed_ = true;
+    co_return Status::Ok();
+}
+
 Status RocksDBTransaction::Rollback() {
     batch_.Clear();
+    reads_.clear();
     committed_ = true;  // 标记为已提交，避免析构时再次回滚
     return Status::Ok();
 }
@@ -498,36 +676,192 @@ Status RocksDBTransaction::Rollback() {
 // 删除操作
 // ================================
 
+// 所有写入都经 committer: 与事务共享组提交与 sync_wal 设置
+
 Status RocksDBStore::DeleteDentry(InodeID parent, const std::string& name) {
-    auto key = EncodeDentryKey(parent, name);
-    auto status = db_->Delete(rocksdb::WriteOptions(), key);
-    if (!status.ok()) {
-        LOG_ERROR("Failed to delete dentry: %s", status.ToString().c_str());
-        return Status::IO("Failed to delete dentry: " + status.ToString());
-    }
-    return Status::Ok();
+    rocksdb::WriteBatch batch;
+    batch.Delete(EncodeDentryKey(parent, name));
+    return committer_->CommitSync(&batch);
 }
 
 Status RocksDBStore::DeleteInode(InodeID inode) {
-    auto key = EncodeInodeKey(inode);
-    auto status = db_->Delete(rocksdb::WriteOptions(), key);
-    if (!status.ok()) {
-        LOG_ERROR("Failed to delete inode: %s", status.ToString().c_str());
-        return Status::IO("Failed to delete inode: " + status.ToString());
-    }
-    return Status::Ok();
+    rocksdb::WriteBatch batch;
+    batch.Delete(EncodeInodeKey(inode));
+    return committer_->CommitSync(&batch);
 }
 
 Status RocksDBStore::DeleteLayout(InodeID inode) {
-    auto key = EncodeLayoutKey(inode);
-    auto status = db_->Delete(rocksdb::WriteOptions(), key);
-    if (!status.ok()) {
-        LOG_ERROR("Failed to delete layout: %s", status.ToString().c_str());
-        return Status::IO("Failed to delete layout: " + status.ToString());
+    for (;;) {
+        rocksdb::WriteBatch batch;
+        std::vector<GroupCommitter::ReadCheck> reads;
+        {
+            std::lock_guard<std::mutex> lock(update_mutex_);
+            auto status = DeleteLayoutKeys(inode, &batch, &reads);
+            if (!status.OK()) {
+                return status;
+            }
+        }
+        auto status = committer_->CommitSync(&batch, &reads);
+        if (status.code() != ErrorCode::kAgain) {
+            return status;
+        }
+    }
+}
+
+Status RocksDBStore::DeleteLayoutKeys(InodeID inode, rocksdb::WriteBatch* batch,
+                                      std::vector<GroupCommitter::ReadCheck>* reads) {
+    LayoutHeader header;
+    auto status = ReadLayoutHeaderForUpdate(inode, &header, reads);
+    if (!status.OK() || !reads->back().exists) {
+        return status;
+    }
+
+    // 没分配过序号 (或仍是 v1 整份布局) 时不会有 chunk key, 只删布局头
+    std::vector<std::string> keys;
+    if (header.next_seq > 0 && header.legacy.empty()) {
+        std::vector<SliceRecord> records;
+        status = ScanLayoutChunks(inode, header.chunk_size, EncodeLayoutChunkKey(inode, 0),
+                                  PrefixSuccessor(EncodeLayoutKey(inode)), &records, &keys);
+        if (!status.OK()) {
+            return status;
+        }
+    }
+    for (const auto& key : keys) {
+        batch->Delete(key);
     }
+    batch->Delete(reads->back().key);
     return Status::Ok();
 }
 
+// ================================
+// 布局/大小更新
+// ================================
+
+Status RocksDBStore::AppendSlices(
+    InodeID inode,
+    const std::vector<SliceInfo>& slices,
+    uint64_t min_size
+) {
+    // update_mutex_ 下读并构造 batch; committer 校验读集合时也要拿这把锁,
+    // 所以提交前释放. 读过的 inode/布局头被并发改写时 (kAgain) 重新来过
+    for (;;) {
+        rocksdb::WriteBatch batch;
+        std::vector<GroupCommitter::ReadCheck> reads;
+        {
+            std::lock_guard<std::mutex> lock(update_mutex_);
+
+            InodeAttr attr;
+            auto status = ReadInodeForUpdate(inode, &attr, &reads);
+            if (!status.OK()) {
+                return status;
+            }
+            LayoutHeader header;
+            status = ReadLayoutHeaderForUpdate(inode, &header, &reads);
+            if (!status.OK()) {
+                return status;
+            }
+
+            // 只分配序号并 merge 到相交的 chunk, 不读取已有 slice; v1 布局随之转存
+            std::vector<SliceRecord> records = std::move(header.legacy);
+            records.reserve(records.size() + slices.size());
+            for (const auto& slice : slices) {
+                records.push_back({header.next_seq++, slice});
+            }
+            attr.size = std::max(attr.size, min_size);
+            attr.mtime = NowInSeconds();
+
+            AppendLayoutRecords(inode, header.chunk_size, records, &batch);
+            batch.Put(EncodeLayoutKey(inode), EncodeLayoutHeader(header.chunk_size, header.next_seq));
+            batch.Put(EncodeInodeKey(inode), EncodeInodeValue(attr));
+        }
+        auto status = committer_->CommitSync(&batch, &reads);
+        if (status.code() != ErrorCode::kAgain) {
+            return status;
+        }
+    }
+}
+
+Status RocksDBStore::SetSize(InodeID inode, uint64_t size) {
+    for (;;) {
+        rocksdb::WriteBatch batch;
+        std::vector<GroupCommitter::ReadCheck> reads;
+        {
+            std::lock_guard<std::mutex> lock(update_mutex_);
+
+            InodeAttr attr;
+            auto status = ReadInodeForUpdate(inode, &attr, &reads);
+            if (!status.OK()) {
+                return status;
+            }
+            attr.size = size;
+            attr.mtime = NowInSeconds();
+            batch.Put(EncodeInodeKey(inode), EncodeInodeValue(attr));
+        }
+        auto status = committer_->CommitSync(&batch, &reads);
+        if (status.code() != ErrorCode::kAgain) {
+            return status;
+        }
+    }
+}
+
+Status RocksDBStore::ReplaceSlices(
+    InodeID inode,
+    const std::vector<SliceInfo>& expected,
+    const std::vector<SliceInfo>& replacement
+) {
+    // 读集合只含布局头: 期间的追加会改写它, 重试时按新布局重新比对
+    for (;;) {
+        rocksdb::WriteBatch batch;
+        std::vector<GroupCommitter::ReadCheck> reads;
+        {
+            std::lock_guard<std::mutex> lock(update_mutex_);
+
+            LayoutHeader header;
+            auto status = ReadLayoutHeaderForUpdate(inode, &header, &reads);
+            if (!status.OK()) {
+                return status;
+            }
+            std::vector<SliceRecord> scanned = std::move(header.legacy);
+            std::vector<std::string> chunk_keys;
+            status = ScanLayoutChunks(inode, header.chunk_size, EncodeLayoutChunkKey(inode, 0),
+                                      PrefixSuccessor(EncodeLayoutKey(inode)), &scanned,
+                                      &chunk_keys);
+            if (!status.OK()) {
+                return status;
+            }
+            FileLayout layout;
+            FillLayout(inode, header, &scanned, &layout);
+            if (layout.slices.size() < expected.size() ||
+                !std::equal(expected.begin(), expected.end(), layout.slices.begin(),
+                            [](const SliceInfo& a, const SliceInfo& b) {
+                                return a.slice_id == b.slice_id;
+                            })) {
+                return Status::Again("layout of inode " + std::to_string(inode) + " changed");
+            }
+
+            // 整份布局重写: 逐个删掉读到的 chunk 后按新顺序重新编号
+            std::vector<SliceRecord> records;
+            records.reserve(replacement.size() + layout.slices.size() - expected.size());
+            for (const auto& slice : replacement) {
+                records.push_back({records.size(), slice});
+            }
+            for (size_t i = expected.size(); i < layout.slices.size(); ++i) {
+                records.push_back({records.size(), std::move(layout.slices[i])});
+            }
+
+            for (const auto& key : chunk_keys) {
+                batch.Delete(key);
+            }
+            AppendLayoutRecords(inode, layout.chunk_size, records, &batch);
+            batch.Put(EncodeLayoutKey(inode), EncodeLayoutHeader(layout.chunk_size, records.size()));
+        }
+        auto status = committer_->CommitSync(&batch, &reads);
+        if (status.code() != ErrorCode::kAgain) {
+            return status;
+        }
+    }
+}
+
 // ================================
 // 目录扫描
 // ================================
@@ -535,29 +869,23 @@ Status RocksDBStore::DeleteLayout(InodeID inode) {
 Status RocksDBStore::ListDentries(InodeID parent, std::vector<Dentry>* entries) {
     entries->clear();
 
-    // 构造前缀: "D" + parent(8字节)
-    std::string prefix;
-    prefix.push_back('D');
-    for (int i = 0; i < 8; ++i) {
-        prefix.push_back((parent >> (i * 8)) & 0xFF);
-    }
-    prefix.push_back('/');
-
+    // 前缀: "D" + parent(8字节) + "/", 上界为其后继, 越界由 RocksDB 截止
+    KeyBuffer prefix;
+    EncodeDentryKey(parent, std::string_view(), &prefix);
+    std::string end = PrefixSuccessor(prefix.ToString());
+    rocksdb::Slice upper(end);
     rocksdb::ReadOptions read_options;
+    read_options.iterate_upper_bound = &upper;
     std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(read_options));
 
-    for (it->Seek(prefix); it->Valid(); it->Next()) {
-        auto key = it->key().ToString();
-        // 检查前缀匹配
-        if (key.compare(0, prefix.size(), prefix) != 0) {
-            break;
+    for (it->Seek(rocksdb::Slice(prefix.data(), prefix.size())); it->Valid(); it->Next()) {
+        // 提取文件名, value 中不存名字
+        Dentry dentry{};
+        if (!metadata::DecodeDentryValue(it->value().ToStringView(), &dentry)) {
+            return Status::IO("Corrupted dentry in directory " + std::to_string(parent));
         }
-
-        // 提取文件名
-        std::string name = key.substr(prefix.size());
-        auto dentry = DecodeDentryValue(it->value().ToString());
-        dentry.name = name;
-        entries->push_back(dentry);
+        dentry.name = it->key().ToStringView().substr(prefix.size());
+        entries->push_back(std::move(dentry));
     }
 
     if (!it->status().ok()) {
@@ -3,94 +3,133 @@
 
 namespace nebulastore {
 
-// Cut 算法：处理新 slice 覆盖旧 slices 的情况
-// 参考 JuiceFS 设计：新写入覆盖旧数据
-SliceNodePtr SliceTree::Cut(SliceNodePtr node, uint64_t pos, uint64_t len) {
-    if (!node) return nullptr;
-
-    uint64_t end = pos + len;
-    uint64_t node_end = node->End();
-
-    // 递归处理左子树
-    node->left = Cut(node->left, pos, len);
-    // 递归处理右子树
-    node->right = Cut(node->right, pos, len);
+SliceNode* SliceTree::NewNode(uint64_t pos, uint64_t id, uint64_t size, uint64_t off, uint64_t len) {
+    SliceNode* node;
+    if (!free_.empty()) {
+        node = free_.back();
+        free_.pop_back();
+        *node = SliceNode(pos, id, size, off, len);
+    } else {
+        node = &arena_.emplace_back(pos, id, size, off, len);
+    }
+    // xorshift64
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 7;
+    rng_ ^= rng_ << 17;
+    node->priority = static_cast<uint32_t>(rng_ >> 32);
+    ++count_;
+    return node;
+}
 
-    // 检查当前节点是否与新 slice 重叠
-    if (node_end <= pos || node->pos >= end) {
-        // 无重叠，保留节点
-        return node;
+void SliceTree::FreeTree(SliceNode* node) {
+    if (!node) return;
+    std::vector<SliceNode*> stack{node};
+    while (!stack.empty()) {
+        auto* n = stack.back();
+        stack.pop_back();
+        if (n->left) stack.push_back(n->left);
+        if (n->right) stack.push_back(n->right);
+        free_.push_back(n);
+        --count_;
     }
+}
 
-    // 完全覆盖：删除节点
-    if (node->pos >= pos && node_end <= end) {
-        // 合并左右子树
-        if (!node->left) return node->right;
-        if (!node->right) return node->left;
-        // 找右子树最小节点替换
-        auto min_node = node->right;
-        while (min_node->left) min_node = min_node->left;
-        min_node->right = node->right;
-        min_node->left = node->left;
-        return min_node;
+void SliceTree::Split(SliceNode* node, uint64_t key, SliceNode** left, SliceNode** right) {
+    // 沿查找路径把节点依次挂到左树的最右链或右树的最左链上
+    SliceNode** l = left;
+    SliceNode** r = right;
+    while (node) {
+        if (node->pos < key) {
+            *l = node;
+            l = &node->right;
+            node = node->right;
+        } else {
+            *r = node;
+            r = &node->left;
+            node = node->left;
+        }
     }
+    *l = nullptr;
+    *r = nullptr;
+}
 
-    // 部分覆盖：需要切割
-    if (node->pos < pos && node_end > end) {
-        // 新 slice 在中间，分裂成两个节点
-        auto right_part = std::make_shared<SliceNode>(
-            end, node->id, node->size,
-            node->off + (end - node->pos),
-            node_end - end
-        );
-        node->len = pos - node->pos;
-        node->right = InsertNode(node->right, right_part);
-    } else if (node->pos < pos) {
-        // 新 slice 覆盖右边部分
-        node->len = pos - node->pos;
-    } else {
-        // 新 slice 覆盖左边部分
-        uint64_t cut_len = end - node->pos;
-        node->off += cut_len;
-        node->len -= cut_len;
-        node->pos = end;
+SliceNode* SliceTree::Merge(SliceNode* left, SliceNode* right) {
+    SliceNode* root = nullptr;
+    SliceNode** slot = &root;
+    while (left && right) {
+        if (left->priority > right->priority) {
+            *slot = left;
+            slot = &left->right;
+            left = left->right;
+        } else {
+            *slot = right;
+            slot = &right->left;
+            right = right->left;
+        }
     }
+    *slot = left ? left : right;
+    return root;
+}
 
+SliceNode* SliceTree::Last(SliceNode* node) {
+    if (!node) return nullptr;
+    while (node->right) node = node->right;
     return node;
 }
 
-// BST 插入
-SliceNodePtr SliceTree::InsertNode(SliceNodePtr node, SliceNodePtr new_node) {
-    if (!node) return new_node;
+// Cut 算法：处理新 slice 覆盖旧 slices 的情况
+// 参考 JuiceFS 设计：新写入覆盖旧数据
+void SliceTree::Cut(uint64_t pos, uint64_t len, SliceNode** before, SliceNode** after) {
+    uint64_t end = pos + len;
+    SliceNode* rest;
+    SliceNode* inside;
+    Split(root_, pos, before, &rest);
+    Split(rest, end, &inside, after);
+    root_ = nullptr;
+
+    // 在 pos 之前开始的 slice 互不重叠, 只有最后一个可能伸入新区间
+    if (SliceNode* last = Last(*before); last && last->End() > pos) {
+        uint64_t last_end = last->End();
+        if (last_end > end) {
+            // 新 slice 在中间，分裂出右半部分
+            auto* right_part = NewNode(end, last->id, last->size,
+                                       last->off + (end - last->pos), last_end - end);
+            *after = Merge(right_part, *after);
+        }
+        // 保留左半部分
+        last->len = pos - last->pos;
+    }
 
-    if (new_node->pos < node->pos) {
-        node->left = InsertNode(node->left, new_node);
-    } else {
-        node->right = InsertNode(node->right, new_node);
+    // 在区间内开始的 slice 除最后一个可能伸出 end 外都被完全覆盖
+    if (SliceNode* tail = Last(inside); tail && tail->End() > end) {
+        SliceNode* covered;
+        SliceNode* tail_tree;
+        Split(inside, tail->pos, &covered, &tail_tree);
+        inside = covered;
+        // 新 slice 覆盖左边部分
+        uint64_t cut_len = end - tail->pos;
+        tail->off += cut_len;
+        tail->len -= cut_len;
+        tail->pos = end;
+        *after = Merge(tail_tree, *after);
     }
-    return node;
+    FreeTree(inside);
 }
 
 // 插入新 slice
 void SliceTree::Insert(uint64_t pos, uint64_t id, uint64_t size, uint64_t off, uint64_t len) {
-    // 先 Cut 掉被覆盖的部分
-    root_ = Cut(root_, pos, len);
-    // 插入新节点
-    auto new_node = std::make_shared<SliceNode>(pos, id, size, off, len);
-    root_ = InsertNode(root_, new_node);
-}
-
-// 中序遍历收集
-void SliceTree::InorderCollect(SliceNodePtr node, std::vector<SliceNodePtr>& result) const {
-    if (!node) return;
-    InorderCollect(node->left, result);
-    result.push_back(node);
-    InorderCollect(node->right, result);
+    if (len == 0) return;
+    // 先 Cut 掉被覆盖的部分, 新节点放在两段之间
+    SliceNode* before;
+    SliceNode* after;
+    Cut(pos, len, &before, &after);
+    auto* node = NewNode(pos, id, size, off, len);
+    root_ = Merge(Merge(before, node), after);
 }
 
 // 查找包含指定位置的 slice
 SliceNodePtr SliceTree::Find(uint64_t pos) const {
-    auto node = root_;
+    const SliceNode* node = root_;
     while (node) {
         if (pos < node->pos) {
             node = node->left;
@@ -103,41 +142,38 @@ SliceNodePtr SliceTree::Find(uint64_t pos) const {
     return nullptr;
 }
 
-// 范围查询辅助
-void SliceTree::RangeCollect(SliceNodePtr node, uint64_t start, uint64_t end,
-                             std::vector<SliceNodePtr>& result) const {
-    if (!node) return;
-
-    if (node->pos >= end) {
-        RangeCollect(node->left, start, end, result);
-        return;
-    }
-    if (node->End() <= start) {
-        RangeCollect(node->right, start, end, result);
-        return;
-    }
-
-    RangeCollect(node->left, start, end, result);
-    result.push_back(node);
-    RangeCollect(node->right, start, end, result);
-}
-
-// 获取范围内的 slices
+// 获取范围内的 slices: 先沿路径找到第一个 End > start 的节点, 再中序前进到 pos >= end
 std::vector<SliceNodePtr> SliceTree::GetRange(uint64_t start, uint64_t end) const {
     std::vector<SliceNodePtr> result;
-    RangeCollect(root_, start, end, result);
+    std::vector<const SliceNode*> stack;
+    for (const SliceNode* node = root_; node;) {
+        if (node->End() > start) {
+            stack.push_back(node);
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    while (!stack.empty()) {
+        const SliceNode* node = stack.back();
+        stack.pop_back();
+        if (node->pos >= end) break;
+        result.push_back(node);
+        for (const SliceNode* n = node->right; n; n = n->left) {
+            stack.push_back(n);
+        }
+    }
     return result;
 }
 
 // 构建最终 SliceInfo 列表
 std::vector<SliceInfo> SliceTree::Build(const std::string& key_prefix) const {
-    std::vector<SliceNodePtr> nodes;
-    InorderCollect(root_, nodes);
+    auto nodes = GetRange(0, UINT64_MAX);
 
     std::vector<SliceInfo> slices;
     slices.reserve(nodes.size());
 
-    for (const auto& node : nodes) {
+    for (const auto* node : nodes) {
         SliceInfo info;
         info.slice_id = node->id;
         info.offset = node->pos;
@@ -0,0 +1,200 @@
+// ================================
+// 元数据 value 编码实现
+// ================================
+
+#include "nebulastore/metadata/value_codec.h"
+#include <charconv>
+
+namespace nebulastore::metadata {
+
+namespace {
+
+// inode 可选字段
+constexpr uint64_t kInodeUid = 1 << 0;
+constexpr uint64_t kInodeGid = 1 << 1;
+constexpr uint64_t kInodeSize = 1 << 2;
+constexpr uint64_t kInodeMtime = 1 << 3;
+constexpr uint64_t kInodeCtime = 1 << 4;
+constexpr uint64_t kInodeNlink = 1 << 5;
+constexpr uint64_t kInodeKnown = (1 << 6) - 1;
+
+// slice 可选字段
+constexpr uint64_t kSliceKey = 1 << 0;
+constexpr uint64_t kSliceKnown = (1 << 1) - 1;
+
+// v1 定长格式
+constexpr size_t kInodeV1Size = 52;
+constexpr size_t kDentryV1Size = 12;
+constexpr size_t kLayoutV1HeaderSize = 12;
+constexpr size_t kSliceV1FixedSize = 28;
+
+uint64_t GetFixedLE(const char* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        v |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (i * 8);
+    }
+    return v;
+}
+
+void DecodeInodeValueV1(std::string_view value, InodeAttr* attr) {
+    const char* p = value.data();
+    attr->inode_id = GetFixedLE(p, 8);
+    attr->mode.mode = static_cast<uint32_t>(GetFixedLE(p + 8, 4));
+    attr->uid = static_cast<UserID>(GetFixedLE(p + 12, 4));
+    attr->gid = static_cast<GroupID>(GetFixedLE(p + 16, 4));
+    attr->size = GetFixedLE(p + 20, 8);
+    attr->mtime = GetFixedLE(p + 28, 8);
+    attr->ctime = GetFixedLE(p + 36, 8);
+    attr->nlink = GetFixedLE(p + 44, 8);
+}
+
+void DecodeDentryValueV1(std::string_view value, Dentry* dentry) {
+    dentry->inode_id = GetFixedLE(value.data(), 8);
+    dentry->type = static_cast<FileType>(GetFixedLE(value.data() + 8, 4));
+}
+
+// key 是否为 SliceStorageKey(inode, slice_id), 不分配内存
+bool IsDefaultStorageKey(std::string_view key, InodeID inode, uint64_t slice_id) {
+    constexpr std::string_view kPrefix = "chunks/";
+    if (key.size() <= kPrefix.size() || key.substr(0, kPrefix.size()) != kPrefix) return false;
+    key.remove_prefix(kPrefix.size());
+    char buf[20];   // uint64 最多 20 位十进制
+    auto r = std::to_chars(buf, buf + sizeof(buf), inode);
+    std::string_view part(buf, static_cast<size_t>(r.ptr - buf));
+    if (key.size() <= part.size() || key.substr(0, part.size()) != part || key[part.size()] != '/') {
+        return false;
+    }
+    key.remove_prefix(part.size() + 1);
+    r = std::to_chars(buf, buf + sizeof(buf), slice_id);
+    return key == std::string_view(buf, static_cast<size_t>(r.ptr - buf));
+}
+
+} // namespace
+
+void EncodeInodeValue(const InodeAttr& attr, std::string* dst) {
+    uint64_t flags = 0;
+    if (attr.uid != 0) flags |= kInodeUid;
+    if (attr.gid != 0) flags |= kInodeGid;
+    if (attr.size != 0) flags |= kInodeSize;
+    if (attr.mtime != 0) flags |= kInodeMtime;
+    if (attr.ctime != attr.mtime) flags |= kInodeCtime;
+    if (attr.nlink != 1) flags |= kInodeNlink;
+
+    dst->push_back(static_cast<char>(kValueFormatV2));
+    codec::PutVarint64(dst, flags);
+    codec::PutVarint64(dst, attr.inode_id);
+    codec::PutVarint64(dst, attr.mode.mode);
+    if (flags & kInodeUid) codec::PutVarint64(dst, attr.uid);
+    if (flags & kInodeGid) codec::PutVarint64(dst, attr.gid);
+    if (flags & kInodeSize) codec::PutVarint64(dst, attr.size);
+    if (flags & kInodeMtime) codec::PutDelta(dst, codec::kTimeBase, attr.mtime);
+    if (flags & kInodeCtime) codec::PutDelta(dst, attr.mtime, attr.ctime);
+    if (flags & kInodeNlink) codec::PutVarint64(dst, attr.nlink);
+}
+
+namespace {
+
+bool DecodeInodeValueV2(std::string_view value, InodeAttr* attr) {
+    codec::Reader reader(value);
+    uint8_t version;
+    uint64_t flags;
+    if (!reader.GetByte(&version) || version != kValueFormatV2 ||
+        !reader.GetVarint64(&flags) || (flags & ~kInodeKnown) != 0 ||
+        !reader.GetVarint64(&attr->inode_id) || !reader.GetVarint(&attr->mode.mode)) {
+        return false;
+    }
+    attr->uid = 0;
+    attr->gid = 0;
+    attr->size = 0;
+    attr->mtime = 0;
+    attr->nlink = 1;
+    if ((flags & kInodeUid) && !reader.GetVarint(&attr->uid)) return false;
+    if ((flags & kInodeGid) && !reader.GetVarint(&attr->gid)) return false;
+    if ((flags & kInodeSize) && !reader.GetVarint64(&attr->size)) return false;
+    if ((flags & kInodeMtime) && !reader.GetDelta(codec::kTimeBase, &attr->mtime)) return false;
+    attr->ctime = attr->mtime;
+    if ((flags & kInodeCtime) && !reader.GetDelta(attr->mtime, &attr->ctime)) return false;
+    if ((flags & kInodeNlink) && !reader.GetVarint64(&attr->nlink)) return false;
+    return reader.empty();
+}
+
+} // namespace
+
+bool DecodeInodeValue(std::string_view value, InodeAttr* attr) {
+    if (DecodeInodeValueV2(value, attr)) return true;
+    if (value.size() != kInodeV1Size) return false;
+    DecodeInodeValueV1(value, attr);
+    return true;
+}
+
+void EncodeDentryValue(const Dentry& dentry, std::string* dst) {
+    dst->push_back(static_cast<char>(kValueFormatV2));
+    codec::PutVarint64(dst, dentry.inode_id);
+    codec::PutVarint64(dst, static_cast<uint32_t>(dentry.type));
+}
+
+bool DecodeDentryValue(std::string_view value, Dentry* dentry) {
+    codec::Reader reader(value);
+    uint8_t version;
+    uint32_t type;
+    if (!reader.GetByte(&version) || version != kValueFormatV2 ||
+        !reader.GetVarint64(&dentry->inode_id) || !reader.GetVarint(&type) || !reader.empty()) {
+        if (value.size() != kDentryV1Size) return false;
+        DecodeDentryValueV1(value, dentry);
+        return true;
+    }
+    dentry->type = static_cast<FileType>(type);
+    return true;
+}
+
+void EncodeSliceRecord(const SliceInfo& slice, InodeID inode, uint64_t base, std::string* dst) {
+    bool explicit_key = !IsDefaultStorageKey(slice.storage_key, inode, slice.slice_id);
+    codec::PutVarint64(dst, explicit_key ? kSliceKey : 0);
+    codec::PutVarint64(dst, slice.slice_id);
+    codec::PutDelta(dst, base, slice.offset);
+    codec::PutVarint64(dst, slice.size);
+    if (explicit_key) codec::PutLengthPrefixed(dst, slice.storage_key);
+}
+
+bool DecodeSliceRecord(codec::Reader* reader, InodeID inode, uint64_t base, SliceInfo* slice) {
+    uint64_t flags;
+    if (!reader->GetVarint64(&flags) || (flags & ~kSliceKnown) != 0 ||
+        !reader->GetVarint64(&slice->slice_id) || !reader->GetDelta(base, &slice->offset) ||
+        !reader->GetVarint64(&slice->size)) {
+        return false;
+    }
+    if (flags & kSliceKey) {
+        std::string_view key;
+        if (!reader->GetLengthPrefixed(&key)) return false;
+        slice->storage_key.assign(key.data(), key.size());
+    } else {
+        slice->storage_key = SliceStorageKey(inode, slice->slice_id);
+    }
+    return true;
+}
+
+bool DecodeLayoutValueV1(std::string_view value, FileLayout* layout) {
+    if (value.size() < kLayoutV1HeaderSize) return false;
+    const char* p = value.data();
+    layout->chunk_size = GetFixedLE(p, 8);
+    uint64_t count = GetFixedLE(p + 8, 4);
+    layout->slices.clear();
+
+    size_t pos = kLayoutV1HeaderSize;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (value.size() - pos < kSliceV1FixedSize) return false;
+        SliceInfo slice;
+        slice.slice_id = GetFixedLE(p + pos, 8);
+        slice.offset = GetFixedLE(p + pos + 8, 8);
+        slice.size = GetFixedLE(p + pos + 16, 8);
+        uint64_t key_len = GetFixedLE(p + pos + 24, 4);
+        pos += kSliceV1FixedSize;
+        if (value.size() - pos < key_len) return false;
+        slice.storage_key.assign(p + pos, key_len);
+        pos += key_len;
+        layout->slices.push_back(std::move(slice));
+    }
+    return pos == value.size();
+}
+
+} // namespace nebulastore::metadata
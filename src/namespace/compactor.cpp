@@ -0,0 +1,412 @@
+// ================================
+// slice 压缩实现
+// ================================
+
+#include "nebulastore/namespace/compactor.h"
+#include "nebulastore/common/logger.h"
+#include "nebulastore/metadata/slice_tree.h"
+#include "nebulastore/namespace/slice_writer.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace nebulastore::namespace_ {
+
+namespace {
+
+constexpr uint64_t kDefaultChunkSize = 4ULL << 20;
+
+struct LayoutShape {
+    uint64_t total_bytes = 0;       // 所有 slice 对象的字节数
+    uint64_t visible_bytes = 0;     // 未被遮蔽的字节数
+    uint64_t chunks = 0;            // 含可见数据的 chunk 数
+};
+
+LayoutShape Measure(const FileLayout& layout) {
+    LayoutShape shape;
+    SliceTree tree;
+    for (const auto& s : layout.slices) {
+        shape.total_bytes += s.size;
+        tree.Insert(s.offset, s.slice_id, s.size, 0, s.size);
+    }
+    uint64_t chunk_size = layout.chunk_size ? layout.chunk_size : kDefaultChunkSize;
+    uint64_t last_chunk = UINT64_MAX;
+    for (auto node : tree.GetRange(0, UINT64_MAX)) {
+        shape.visible_bytes += node->len;
+        uint64_t first = node->pos / chunk_size;
+        uint64_t last = (node->End() - 1) / chunk_size;
+        if (first == last_chunk) ++first;
+        if (first <= last) shape.chunks += last - first + 1;
+        last_chunk = last;
+    }
+    return shape;
+}
+
+} // namespace
+
+SliceCompactor::SliceCompactor(std::shared_ptr<metadata::MetadataService> metadata,
+                               std::shared_ptr<storage::StorageBackend> backend,
+                               Options options)
+    : metadata_(std::move(metadata)),
+      backend_(std::move(backend)),
+      options_(options),
+      planner_(backend_.get(), options.max_parallel_reads) {}
+
+SliceCompactor::~SliceCompactor() {
+    Stop();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_.empty()) {
+        LOG_WARN("slice compactor destroyed with %zu old objects not yet deleted", pending_.size());
+    }
+}
+
+// ================================
+// 候选与热度
+// ================================
+
+double SliceCompactor::HeatAt(const Candidate& c, Clock::time_point now) const {
+    if (options_.hot_half_life_ms == 0) return c.heat;
+    double elapsed_ms = std::chrono::duration<double, std::milli>(now - c.stamp).count();
+    return c.heat * std::exp2(-elapsed_ms / static_cast<double>(options_.hot_half_life_ms));
+}
+
+void SliceCompactor::Touch(InodeID inode, double weight) {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = candidates_.try_emplace(inode);
+    if (!inserted) it->second.heat = HeatAt(it->second, now);
+    it->second.heat += weight;
+    it->second.stamp = now;
+
+    if (candidates_.size() > options_.max_candidates) {
+        auto coldest = candidates_.end();
+        double coldest_heat = 0;
+        for (auto c = candidates_.begin(); c != candidates_.end(); ++c) {
+            if (c->first == inode) continue;
+            double heat = HeatAt(c->second, now);
+            if (coldest == candidates_.end() || heat < coldest_heat) {
+                coldest = c;
+                coldest_heat = heat;
+            }
+        }
+        if (coldest != candidates_.end()) candidates_.erase(coldest);
+    }
+    cv_.notify_one();
+}
+
+size_t SliceCompactor::candidates() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return candidates_.size();
+}
+
+SliceCompactor::Stats SliceCompactor::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s = stats_;
+    s.pending_deletes = pending_.size();
+    return s;
+}
+
+bool SliceCompactor::NeedsCompaction(const FileLayout& layout) const {
+    if (layout.slices.size() < 2) return false;
+    auto shape = Measure(layout);
+    if (shape.total_bytes > 0) {
+        double garbage = 1.0 - static_cast<double>(shape.visible_bytes) /
+                               static_cast<double>(shape.total_bytes);
+        if (garbage >= options_.min_garbage_ratio && layout.slices.size() > shape.chunks) {
+            return true;
+        }
+    }
+    return layout.slices.size() >= options_.min_slices &&
+           layout.slices.size() >= 2 * shape.chunks;
+}
+
+// ================================
+// 压缩
+// ================================
+
+AsyncTask<Status> SliceCompactor::RunOnce(InodeID* inode) {
+    InodeID target = 0;
+    double heat = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        auto best = candidates_.end();
+        for (auto c = candidates_.begin(); c != candidates_.end(); ++c) {
+            double h = HeatAt(c->second, now);
+            if (best == candidates_.end() || h > heat) {
+                best = c;
+                heat = h;
+            }
+        }
+        if (best != candidates_.end()) {
+            target = best->first;
+            candidates_.erase(best);
+        }
+    }
+    if (inode) *inode = target;
+    if (target == 0) co_return Status::Ok();
+
+    auto status = co_await CompactInode(target);
+    if (status.code() == ErrorCode::kAgain) {
+        // 与前台写冲突: 保留热度重新排队, 下一轮按新布局再试
+        Touch(target, heat);
+    }
+    co_return status;
+}
+
+AsyncTask<Status> SliceCompactor::CompactInode(InodeID inode) {
+    FileLayout layout;
+    auto status = co_await metadata_->GetLayout(inode, &layout);
+    if (!status.OK()) {
+        co_return status.code() == ErrorCode::kNotFound ? Status::Ok() : status;
+    }
+    if (!NeedsCompaction(layout)) co_return Status::Ok();
+
+    // 整个文件一次求出可见区间, 再按 chunk 切开; 每个 chunk 读出首个到末个可见字节
+    uint64_t chunk_size = layout.chunk_size ? layout.chunk_size : kDefaultChunkSize;
+    auto plan = ReadPlanner::Plan(layout, 0, UINT64_MAX, chunk_size);
+
+    std::vector<SliceInfo> merged;
+    uint64_t rewritten = 0;
+    size_t next = 0;
+    for (uint64_t chunk_start = 0; chunk_start < plan.length; chunk_start += chunk_size) {
+        uint64_t chunk_end = std::min(plan.length, chunk_start + chunk_size);
+        ReadPlan part;
+        for (size_t i = next; i < plan.extents.size(); ++i) {
+            const auto& e = plan.extents[i];
+            if (e.buffer_offset >= chunk_end) break;
+            uint64_t begin = std::max(e.buffer_offset, chunk_start);
+            uint64_t end = std::min(e.buffer_offset + e.length, chunk_end);
+            if (part.extents.empty()) part.offset = begin;
+            part.extents.push_back({e.storage_key, e.object_offset + (begin - e.buffer_offset),
+                                    end - begin, begin - part.offset});
+            part.length = end - part.offset;
+            if (e.buffer_offset + e.length <= chunk_end) next = i + 1;
+        }
+        if (part.extents.empty()) continue;
+
+        ByteBuffer data = ByteBuffer::Allocate(part.length);
+        status = co_await planner_.Execute(part, data.data());
+        if (status.OK() && !co_await Throttle(part.length)) {
+            status = Status::IO("compactor stopped");
+        }
+        SliceInfo slice{NextSliceId(), part.offset, part.length, ""};
+        slice.storage_key = SliceStorageKey(inode, slice.slice_id);
+        if (status.OK()) {
+            status = co_await backend_->Put(slice.storage_key, data);
+        }
+        if (!status.OK()) {
+            LOG_ERROR("compact inode %lu failed at offset %lu: %s",
+                      inode, part.offset, status.message().c_str());
+            auto drop = DropObjects(std::move(merged));
+            co_await drop;
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.failures;
+            co_return status;
+        }
+        merged.push_back(std::move(slice));
+        rewritten += part.length;
+    }
+
+    status = co_await metadata_->ReplaceSlices(inode, layout.slices, merged);
+    if (!status.OK()) {
+        auto drop = DropObjects(std::move(merged));
+        co_await drop;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (status.code() == ErrorCode::kAgain) {
+            ++stats_.conflicts;
+        } else {
+            ++stats_.failures;
+        }
+        co_return status;
+    }
+
+    // 旧对象等到保留期过后再删, 打开时缓存了旧布局的读流仍可读到
+    std::unordered_set<std::string> old_keys;
+    uint64_t old_bytes = 0;
+    for (const auto& s : layout.slices) {
+        old_keys.insert(s.storage_key);
+        old_bytes += s.size;
+    }
+    auto due = Clock::now() + std::chrono::milliseconds(options_.delete_delay_ms);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& key : old_keys) pending_.push_back({due, key});
+        ++stats_.files_compacted;
+        stats_.slices_reclaimed += layout.slices.size() - merged.size();
+        stats_.bytes_reclaimed += old_bytes > rewritten ? old_bytes - rewritten : 0;
+        stats_.bytes_rewritten += rewritten;
+    }
+    LOG_INFO("compacted inode %lu: %zu slices -> %zu, %lu bytes rewritten",
+             inode, layout.slices.size(), merged.size(), rewritten);
+    co_return Status::Ok();
+}
+
+AsyncTask<void> SliceCompactor::DropObjects(std::vector<SliceInfo> slices) {
+    for (const auto& s : slices) {
+        auto status = co_await backend_->Delete(s.storage_key);
+        if (!status.OK() && status.code() != ErrorCode::kNotFound) {
+            LOG_WARN("drop compacted object %s failed: %s",
+                     s.storage_key.c_str(), status.message().c_str());
+        }
+    }
+}
+
+// ================================
+// 限速
+// ================================
+
+SliceCompactor::PaceAwaiter SliceCompactor::Throttle(uint64_t bytes) {
+    if (options_.max_bytes_per_sec == 0) return {this, Clock::time_point::min()};
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    if (pace_ < now) pace_ = now;
+    auto due = pace_;
+    pace_ += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+        static_cast<double>(bytes) / static_cast<double>(options_.max_bytes_per_sec)));
+    return {this, due};
+}
+
+bool SliceCompactor::PaceAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(self->mutex_);
+        // 没有后台线程可以恢复: 不等待, 直接继续
+        if (!self->running_ || self->stop_) return false;
+        self->parked_.push_back({due, handle});
+    }
+    self->cv_.notify_all();
+    return true;
+}
+
+bool SliceCompactor::PaceAwaiter::await_resume() const {
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    return !self->stop_;
+}
+
+// ================================
+// 旧对象回收
+// ================================
+
+AsyncTask<Status> SliceCompactor::PurgeDeleted(bool force) {
+    Status result = Status::Ok();
+    for (;;) {
+        std::string key;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty() || (!force && pending_.front().due > Clock::now())) break;
+            key = std::move(pending_.front().key);
+            pending_.pop_front();
+        }
+        auto status = co_await backend_->Delete(key);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (status.OK() || status.code() == ErrorCode::kNotFound) {
+            ++stats_.objects_deleted;
+        } else {
+            // 稍后重试, 放到队尾不阻塞其他到期对象
+            LOG_WARN("delete compacted-away object %s failed: %s",
+                     key.c_str(), status.message().c_str());
+            pending_.push_back({Clock::now() + std::chrono::milliseconds(options_.poll_interval_ms),
+                                std::move(key)});
+            if (result.OK()) result = status;
+            if (force) break;
+        }
+    }
+    co_return result;
+}
+
+// ================================
+// 后台线程
+// ================================
+
+void SliceCompactor::Start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_.joinable()) return;
+    stop_ = false;
+    running_ = true;
+    worker_ = std::thread([this] { Loop(); });
+}
+
+void SliceCompactor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+AsyncTask<Status> SliceCompactor::RunStep(InodeID* inode) {
+    auto status = co_await RunOnce(inode);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        step_done_ = true;
+    }
+    cv_.notify_all();
+    co_return status;
+}
+
+void SliceCompactor::ServeParked() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!step_done_) {
+        if (parked_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        auto now = Clock::now();
+        auto earliest = Clock::time_point::max();
+        std::vector<std::coroutine_handle<>> ready;
+        for (auto it = parked_.begin(); it != parked_.end();) {
+            if (stop_ || it->due <= now) {
+                ready.push_back(it->handle);
+                it = parked_.erase(it);
+            } else {
+                earliest = std::min(earliest, it->due);
+                ++it;
+            }
+        }
+        if (ready.empty()) {
+            cv_.wait_until(lock, earliest);
+            continue;
+        }
+        lock.unlock();
+        for (auto handle : ready) handle.resume();
+        lock.lock();
+    }
+    step_done_ = false;
+}
+
+void SliceCompactor::Loop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stop_) {
+                // 之后的限速不再挂起; 已挂起的协程在这里恢复, 看到 stop_ 后退出
+                running_ = false;
+                auto parked = std::move(parked_);
+                parked_.clear();
+                lock.unlock();
+                for (auto& p : parked) p.handle.resume();
+                return;
+            }
+        }
+        InodeID inode = 0;
+        auto step = RunStep(&inode);
+        ServeParked();
+        auto status = step.Get();
+        if (!status.OK() && status.code() != ErrorCode::kAgain) {
+            LOG_WARN("compaction of inode %lu failed: %s", inode, status.message().c_str());
+        }
+        PurgeDeleted(false).Get();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto interval = std::chrono::milliseconds(options_.poll_interval_ms);
+        if (inode == 0) {
+            cv_.wait_for(lock, interval, [this] { return stop_ || !candidates_.empty(); });
+        } else if (status.code() == ErrorCode::kAgain) {
+            // 文件正被频繁写入, 稍后再试
+            cv_.wait_for(lock, interval, [this] { return stop_; });
+        }
+    }
+}
+
+} // namespace nebulastore::namespace_
@@ -0,0 +1,157 @@
+// ================================
+// 读计划与并发执行
+// ================================
+
+#include "nebulastore/namespace/read_planner.h"
+#include "nebulastore/metadata/slice_tree.h"
+#include "nebulastore/common/logger.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+namespace nebulastore::namespace_ {
+
+ReadPlan ReadPlanner::Plan(const FileLayout& layout, uint64_t offset, uint64_t size,
+                           uint64_t max_extent) {
+    ReadPlan plan;
+    plan.offset = offset;
+
+    // 按写入顺序插入, 后写覆盖先写
+    SliceTree tree;
+    uint64_t file_end = 0;
+    for (size_t i = 0; i < layout.slices.size(); ++i) {
+        const auto& s = layout.slices[i];
+        if (s.size == 0) continue;
+        tree.Insert(s.offset, i, s.size, 0, s.size);
+        file_end = std::max(file_end, s.offset + s.size);
+    }
+    if (offset >= file_end || size == 0) return plan;
+    uint64_t end = std::min(offset + size, file_end);
+    plan.length = end - offset;
+
+    for (const auto& node : tree.GetRange(offset, end)) {
+        uint64_t start = std::max(node->pos, offset);
+        uint64_t stop = std::min(node->End(), end);
+        if (start >= stop) continue;
+
+        const auto& key = layout.slices[node->id].storage_key;
+        uint64_t object_offset = node->off + (start - node->pos);
+        uint64_t buffer_offset = start - offset;
+
+        // 同一对象首尾相接 (SliceTree 切分产生) 则并入上一段
+        if (!plan.extents.empty()) {
+            auto& last = plan.extents.back();
+            if (last.storage_key == key &&
+                last.object_offset + last.length == object_offset &&
+                last.buffer_offset + last.length == buffer_offset) {
+                last.length += stop - start;
+                continue;
+            }
+        }
+        plan.extents.push_back(ReadExtent{key, object_offset, stop - start, buffer_offset});
+    }
+
+    if (max_extent == 0) return plan;
+
+    // 过长的段切开, 让大块顺序读也能并发
+    std::vector<ReadExtent> split;
+    split.reserve(plan.extents.size());
+    for (auto& e : plan.extents) {
+        for (uint64_t done = 0; done < e.length; done += max_extent) {
+            uint64_t len = std::min(max_extent, e.length - done);
+            split.push_back(ReadExtent{e.storage_key, e.object_offset + done, len,
+                                       e.buffer_offset + done});
+        }
+    }
+    plan.extents = std::move(split);
+    return plan;
+}
+
+AsyncTask<Status> ReadPlanner::ReadExtentInto(const ReadExtent& extent, uint8_t* dst) {
+    uint64_t got = 0;
+    auto status = co_await backend_->GetRangeInto(extent.storage_key, extent.object_offset,
+                                                  extent.length, dst, &got);
+    if (!status.OK()) {
+        LOG_ERROR("read %s failed: %s", extent.storage_key.c_str(), status.message().c_str());
+        co_return status;
+    }
+    // 对象比 slice 记录的短: 缺失部分按空洞处理
+    if (got < extent.length) {
+        std::memset(dst + got, 0, extent.length - got);
+    }
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> ReadPlanner::Execute(const ReadPlan& plan, uint8_t* dst) {
+    // 先填空洞, 与后续并发读的区间互不重叠
+    uint64_t cursor = 0;
+    for (const auto& e : plan.extents) {
+        if (e.buffer_offset > cursor) {
+            std::memset(dst + cursor, 0, e.buffer_offset - cursor);
+        }
+        cursor = e.buffer_offset + e.length;
+    }
+    if (cursor < plan.length) {
+        std::memset(dst + cursor, 0, plan.length - cursor);
+    }
+
+    if (!backend_->AsyncReads()) {
+        co_return co_await ExecuteBatched(plan, dst);
+    }
+
+    // AsyncTask 立即开始执行, 遇到 IO 挂起; 依次启动并在窗口满时等待最早的一个.
+    // 出错后不再启动新读, 但必须等完已启动的 (它们仍在写 dst)
+    Status result = Status::Ok();
+    std::deque<AsyncTask<Status>> inflight;
+    for (const auto& e : plan.extents) {
+        if (!result.OK()) break;
+        if (inflight.size() >= max_parallel_) {
+            auto oldest = std::move(inflight.front());
+            inflight.pop_front();
+            auto status = co_await oldest;
+            if (!status.OK() && result.OK()) result = status;
+            if (!result.OK()) break;
+        }
+        inflight.push_back(ReadExtentInto(e, dst + e.buffer_offset));
+    }
+    while (!inflight.empty()) {
+        auto oldest = std::move(inflight.front());
+        inflight.pop_front();
+        auto status = co_await oldest;
+        if (!status.OK() && result.OK()) result = status;
+    }
+    co_return result;
+}
+
+AsyncTask<Status> ReadPlanner::ExecuteBatched(const ReadPlan& plan, uint8_t* dst) {
+    // 同步后端的读在协程内阻塞, 逐个启动等于串行; 一个窗口的段交给 BatchRead
+    // (S3 为 curl multi) 并发, 结果再拷入 dst
+    std::vector<storage::StorageBackend::ReadRequest> requests;
+    std::vector<storage::StorageBackend::ReadResult> results;
+    for (size_t begin = 0; begin < plan.extents.size(); begin += max_parallel_) {
+        size_t end = std::min<size_t>(begin + max_parallel_, plan.extents.size());
+        requests.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const auto& e = plan.extents[i];
+            requests.push_back({e.storage_key, e.object_offset, e.length});
+        }
+        co_await backend_->BatchRead(requests, &results, max_parallel_);
+
+        for (size_t i = begin; i < end; ++i) {
+            const auto& e = plan.extents[i];
+            auto& result = results[i - begin];
+            if (!result.status.OK()) {
+                LOG_ERROR("read %s failed: %s", e.storage_key.c_str(),
+                          result.status.message().c_str());
+                co_return result.status;
+            }
+            // 对象比 slice 记录的短: 缺失部分按空洞处理
+            uint64_t got = std::min<uint64_t>(result.data.size(), e.length);
+            if (got > 0) std::memcpy(dst + e.buffer_offset, result.data.data(), got);
+            if (got < e.length) std::memset(dst + e.buffer_offset + got, 0, e.length - got);
+        }
+    }
+    co_return Status::Ok();
+}
+
+} // namespace nebulastore::namespace_
@@ -0,0 +1,207 @@
+// ================================
+// 顺序读预读实现
+// ================================
+
+#include "nebulastore/namespace/readahead.h"
+#include "nebulastore/common/logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace nebulastore::namespace_ {
+
+namespace {
+
+// 流未 Close 就释放时, 在后台等完预读块再归还预算
+template<typename Blocks>
+DetachedTask DrainBlocks(Blocks blocks, std::shared_ptr<ReadaheadBudget> budget) {
+    for (auto& block : blocks) {
+        if (block->task) {
+            auto task = std::move(*block->task);
+            co_await task;
+        }
+        budget->Release(block->length);
+    }
+}
+
+} // namespace
+
+ReadStream::ReadStream(FileLayout layout, ReadPlanner* planner,
+                       std::shared_ptr<ReadaheadBudget> budget, ReadaheadOptions options)
+    : layout_(std::move(layout)),
+      planner_(planner),
+      budget_(std::move(budget)),
+      options_(options) {
+    if (options_.block_size == 0) options_.block_size = 1ULL << 20;
+    options_.max_window = std::max(options_.max_window, options_.initial_window);
+    window_ = options_.initial_window;
+    for (const auto& s : layout_.slices) {
+        file_end_ = std::max(file_end_, s.offset + s.size);
+    }
+}
+
+ReadStream::~ReadStream() {
+    // 预读协程写入块缓冲, 块须活到协程结束; 这里可能在 IO 线程上, 不能同步等
+    if (!blocks_.empty()) {
+        DrainBlocks(std::move(blocks_), budget_);
+    }
+}
+
+AsyncTask<void> ReadStream::Close() {
+    co_await DropBefore(UINT64_MAX);
+}
+
+AsyncTask<Status> ReadStream::Read(uint64_t offset, uint64_t size, ByteBuffer* data) {
+    uint64_t got = 0;
+    co_return co_await ReadImpl(offset, size, nullptr, data, &got);
+}
+
+AsyncTask<Status> ReadStream::ReadInto(uint64_t offset, uint64_t size, uint8_t* dst,
+                                       uint64_t* got) {
+    co_return co_await ReadImpl(offset, size, dst, nullptr, got);
+}
+
+AsyncTask<Status> ReadStream::ReadImpl(uint64_t offset, uint64_t size, uint8_t* dst,
+                                       ByteBuffer* data, uint64_t* got) {
+    *got = 0;
+    if (offset >= file_end_ || size == 0) {
+        if (data) *data = ByteBuffer();
+        co_return Status::Ok();
+    }
+    uint64_t end = std::min(offset + size, file_end_);
+    uint64_t len = end - offset;
+
+    // 顺序读放大窗口; 随机读丢弃预读并重置
+    if (offset == next_offset_) {
+        if (++seq_run_ >= 2) window_ = std::min(window_ * 2, options_.max_window);
+    } else {
+        co_await DropBefore(UINT64_MAX);
+        seq_run_ = 0;
+        window_ = options_.initial_window;
+    }
+    next_offset_ = end;
+
+    co_await DropBefore(offset);
+    // 从头读或连续两次顺序读后预读; 本次读完成后再发起
+    bool prefetch = planner_->AsyncReads() &&
+                    (seq_run_ >= 2 || (seq_run_ == 1 && offset == 0));
+
+    // 单个块覆盖整个请求: 返回块的视图, 不拷贝
+    if (!dst && !blocks_.empty() && blocks_.front()->offset <= offset &&
+        end <= blocks_.front()->End()) {
+        auto* block = blocks_.front().get();
+        if ((co_await Wait(block)).OK()) {
+            *data = block->data.Slice(offset - block->offset, len);
+            stats_.hit_bytes += len;
+            co_await DropBefore(end);
+            if (prefetch) Prefetch(end);
+            *got = len;
+            co_return Status::Ok();
+        }
+    }
+
+    ByteBuffer buffer;
+    if (!dst) {
+        buffer = ByteBuffer::Allocate(len);
+        dst = buffer.data();
+    }
+    uint64_t cursor = offset;
+    for (auto& block : blocks_) {
+        if (cursor >= end || block->offset >= end) break;
+        if (block->offset > cursor) {
+            auto status = co_await ReadDirect(cursor, block->offset - cursor,
+                                              dst + (cursor - offset));
+            if (!status.OK()) co_return status;
+            cursor = block->offset;
+        }
+        uint64_t stop = std::min(block->End(), end);
+        if ((co_await Wait(block.get())).OK()) {
+            std::memcpy(dst + (cursor - offset),
+                        block->data.data() + (cursor - block->offset), stop - cursor);
+            stats_.hit_bytes += stop - cursor;
+        } else {
+            // 预读失败不影响本次读, 重新同步读取
+            auto status = co_await ReadDirect(cursor, stop - cursor, dst + (cursor - offset));
+            if (!status.OK()) co_return status;
+        }
+        cursor = stop;
+    }
+    if (cursor < end) {
+        auto status = co_await ReadDirect(cursor, end - cursor, dst + (cursor - offset));
+        if (!status.OK()) co_return status;
+    }
+
+    co_await DropBefore(end);
+    if (data) *data = std::move(buffer);
+    if (prefetch) Prefetch(end);
+    *got = len;
+    co_return Status::Ok();
+}
+
+void ReadStream::Prefetch(uint64_t from) {
+    uint64_t start = std::max(ra_end_, from);
+    uint64_t target = std::min(from + window_, file_end_);
+    while (start < target) {
+        uint64_t n = std::min(options_.block_size, target - start);
+        if (InflightBytes() + n > options_.max_inflight_bytes) break;
+        if (!budget_->TryReserve(n)) break;
+
+        auto block = std::make_unique<Block>();
+        block->offset = start;
+        block->length = n;
+        block->data = ByteBuffer::Allocate(n);
+        auto* raw = block.get();
+        blocks_.push_back(std::move(block));
+        raw->task.emplace(Fetch(raw, ReadPlanner::Plan(layout_, start, n)));
+
+        stats_.prefetched_bytes += n;
+        ra_end_ = start + n;
+        start += n;
+    }
+}
+
+AsyncTask<Status> ReadStream::Fetch(Block* block, ReadPlan plan) {
+    auto status = co_await planner_->Execute(plan, block->data.data());
+    block->done.store(true, std::memory_order_release);
+    co_return status;
+}
+
+AsyncTask<Status> ReadStream::Wait(Block* block) {
+    if (block->task) {
+        auto task = std::move(*block->task);
+        block->task.reset();
+        block->status = co_await task;
+        if (!block->status.OK()) {
+            LOG_WARN("readahead [%lu, +%lu) of inode %lu failed: %s", block->offset,
+                     block->length, layout_.inode_id, block->status.message().c_str());
+        }
+    }
+    co_return block->status;
+}
+
+AsyncTask<Status> ReadStream::ReadDirect(uint64_t offset, uint64_t length, uint8_t* dst) {
+    stats_.miss_bytes += length;
+    auto plan = ReadPlanner::Plan(layout_, offset, length);
+    co_return co_await planner_->Execute(plan, dst);
+}
+
+AsyncTask<void> ReadStream::DropBefore(uint64_t pos) {
+    while (!blocks_.empty() && (pos == UINT64_MAX || blocks_.front()->End() <= pos)) {
+        auto block = std::move(blocks_.front());
+        blocks_.pop_front();
+        co_await Wait(block.get());
+        budget_->Release(block->length);
+    }
+    if (blocks_.empty()) {
+        ra_end_ = 0;
+    }
+}
+
+uint64_t ReadStream::InflightBytes() const {
+    uint64_t bytes = 0;
+    for (const auto& block : blocks_) {
+        if (!block->done.load(std::memory_order_acquire)) bytes += block->length;
+    }
+    return bytes;
+}
+
+} // namespace nebulastore::namespace_
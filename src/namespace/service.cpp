@@ -51,7 +51,12 @@ PathConverter::ParsedPath PathConverter::Parse(const std::string& path) {
 NamespaceService::NamespaceService(Config config)
     : converter_(config.default_bucket),
       metadata_service_(std::move(config.metadata_service)),
-      storage_backend_(std::move(config.storage_backend)) {}
+      storage_backend_(std::move(config.storage_backend)),
+      planner_(storage_backend_.get(), config.max_parallel_reads),
+      max_inflight_uploads_(config.max_inflight_uploads),
+      readahead_options_(config.readahead),
+      readahead_budget_(std::make_shared<ReadaheadBudget>(config.readahead.memory_budget)),
+      compactor_(std::move(config.compactor)) {}
 
 AsyncTask<Status> NamespaceService::GetAttr(const std::string& path, InodeAttr* attr) {
     auto parsed = converter_.Parse(path);
@@ -77,25 +82,46 @@ AsyncTask<Status> NamespaceService::Read(const std::string& path, uint64_t offse
         co_return status;
     }
 
+    // 只取读取范围涉及的 chunk 的布局
     FileLayout layout;
-    status = co_await metadata_service_->GetLayout(inode_id, &layout);
+    status = co_await metadata_service_->GetLayoutRange(inode_id, offset, size, &layout);
     if (!status.OK()) {
         co_return status;
     }
 
-    // Find relevant slices
-    for (const auto& slice : layout.slices) {
-        if (offset >= slice.offset && offset < slice.offset + slice.size) {
-            uint64_t slice_offset = offset - slice.offset;
-            uint64_t read_size = std::min(size, slice.size - slice_offset);
-            co_return co_await storage_backend_->GetRange(slice.storage_key, slice_offset, read_size, data);
-        }
+    if (compactor_) compactor_->Touch(inode_id);
+
+    // 覆盖所有相交的 slice: 并发读入同一块缓冲区, 空洞补零, 越过 EOF 时短读
+    auto plan = ReadPlanner::Plan(layout, offset, size);
+    ByteBuffer buffer = ByteBuffer::Allocate(plan.length);
+    status = co_await planner_.Execute(plan, buffer.data());
+    if (!status.OK()) {
+        co_return status;
     }
-    co_return Status::NotFound("No slice found for offset");
+    *data = std::move(buffer);
+    co_return Status::Ok();
 }
 
 AsyncTask<Status> NamespaceService::Write(const std::string& path, const ByteBuffer& data,
                                            uint64_t offset) {
+    std::shared_ptr<SliceWriter> writer;
+    auto status = co_await OpenWriter(path, &writer);
+    if (!status.OK()) {
+        co_return status;
+    }
+    status = co_await writer->Write(offset, data);
+    if (status.OK()) {
+        status = co_await writer->Flush();
+    }
+    // 失败时可能仍有在途上传, 释放写入器前等它们结束
+    if (!status.OK()) {
+        co_await writer->Abort();
+    }
+    co_return status;
+}
+
+AsyncTask<Status> NamespaceService::OpenReader(const std::string& path,
+                                                std::shared_ptr<ReadStream>* reader) {
     auto parsed = converter_.Parse(path);
     InodeID inode_id;
     auto status = co_await metadata_service_->LookupPath(parsed.posix_path, &inode_id);
@@ -103,21 +129,41 @@ AsyncTask<Status> NamespaceService::Write(const std::string& path, const ByteBuf
         co_return status;
     }
 
-    // Generate storage key
-    std::string storage_key = "chunks/" + std::to_string(inode_id) + "/" + std::to_string(offset);
-    status = co_await storage_backend_->Put(storage_key, data);
+    FileLayout layout;
+    status = co_await metadata_service_->GetLayout(inode_id, &layout);
+    if (!status.OK()) {
+        co_return status;
+    }
+
+    if (compactor_) compactor_->Touch(inode_id);
+    *reader = std::make_shared<ReadStream>(std::move(layout), &planner_, readahead_budget_,
+                                           readahead_options_);
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> NamespaceService::OpenWriter(const std::string& path,
+                                                std::shared_ptr<SliceWriter>* writer) {
+    auto parsed = converter_.Parse(path);
+    InodeID inode_id;
+    auto status = co_await metadata_service_->LookupPath(parsed.posix_path, &inode_id);
     if (!status.OK()) {
         co_return status;
     }
 
-    // Add slice metadata
-    SliceInfo slice{0, offset, data.size(), storage_key};
-    status = co_await metadata_service_->AddSlice(inode_id, slice);
+    // 只需要 chunk 大小, 不扫描 slice
+    uint64_t chunk_size = 0;
+    status = co_await metadata_service_->GetChunkSize(inode_id, &chunk_size);
     if (!status.OK()) {
         co_return status;
     }
 
-    co_return co_await metadata_service_->UpdateSize(inode_id, offset + data.size());
+    if (compactor_) compactor_->Touch(inode_id);
+
+    SliceWriter::Options options;
+    if (chunk_size > 0) options.chunk_size = chunk_size;
+    options.max_inflight_uploads = max_inflight_uploads_;
+    *writer = std::make_shared<SliceWriter>(inode_id, metadata_service_, storage_backend_, options);
+    co_return Status::Ok();
 }
 
 AsyncTask<Status> NamespaceService::Readdir(const std::string& path,
@@ -0,0 +1,211 @@
+// ================================
+// 写回缓冲 slice 写入器
+// ================================
+
+#include "nebulastore/namespace/slice_writer.h"
+#include "nebulastore/common/logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace nebulastore::namespace_ {
+
+// 高位为启动时间 (毫秒), 避免重启后与旧对象重名
+uint64_t NextSliceId() {
+    static std::atomic<uint64_t> next{NowInMilliSeconds() << 20};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+namespace {
+
+// 写入器未 Abort 就释放时, 在后台等完剩余上传
+DetachedTask DrainUploads(std::deque<AsyncTask<Status>> uploads) {
+    for (auto& upload : uploads) {
+        co_await upload;
+    }
+}
+
+} // namespace
+
+SliceWriter::SliceWriter(InodeID inode,
+                         std::shared_ptr<metadata::MetadataService> metadata,
+                         std::shared_ptr<storage::StorageBackend> backend,
+                         Options options)
+    : inode_(inode),
+      metadata_(std::move(metadata)),
+      backend_(std::move(backend)),
+      options_(options) {
+    if (options_.chunk_size == 0) options_.chunk_size = 4ULL << 20;
+    if (options_.max_inflight_uploads == 0) options_.max_inflight_uploads = 1;
+    if (options_.max_open_slices == 0) options_.max_open_slices = 1;
+}
+
+SliceWriter::~SliceWriter() {
+    if (!open_.empty() || !sealed_.empty()) {
+        LOG_WARN("slice writer for inode %lu destroyed with unflushed data", inode_);
+    }
+    if (!uploads_.empty()) {
+        LOG_WARN("slice writer for inode %lu destroyed with %zu uploads in flight",
+                 inode_, uploads_.size());
+        DrainUploads(std::move(uploads_));
+    }
+}
+
+AsyncTask<Status> SliceWriter::Write(uint64_t offset, const ByteBuffer& data) {
+    if (!error_.OK()) {
+        co_return error_;
+    }
+
+    const uint8_t* src = data.data();
+    uint64_t pos = offset;
+    uint64_t remaining = data.size();
+    while (remaining > 0) {
+        uint64_t chunk = pos / options_.chunk_size;
+        uint64_t chunk_end = (chunk + 1) * options_.chunk_size;
+        uint64_t n = std::min(remaining, chunk_end - pos);
+
+        // 不连续: 旧 slice 先封口, 保证后写的 slice 排在后面
+        auto it = open_.find(chunk);
+        if (it != open_.end() && it->second.offset + it->second.length != pos) {
+            auto status = co_await Seal(chunk);
+            if (!status.OK()) {
+                co_return status;
+            }
+            it = open_.end();
+        }
+
+        if (it == open_.end()) {
+            if (open_.size() >= options_.max_open_slices) {
+                auto oldest = std::min_element(open_.begin(), open_.end(),
+                    [](const auto& a, const auto& b) { return a.second.seq < b.second.seq; });
+                auto status = co_await Seal(oldest->first);
+                if (!status.OK()) {
+                    co_return status;
+                }
+            }
+            OpenSlice slice;
+            slice.offset = pos;
+            // 未初始化的内存按需提交, 预留到 chunk 末尾不占实际页
+            slice.buffer = ByteBuffer::Allocate(chunk_end - pos);
+            slice.seq = next_seq_++;
+            it = open_.emplace(chunk, std::move(slice)).first;
+        }
+
+        auto& slice = it->second;
+        std::memcpy(slice.buffer.data() + slice.length, src, n);
+        slice.length += n;
+        buffered_bytes_ += n;
+
+        // 写满 chunk 立即封口上传
+        if (slice.offset + slice.length == chunk_end) {
+            auto status = co_await Seal(chunk);
+            if (!status.OK()) {
+                co_return status;
+            }
+        }
+
+        src += n;
+        pos += n;
+        remaining -= n;
+    }
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> SliceWriter::Flush() {
+    if (!error_.OK()) {
+        co_return error_;
+    }
+
+    // 按打开顺序封口剩余 slice
+    std::vector<std::pair<uint64_t, uint64_t>> order;   // (seq, chunk)
+    order.reserve(open_.size());
+    for (const auto& [chunk, slice] : open_) {
+        order.emplace_back(slice.seq, chunk);
+    }
+    std::sort(order.begin(), order.end());
+    for (const auto& [seq, chunk] : order) {
+        auto status = co_await Seal(chunk);
+        if (!status.OK()) {
+            co_return status;
+        }
+    }
+
+    // 出错也要等完全部上传
+    while (!uploads_.empty()) {
+        co_await WaitOldest();
+    }
+    if (!error_.OK()) {
+        co_return error_;
+    }
+
+    if (sealed_.empty()) {
+        co_return Status::Ok();
+    }
+    // 提交失败时保留待提交列表, 可重试 Flush
+    auto status = co_await metadata_->AddSlices(inode_, sealed_, max_end_);
+    if (!status.OK()) {
+        LOG_ERROR("commit %zu slices for inode %lu failed: %s",
+                  sealed_.size(), inode_, status.message().c_str());
+        co_return status;
+    }
+    sealed_.clear();
+    max_end_ = 0;
+    co_return Status::Ok();
+}
+
+AsyncTask<void> SliceWriter::Abort() {
+    open_.clear();
+    sealed_.clear();
+    buffered_bytes_ = 0;
+    max_end_ = 0;
+    while (!uploads_.empty()) {
+        auto oldest = std::move(uploads_.front());
+        uploads_.pop_front();
+        co_await oldest;
+    }
+}
+
+AsyncTask<Status> SliceWriter::Seal(uint64_t chunk_index) {
+    auto it = open_.find(chunk_index);
+    if (it == open_.end()) {
+        co_return Status::Ok();
+    }
+    OpenSlice slice = std::move(it->second);
+    open_.erase(it);
+    buffered_bytes_ -= slice.length;
+    if (slice.length == 0) {
+        co_return Status::Ok();
+    }
+
+    uint64_t slice_id = NextSliceId();
+    std::string key = SliceStorageKey(inode_, slice_id);
+    sealed_.push_back(SliceInfo{slice_id, slice.offset, slice.length, key});
+    max_end_ = std::max(max_end_, slice.offset + slice.length);
+
+    if (uploads_.size() >= options_.max_inflight_uploads) {
+        auto status = co_await WaitOldest();
+        if (!status.OK()) {
+            co_return status;
+        }
+    }
+    uploads_.push_back(Upload(backend_, std::move(key), slice.buffer.Slice(0, slice.length)));
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> SliceWriter::Upload(std::shared_ptr<storage::StorageBackend> backend,
+                                      std::string key, ByteBuffer data) {
+    co_return co_await backend->Put(key, data);
+}
+
+AsyncTask<Status> SliceWriter::WaitOldest() {
+    auto oldest = std::move(uploads_.front());
+    uploads_.pop_front();
+    auto status = co_await oldest;
+    if (!status.OK()) {
+        LOG_ERROR("slice upload for inode %lu failed: %s", inode_, status.message().c_str());
+        if (error_.OK()) error_ = status;
+    }
+    co_return status;
+}
+
+} // namespace nebulastore::namespace_
@@ -40,24 +40,37 @@ static int fuse_readdir_impl(const char* path, void* buf, fuse_fill_dir_t filler
 }
 
 static int fuse_open_impl(const char* path, struct fuse_file_info* fi) {
-    InodeAttr attr;
-    if (!g_client->GetAttr(path, &attr).Get().OK()) return -ENOENT;
-    fi->fh = attr.inode_id;
+    uint64_t fh = 0;
+    if (!g_client->Open(path, &fh).Get().OK()) return -ENOENT;
+    fi->fh = fh;
     return 0;
 }
 
-static int fuse_release_impl(const char*, struct fuse_file_info*) { return 0; }
+static int fuse_release_impl(const char*, struct fuse_file_info* fi) {
+    return g_client->Release(fi->fh).Get().OK() ? 0 : -EIO;
+}
+
+static int fuse_flush_impl(const char*, struct fuse_file_info* fi) {
+    return g_client->Flush(fi->fh).Get().OK() ? 0 : -EIO;
+}
 
-static int fuse_read_impl(const char* path, char* buf, size_t size, off_t offset, struct fuse_file_info*) {
-    ByteBuffer data;
-    if (!g_client->Read(path, offset, size, &data).Get().OK()) return -EIO;
-    std::memcpy(buf, data.data(), data.size());
-    return static_cast<int>(data.size());
+static int fuse_fsync_impl(const char*, int, struct fuse_file_info* fi) {
+    return g_client->Flush(fi->fh).Get().OK() ? 0 : -EIO;
 }
 
-static int fuse_write_impl(const char* path, const char* buf, size_t size, off_t offset, struct fuse_file_info*) {
-    ByteBuffer data(buf, size);
-    if (!g_client->Write(path, data, offset).Get().OK()) return -EIO;
+static int fuse_read_impl(const char*, char* buf, size_t size, off_t offset, struct fuse_file_info* fi) {
+    // 直接读入内核传入的缓冲区, 不经中间 ByteBuffer
+    uint64_t got = 0;
+    if (!g_client->Read(fi->fh, offset, size, reinterpret_cast<uint8_t*>(buf), &got).Get().OK()) {
+        return -EIO;
+    }
+    return static_cast<int>(got);
+}
+
+static int fuse_write_impl(const char*, const char* buf, size_t size, off_t offset, struct fuse_file_info* fi) {
+    // 写入器会拷贝进 chunk 缓冲, 直接借用内核传入的缓冲区
+    auto data = ByteBuffer::Unowned(buf, size);
+    if (!g_client->Write(fi->fh, data, offset).Get().OK()) return -EIO;
     return static_cast<int>(size);
 }
 
@@ -91,6 +104,8 @@ public:
         ops_.readdir = fuse_readdir_impl;
         ops_.open = fuse_open_impl;
         ops_.release = fuse_release_impl;
+        ops_.flush = fuse_flush_impl;
+        ops_.fsync = fuse_fsync_impl;
         ops_.read = fuse_read_impl;
         ops_.write = fuse_write_impl;
         ops_.mkdir = fuse_mkdir_impl;
@@ -202,6 +217,95 @@ AsyncTask<Status> FuseClient::Readdir(const std::string& path, std::vector<Dentr
     co_return co_await config_.namespace_service->Readdir(path, entries);
 }
 
+AsyncTask<Status> FuseClient::Open(const std::string& path, uint64_t* fh) {
+    InodeAttr attr;
+    auto status = co_await config_.namespace_service->GetAttr(path, &attr);
+    if (!status.OK()) {
+        co_return status;
+    }
+    auto file = std::make_shared<OpenFile>();
+    file->path = path;
+    std::lock_guard<std::mutex> lock(handles_mutex_);
+    *fh = next_fh_++;
+    handles_[*fh] = std::move(file);
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> FuseClient::Write(uint64_t fh, const ByteBuffer& data, uint64_t offset) {
+    auto file = FindHandle(fh);
+    if (!file) {
+        co_return Status::InvalidArgument("Bad file handle");
+    }
+    if (!file->writer) {
+        auto status = co_await config_.namespace_service->OpenWriter(file->path, &file->writer);
+        if (!status.OK()) {
+            co_return status;
+        }
+    }
+    co_return co_await file->writer->Write(offset, data);
+}
+
+AsyncTask<Status> FuseClient::Read(uint64_t fh, uint64_t offset, uint64_t size, uint8_t* dst,
+                                   uint64_t* got) {
+    auto file = FindHandle(fh);
+    if (!file) {
+        co_return Status::InvalidArgument("Bad file handle");
+    }
+    // 同一句柄有缓冲的写时先提交, 保证读到; 只读句柄不走 Flush
+    if (file->writer && (file->writer->buffered_bytes() > 0 || file->writer->pending_slices() > 0)) {
+        auto status = co_await Flush(fh);
+        if (!status.OK()) {
+            co_return status;
+        }
+    }
+    if (!file->reader) {
+        auto status = co_await config_.namespace_service->OpenReader(file->path, &file->reader);
+        if (!status.OK()) {
+            co_return status;
+        }
+    }
+    co_return co_await file->reader->ReadInto(offset, size, dst, got);
+}
+
+AsyncTask<Status> FuseClient::Flush(uint64_t fh) {
+    auto file = FindHandle(fh);
+    if (!file) {
+        co_return Status::InvalidArgument("Bad file handle");
+    }
+    if (!file->writer) {
+        co_return Status::Ok();
+    }
+    bool dirty = file->writer->buffered_bytes() > 0 || file->writer->pending_slices() > 0;
+    auto status = co_await file->writer->Flush();
+    // 布局已变, 读流缓存的布局与预读数据失效; 先等完在途预读再释放
+    if (dirty && file->reader) {
+        auto reader = std::move(file->reader);
+        co_await reader->Close();
+    }
+    co_return status;
+}
+
+AsyncTask<Status> FuseClient::Release(uint64_t fh) {
+    auto status = co_await Flush(fh);
+    // 提交失败时写入器可能仍有在途上传, 释放前等它们结束
+    auto file = FindHandle(fh);
+    if (!status.OK() && file && file->writer) {
+        co_await file->writer->Abort();
+    }
+    if (file && file->reader) {
+        co_await file->reader->Close();
+    }
+    std::lock_guard<std::mutex> lock(handles_mutex_);
+    handles_.erase(fh);
+    co_return status;
+}
+
+std::shared_ptr<FuseClient::OpenFile> FuseClient::FindHandle(uint64_t fh) {
+    std::lock_guard<std::mutex> lock(handles_mutex_);
+    auto it = handles_.find(fh);
+    return it == handles_.end() ? nullptr : it->second;
+}
+
 Status FuseClient::FindSlice(const FileLayout& layout, uint64_t offset, SliceInfo* slice) {
     for (const auto& s : layout.slices) {
         if (offset >= s.offset && offset < s.offset + s.size) {
@@ -112,7 +112,7 @@ private:
         ByteBuffer data;
         auto task = gateway_->GetObject(bucket, key, &data);
         // Synchronous wait (simplified)
-        auto status = task.get();
+        auto status = task.Get();
 
         if (!status.OK()) {
             if (status.code() == ErrorCode::kNotFound) {
@@ -121,13 +121,14 @@ private:
             return ErrorResponse("InternalError", status.message());
         }
 
-        return data.ToString();
+        // 底层为字符串时直接交出, 否则只复制一次
+        return std::move(data).ToString();
     }
 
     std::string HandleListObjects(const std::string& bucket) {
         std::vector<S3Object> objects;
         auto task = gateway_->ListObjects(bucket, "", &objects);
-        auto status = task.get();
+        auto status = task.Get();
 
         if (!status.OK()) {
             if (status.code() == ErrorCode::kNotFound) {
@@ -166,9 +167,10 @@ private:
         }
 
         // PutObject
-        ByteBuffer data(body.data(), body.size());
+        // 同步等待写完, 请求体在此期间有效, 借用即可
+        auto data = ByteBuffer::Unowned(body.data(), body.size());
         auto task = gateway_->PutObject(bucket, key, data);
-        auto status = task.get();
+        auto status = task.Get();
 
         if (!status.OK()) {
             return ErrorResponse("InternalError", status.message());
@@ -189,7 +191,7 @@ private:
 
         // DeleteObject
         auto task = gateway_->DeleteObject(bucket, key);
-        auto status = task.get();
+        auto status = task.Get();
 
         if (!status.OK() && status.code() != ErrorCode::kNotFound) {
             return ErrorResponse("InternalError", status.message());
@@ -211,7 +213,7 @@ private:
         // HeadObject
         InodeAttr attr;
         auto task = gateway_->HeadObject(bucket, key, &attr);
-        auto status = task.get();
+        auto status = task.Get();
 
         if (!status.OK()) {
             if (status.code() == ErrorCode::kNotFound) {
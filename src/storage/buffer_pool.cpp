@@ -0,0 +1,253 @@
+// ================================
+// 注册缓冲池实现
+// ================================
+
+#include "nebulastore/storage/buffer_pool.h"
+#include "nebulastore/common/logger.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace nebulastore::storage {
+
+namespace {
+
+constexpr size_t kPageSize = 4096;
+constexpr size_t kHugePageSize = 2ULL << 20;
+// io_uring 单个固定缓冲区上限
+constexpr size_t kMaxFixedBufferSize = 1ULL << 30;
+
+size_t RoundUp(size_t v, size_t align) {
+    return (v + align - 1) / align * align;
+}
+
+}  // namespace
+
+struct BufferPool::Region {
+    int fd = -1;
+    uint8_t* base = nullptr;
+    size_t size = 0;
+    size_t block_size = 0;
+    size_t segment_size = 0;    // 注册段大小 (块大小的整数倍, 不超过 1GB)
+    bool hugepages = false;
+    std::atomic<bool> registered{false};
+
+    mutable std::mutex mutex;
+    std::vector<uint8_t> used;  // 每块一个占用标记
+    size_t free_count = 0;
+    size_t hint = 0;            // 下次首次适配的起点
+
+    ~Region() {
+        if (base) ::munmap(base, size);
+        if (fd >= 0) ::close(fd);
+    }
+
+    size_t BlocksPerSegment() const { return segment_size / block_size; }
+
+    // 首次适配 n 个连续空闲块 (不跨注册段), 失败返回 SIZE_MAX
+    size_t Allocate(size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (n > free_count) return SIZE_MAX;
+        size_t total = used.size();
+        size_t per_seg = BlocksPerSegment();
+        for (size_t scanned = 0, i = hint; scanned < total;) {
+            if (i + n > total) {
+                scanned += total - i;
+                i = 0;
+                continue;
+            }
+            if (i / per_seg != (i + n - 1) / per_seg) {
+                size_t next = (i / per_seg + 1) * per_seg;
+                scanned += next - i;
+                i = next;
+                continue;
+            }
+            size_t run = 0;
+            while (run < n && !used[i + run]) ++run;
+            if (run == n) {
+                std::fill_n(used.begin() + i, n, 1);
+                free_count -= n;
+                hint = (i + n) % total;
+                return i;
+            }
+            scanned += run + 1;
+            i += run + 1;
+        }
+        return SIZE_MAX;
+    }
+
+    void Release(size_t first, size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::fill_n(used.begin() + first, n, 0);
+        free_count += n;
+    }
+};
+
+// ================================
+// PooledBuffer
+// ================================
+
+struct PooledBuffer::Lease {
+    std::shared_ptr<BufferPool::Region> region;
+    size_t first = 0;
+    size_t count = 0;
+
+    ~Lease() { region->Release(first, count); }
+};
+
+PooledBuffer PooledBuffer::Slice(size_t offset, size_t len) const {
+    PooledBuffer out;
+    if (offset > size_) offset = size_;
+    out.lease_ = lease_;
+    out.data_ = data_ + offset;
+    out.size_ = std::min(len, size_ - offset);
+    return out;
+}
+
+int PooledBuffer::buf_index() const {
+    if (!lease_ || !lease_->region->registered) return -1;
+    return static_cast<int>(pool_offset() / lease_->region->segment_size);
+}
+
+uint64_t PooledBuffer::pool_offset() const {
+    return lease_ ? static_cast<uint64_t>(data_ - lease_->region->base) : 0;
+}
+
+// ================================
+// BufferPool
+// ================================
+
+BufferPool::BufferPool(std::shared_ptr<Region> region) : region_(std::move(region)) {}
+
+BufferPool::~BufferPool() = default;
+
+Result<std::unique_ptr<BufferPool>> BufferPool::Create(Config config) {
+    if (config.block_size == 0 || config.num_blocks == 0) {
+        return Err<std::unique_ptr<BufferPool>>(ErrorCode::kInvalidArgument,
+                                                "buffer pool size must be > 0");
+    }
+
+    auto region = std::make_shared<Region>();
+    size_t block_size = RoundUp(config.block_size, kPageSize);
+
+    // 大页: 块对齐到 2MB, 映射失败 (大页不足/不支持) 时回退
+    if (config.use_hugepages) {
+        size_t huge_block = RoundUp(block_size, kHugePageSize);
+        size_t size = huge_block * config.num_blocks;
+        int fd = ::memfd_create(config.name.c_str(), MFD_CLOEXEC | MFD_HUGETLB | MFD_ALLOW_SEALING);
+        if (fd >= 0 && ::ftruncate(fd, static_cast<off_t>(size)) == 0 &&
+            ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) == 0) {
+            void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, fd, 0);
+            if (p != MAP_FAILED) {
+                region->fd = fd;
+                region->base = static_cast<uint8_t*>(p);
+                region->size = size;
+                region->hugepages = true;
+                block_size = huge_block;
+            }
+        }
+        if (!region->base) {
+            int err = errno;
+            if (fd >= 0) ::close(fd);
+            LOG_INFO("buffer pool: hugepages unavailable (%s), using regular pages",
+                     strerror(err));
+        }
+    }
+
+    if (!region->base) {
+        size_t size = block_size * config.num_blocks;
+        int fd = ::memfd_create(config.name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd < 0) {
+            return Err<std::unique_ptr<BufferPool>>(
+                ErrorCode::kIOError, std::string("memfd_create failed: ") + strerror(errno));
+        }
+        region->fd = fd;
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            return Err<std::unique_ptr<BufferPool>>(
+                ErrorCode::kNoSpace, std::string("buffer pool ftruncate failed: ") + strerror(errno));
+        }
+        // 池可注册给 usrbio 服务端映射, 封住缩小 (服务端拒绝未封的 memfd)
+        if (::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) != 0) {
+            return Err<std::unique_ptr<BufferPool>>(
+                ErrorCode::kIOError, std::string("buffer pool seal failed: ") + strerror(errno));
+        }
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, 0);
+        if (p == MAP_FAILED) {
+            return Err<std::unique_ptr<BufferPool>>(
+                ErrorCode::kNoSpace, std::string("buffer pool mmap failed: ") + strerror(errno));
+        }
+        region->base = static_cast<uint8_t*>(p);
+        region->size = size;
+        ::madvise(p, size, MADV_HUGEPAGE);   // 透明大页提示, 失败无妨
+    }
+
+    region->block_size = block_size;
+    region->segment_size = std::max<size_t>(1, kMaxFixedBufferSize / block_size) * block_size;
+    region->used.assign(config.num_blocks, 0);
+    region->free_count = config.num_blocks;
+
+    LOG_INFO("buffer pool created: %zu x %zu bytes (hugepages=%d)",
+             config.num_blocks, block_size, region->hugepages ? 1 : 0);
+    return std::unique_ptr<BufferPool>(new BufferPool(std::move(region)));
+}
+
+Result<PooledBuffer> BufferPool::Acquire(size_t size) {
+    size_t n = std::max<size_t>(1, (size + region_->block_size - 1) / region_->block_size);
+    if (n > region_->BlocksPerSegment()) {
+        return Err<PooledBuffer>(ErrorCode::kInvalidArgument, "buffer larger than pool segment");
+    }
+    size_t first = region_->Allocate(n);
+    if (first == SIZE_MAX) {
+        return Err<PooledBuffer>(ErrorCode::kNoSpace, "buffer pool exhausted");
+    }
+
+    PooledBuffer buffer;
+    buffer.lease_ = std::make_shared<PooledBuffer::Lease>();
+    buffer.lease_->region = region_;
+    buffer.lease_->first = first;
+    buffer.lease_->count = n;
+    buffer.data_ = region_->base + first * region_->block_size;
+    buffer.size_ = size;
+    return buffer;
+}
+
+bool BufferPool::RegisterWith(IoEngine* engine) {
+    if (region_->block_size > kMaxFixedBufferSize) return false;
+    std::vector<iovec> iovs;
+    for (size_t off = 0; off < region_->size; off += region_->segment_size) {
+        iovs.push_back({region_->base + off, std::min(region_->segment_size, region_->size - off)});
+    }
+    region_->registered = engine->RegisterBuffers(iovs);
+    return region_->registered;
+}
+
+int BufferPool::FixedIndex(const void* ptr, size_t len) const {
+    if (!region_->registered || len == 0) return -1;
+    auto* p = static_cast<const uint8_t*>(ptr);
+    if (p < region_->base || p + len > region_->base + region_->size) return -1;
+    size_t off = static_cast<size_t>(p - region_->base);
+    size_t seg = off / region_->segment_size;
+    if ((off + len - 1) / region_->segment_size != seg) return -1;
+    return static_cast<int>(seg);
+}
+
+int BufferPool::fd() const { return region_->fd; }
+uint8_t* BufferPool::base() const { return region_->base; }
+size_t BufferPool::capacity() const { return region_->size; }
+size_t BufferPool::block_size() const { return region_->block_size; }
+bool BufferPool::hugepages() const { return region_->hugepages; }
+
+size_t BufferPool::free_blocks() const {
+    std::lock_guard<std::mutex> lock(region_->mutex);
+    return region_->free_count;
+}
+
+} // namespace nebulastore::storage
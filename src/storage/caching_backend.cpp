@@ -0,0 +1,604 @@
+// ================================
+// 本地磁盘块缓存实现
+// ================================
+
+#include "nebulastore/storage/caching_backend.h"
+#include "nebulastore/common/logger.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+
+namespace nebulastore::storage {
+
+namespace {
+
+constexpr const char* kTempSuffix = ".tmp";
+
+uint64_t Mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+uint64_t BlockHash(const std::string& key, uint64_t block) {
+    return Mix64(std::hash<std::string>{}(key) ^ Mix64(block + 1));
+}
+
+bool EndsWith(const std::string& s, const char* suffix) {
+    size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+}  // namespace
+
+// ================================
+// FrequencySketch
+// ================================
+
+FrequencySketch::FrequencySketch(size_t expected_entries) {
+    width_ = 16;
+    while (width_ < expected_entries) width_ <<= 1;
+    table_.assign(kDepth * width_, 0);
+    sample_size_ = 10 * width_;
+}
+
+size_t FrequencySketch::Index(uint64_t hash, int row) const {
+    static constexpr uint64_t kSeeds[kDepth] = {
+        0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL,
+        0x165667b19e3779f9ULL, 0xd6e8feb86659fd93ULL,
+    };
+    uint64_t h = Mix64(hash + kSeeds[row]);
+    return row * width_ + (h & (width_ - 1));
+}
+
+void FrequencySketch::Record(uint64_t hash) {
+    bool added = false;
+    for (int row = 0; row < kDepth; ++row) {
+        auto& c = table_[Index(hash, row)];
+        if (c < kMaxCount) {
+            ++c;
+            added = true;
+        }
+    }
+    if (added && ++additions_ >= sample_size_) {
+        Age();
+    }
+}
+
+uint32_t FrequencySketch::Estimate(uint64_t hash) const {
+    uint32_t freq = kMaxCount;
+    for (int row = 0; row < kDepth; ++row) {
+        freq = std::min<uint32_t>(freq, table_[Index(hash, row)]);
+    }
+    return freq;
+}
+
+void FrequencySketch::Age() {
+    for (auto& c : table_) c >>= 1;
+    additions_ /= 2;
+}
+
+// ================================
+// CachingBackend
+// ================================
+
+CachingBackend::CachingBackend(Config config, std::shared_ptr<StorageBackend> remote)
+    : config_(std::move(config)),
+      remote_(std::move(remote)),
+      sketch_(config_.block_size ? config_.capacity_bytes / config_.block_size : 0) {
+    if (config_.block_size == 0) config_.block_size = 1ULL << 20;
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.cache_dir, ec);
+    if (ec) {
+        LOG_ERROR("Failed to create cache dir %s: %s", config_.cache_dir.c_str(),
+                  ec.message().c_str());
+    }
+
+    LocalBackend::Config disk_config;
+    disk_config.data_dir = config_.cache_dir;
+    disk_config.io = config_.io;
+    disk_ = std::make_unique<LocalBackend>(std::move(disk_config));
+
+    Rebuild();
+}
+
+CachingBackend::~CachingBackend() {
+    WaitForFills();
+}
+
+void CachingBackend::WaitForFills() {
+    std::unique_lock<std::mutex> lock(fill_mutex_);
+    fill_cv_.wait(lock, [this] { return pending_fills_ == 0; });
+}
+
+std::string CachingBackend::BlockKey(const std::string& key, uint64_t block) {
+    return key + "@" + std::to_string(block);
+}
+
+void CachingBackend::Rebuild() {
+    namespace fs = std::filesystem;
+
+    struct Found {
+        fs::file_time_type mtime;
+        std::string key;
+        uint64_t block;
+        uint64_t size;
+    };
+    std::vector<Found> found;
+
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(config_.cache_dir, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        auto rel = fs::relative(it->path(), config_.cache_dir, ec).generic_string();
+        if (ec) continue;
+
+        // 崩溃留下的半成品
+        if (EndsWith(rel, kTempSuffix)) {
+            fs::remove(it->path(), ec);
+            continue;
+        }
+        auto at = rel.rfind('@');
+        if (at == std::string::npos || at == 0) continue;
+        uint64_t block = 0;
+        auto [end, err] = std::from_chars(rel.data() + at + 1, rel.data() + rel.size(), block);
+        if (err != std::errc() || end != rel.data() + rel.size()) continue;
+
+        uint64_t size = it->file_size(ec);
+        if (ec || size == 0 || size > config_.block_size) continue;
+        found.push_back({it->last_write_time(ec), rel.substr(0, at), block, size});
+    }
+
+    // 旧的先插入, 最新的落在 LRU 头部
+    std::sort(found.begin(), found.end(),
+              [](const Found& a, const Found& b) { return a.mtime < b.mtime; });
+
+    std::vector<std::string> victims;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& f : found) {
+            InsertLocked(f.key, f.block, f.size);
+        }
+        while (stats_.used_bytes > config_.capacity_bytes && !lru_.empty()) {
+            auto victim = lru_.back();
+            victims.push_back(BlockKey(victim.key, victim.block));
+            EraseLocked(victim.key, victim.block);
+        }
+    }
+    for (const auto& v : victims) {
+        fs::remove(fs::path(config_.cache_dir) / v, ec);
+    }
+
+    LOG_INFO("block cache %s: rebuilt %lu blocks (%lu bytes)", config_.cache_dir.c_str(),
+             stats_.cached_blocks, stats_.used_bytes);
+}
+
+// ================================
+// 索引
+// ================================
+
+void CachingBackend::InsertLocked(const std::string& key, uint64_t block, uint64_t size) {
+    auto& blocks = index_[key];
+    if (blocks.count(block)) return;
+    lru_.push_front(BlockRef{key, block});
+    blocks.emplace(block, Entry{size, lru_.begin()});
+    stats_.used_bytes += size;
+    ++stats_.cached_blocks;
+}
+
+void CachingBackend::EraseLocked(const std::string& key, uint64_t block) {
+    auto it = index_.find(key);
+    if (it == index_.end()) return;
+    auto bit = it->second.find(block);
+    if (bit == it->second.end()) return;
+    stats_.used_bytes -= bit->second.size;
+    --stats_.cached_blocks;
+    lru_.erase(bit->second.lru);
+    it->second.erase(bit);
+    if (it->second.empty()) index_.erase(it);
+}
+
+bool CachingBackend::Lookup(const std::string& key, uint64_t block, uint64_t* size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sketch_.Record(BlockHash(key, block));
+    auto it = index_.find(key);
+    if (it == index_.end()) return false;
+    auto bit = it->second.find(block);
+    if (bit == it->second.end()) return false;
+    lru_.splice(lru_.begin(), lru_, bit->second.lru);
+    *size = bit->second.size;
+    return true;
+}
+
+bool CachingBackend::Contains(const std::string& key, uint64_t block) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    return it != index_.end() && it->second.count(block) > 0;
+}
+
+bool CachingBackend::ContainsRange(const std::string& key, uint64_t offset,
+                                   uint64_t size) const {
+    const uint64_t bs = config_.block_size;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) return false;
+    for (uint64_t b = offset / bs; b <= (offset + size - 1) / bs; ++b) {
+        auto bit = it->second.find(b);
+        if (bit == it->second.end()) return false;
+        if (bit->second.size < bs) break;
+    }
+    return true;
+}
+
+void CachingBackend::Forget(const std::string& key, uint64_t block) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EraseLocked(key, block);
+}
+
+void CachingBackend::InvalidateObject(const std::string& key) {
+    std::vector<uint64_t> blocks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return;
+        for (const auto& [block, entry] : it->second) blocks.push_back(block);
+        for (auto block : blocks) EraseLocked(key, block);
+    }
+    std::error_code ec;
+    for (auto block : blocks) {
+        std::filesystem::remove(std::filesystem::path(config_.cache_dir) / BlockKey(key, block), ec);
+    }
+}
+
+CachingBackend::Stats CachingBackend::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// ================================
+// 读路径
+// ================================
+
+AsyncTask<Status> CachingBackend::GetRange(
+    const std::string& key,
+    uint64_t offset,
+    uint64_t size,
+    ByteBuffer* data
+) {
+    ByteBuffer buffer = ByteBuffer::Allocate(size);
+    uint64_t got = 0;
+    auto status = co_await GetRangeInto(key, offset, size, buffer.data(), &got);
+    if (!status.OK()) {
+        co_return status;
+    }
+    buffer.Truncate(got);
+    *data = std::move(buffer);
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> CachingBackend::GetRangeInto(
+    const std::string& key,
+    uint64_t offset,
+    uint64_t size,
+    uint8_t* dst,
+    uint64_t* bytes_read
+) {
+    *bytes_read = 0;
+    if (size == 0) {
+        co_return Status::Ok();
+    }
+
+    const uint64_t bs = config_.block_size;
+    const uint64_t end = offset + size;
+    const uint64_t last = (end - 1) / bs;
+    uint64_t copied = 0;
+
+    for (uint64_t b = offset / bs; b <= last;) {
+        uint64_t block_start = b * bs;
+        uint64_t from = std::max(offset, block_start);
+        uint64_t to = std::min(end, block_start + bs);
+
+        uint64_t block_size = 0;
+        if (Lookup(key, b, &block_size)) {
+            // 命中: 块比请求起点还短说明已到对象末尾
+            uint64_t want = from - block_start < block_size
+                                ? std::min(to, block_start + block_size) - from : 0;
+            uint64_t got = 0;
+            auto status = Status::Ok();
+            if (want > 0) {
+                status = co_await disk_->GetRangeInto(BlockKey(key, b), from - block_start, want,
+                                                      dst + (from - offset), &got);
+            }
+            if (status.OK() && got == want) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    ++stats_.hit_blocks;
+                }
+                copied += want;
+                if (block_size < bs) break;
+                ++b;
+                continue;
+            }
+            // 缓存文件丢失或损坏: 从远端重读
+            LOG_WARN("block cache: dropping unreadable block %s@%lu", key.c_str(), b);
+            Forget(key, b);
+        }
+
+        // 连续未命中的块合并为一次远端读
+        uint64_t run_end = b;
+        while (run_end < last && !Contains(key, run_end + 1)) ++run_end;
+
+        uint64_t n = 0;
+        bool eof = false;
+        auto status = co_await FetchRemote(key, b, run_end, offset, size, dst, &n, &eof);
+        if (!status.OK()) {
+            co_return status;
+        }
+        copied += n;
+        if (eof) break;
+        b = run_end + 1;
+    }
+
+    *bytes_read = copied;
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> CachingBackend::FetchRemote(
+    const std::string& key,
+    uint64_t first,
+    uint64_t last,
+    uint64_t offset,
+    uint64_t size,
+    uint8_t* dst,
+    uint64_t* copied,
+    bool* eof
+) {
+    const uint64_t bs = config_.block_size;
+    uint64_t remote_offset = first * bs;
+    uint64_t remote_size = (last - first + 1) * bs;
+
+    ByteBuffer data;
+    auto status = co_await remote_->GetRange(key, remote_offset, remote_size, &data);
+    if (!status.OK()) {
+        co_return status;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.miss_blocks += last - first + 1;
+        // 首块已在 Lookup 中计数
+        for (uint64_t b = first + 1; b <= last; ++b) sketch_.Record(BlockHash(key, b));
+    }
+
+    uint64_t from = std::max(offset, remote_offset);
+    uint64_t to = std::min(offset + size, remote_offset + data.size());
+    *copied = to > from ? to - from : 0;
+    if (*copied > 0) {
+        std::memcpy(dst + (from - offset), data.data() + (from - remote_offset), *copied);
+    }
+    *eof = data.size() < remote_size;
+
+    // 各块共享同一段远端数据, 回填不再拷贝
+    for (uint64_t b = first; b <= last; ++b) {
+        uint64_t block_offset = (b - first) * bs;
+        if (block_offset >= data.size()) break;
+        ScheduleFill(key, b, data.Slice(block_offset, std::min(bs, data.size() - block_offset)));
+    }
+    co_return Status::Ok();
+}
+
+// ================================
+// 准入与异步回填
+// ================================
+
+void CachingBackend::ScheduleFill(const std::string& key, uint64_t block, ByteBuffer data) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end() && it->second.count(block)) return;
+        if (!filling_.insert(BlockKey(key, block)).second) return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(fill_mutex_);
+        if (pending_fills_ >= config_.max_pending_fills) {
+            std::lock_guard<std::mutex> index_lock(mutex_);
+            filling_.erase(BlockKey(key, block));
+            ++stats_.rejected_blocks;
+            return;
+        }
+        ++pending_fills_;
+    }
+    Fill(key, block, std::move(data));
+}
+
+bool CachingBackend::Admit(const std::string& key, uint64_t block, uint64_t size,
+                           std::vector<std::string>* victims) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size > config_.capacity_bytes) {
+        ++stats_.rejected_blocks;
+        return false;
+    }
+    // TinyLFU: 只与第一个淘汰候选比较频率
+    if (config_.admission && stats_.used_bytes + size > config_.capacity_bytes && !lru_.empty()) {
+        const auto& victim = lru_.back();
+        if (sketch_.Estimate(BlockHash(key, block)) <=
+            sketch_.Estimate(BlockHash(victim.key, victim.block))) {
+            ++stats_.rejected_blocks;
+            return false;
+        }
+    }
+    while (stats_.used_bytes + size > config_.capacity_bytes && !lru_.empty()) {
+        auto victim = lru_.back();
+        victims->push_back(BlockKey(victim.key, victim.block));
+        EraseLocked(victim.key, victim.block);
+        ++stats_.evicted_blocks;
+    }
+    // 写盘期间先占住空间
+    stats_.used_bytes += size;
+    return true;
+}
+
+DetachedTask CachingBackend::Fill(std::string key, uint64_t block, ByteBuffer data) {
+    std::string block_key = BlockKey(key, block);
+    std::vector<std::string> victims;
+    bool admitted = Admit(key, block, data.size(), &victims);
+
+    for (const auto& victim : victims) {
+        co_await disk_->Delete(victim);
+    }
+
+    bool ok = false;
+    if (admitted) {
+        // 先写临时文件再 rename, 崩溃后不会留下截断的块
+        std::string temp_key = block_key + kTempSuffix;
+        auto status = co_await disk_->Put(temp_key, data);
+        if (status.OK()) {
+            co_await disk_->Delete(block_key);   // 清掉读句柄缓存
+            std::error_code ec;
+            std::filesystem::rename(std::filesystem::path(config_.cache_dir) / temp_key,
+                                    std::filesystem::path(config_.cache_dir) / block_key, ec);
+            ok = !ec;
+        }
+        if (!ok) {
+            LOG_WARN("block cache: fill %s failed", block_key.c_str());
+            co_await disk_->Delete(temp_key);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (admitted) {
+            stats_.used_bytes -= data.size();   // 归还预留, 插入时重新计入
+            if (ok) {
+                InsertLocked(key, block, data.size());
+                ++stats_.filled_blocks;
+            }
+        }
+        filling_.erase(block_key);
+    }
+    FinishFill();
+}
+
+void CachingBackend::FinishFill() {
+    // 析构在 pending_fills_ 归零后才继续, 之后不能再访问成员
+    std::lock_guard<std::mutex> lock(fill_mutex_);
+    --pending_fills_;
+    fill_cv_.notify_all();
+}
+
+// ================================
+// 透传操作
+// ================================
+
+AsyncTask<Status> CachingBackend::Put(const std::string& key, const ByteBuffer& data) {
+    InvalidateObject(key);
+    co_return co_await remote_->Put(key, data);
+}
+
+AsyncTask<Status> CachingBackend::Get(const std::string& key, ByteBuffer* data) {
+    auto status = co_await remote_->Get(key, data);
+    if (!status.OK()) {
+        co_return status;
+    }
+    // 整对象读也顺带回填, 后续范围读可命中
+    const uint64_t bs = config_.block_size;
+    for (uint64_t off = 0, b = 0; off < data->size(); off += bs, ++b) {
+        uint64_t cached_size = 0;
+        if (Lookup(key, b, &cached_size)) continue;
+        ScheduleFill(key, b, data->Slice(off, std::min<uint64_t>(bs, data->size() - off)));
+    }
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> CachingBackend::Delete(const std::string& key) {
+    InvalidateObject(key);
+    co_return co_await remote_->Delete(key);
+}
+
+AsyncTask<Status> CachingBackend::Exists(const std::string& key) {
+    co_return co_await remote_->Exists(key);
+}
+
+AsyncTask<void> CachingBackend::BatchRead(
+    const std::vector<ReadRequest>& requests,
+    std::vector<ReadResult>* results,
+    uint32_t max_concurrency
+) {
+    results->assign(requests.size(), ReadResult{});
+    const uint64_t bs = config_.block_size;
+
+    // 整对象读不知道长度, 与 Get 一样走远端
+    std::vector<size_t> hits;
+    std::vector<size_t> missed;
+    std::vector<ReadRequest> remote_requests;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto& req = requests[i];
+        if (req.size > 0 && ContainsRange(req.key, req.offset, req.size)) {
+            hits.push_back(i);
+            continue;
+        }
+        missed.push_back(i);
+        if (req.size == 0) {
+            remote_requests.push_back(req);
+        } else {
+            uint64_t first = req.offset / bs;
+            uint64_t last = (req.offset + req.size - 1) / bs;
+            remote_requests.push_back(ReadRequest{req.key, first * bs, (last - first + 1) * bs});
+        }
+    }
+
+    // 本地盘读先发起, 与远端批量读重叠; 块文件读不出时 GetRange 自行回退远端
+    std::vector<AsyncTask<Status>> local;
+    local.reserve(hits.size());
+    for (auto i : hits) {
+        const auto& req = requests[i];
+        local.push_back(GetRange(req.key, req.offset, req.size, &(*results)[i].data));
+    }
+
+    if (!missed.empty()) {
+        std::vector<ReadResult> remote_results;
+        co_await remote_->BatchRead(remote_requests, &remote_results, max_concurrency);
+        for (size_t j = 0; j < missed.size(); ++j) {
+            const auto& req = requests[missed[j]];
+            const auto& aligned = remote_requests[j];
+            auto& result = remote_results[j];
+            auto& out = (*results)[missed[j]];
+            out.status = std::move(result.status);
+            if (!out.status.OK()) {
+                continue;
+            }
+
+            uint64_t first = aligned.offset / bs;
+            uint64_t blocks = (result.data.size() + bs - 1) / bs;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stats_.miss_blocks += blocks;
+                for (uint64_t b = first; b < first + blocks; ++b) sketch_.Record(BlockHash(req.key, b));
+            }
+            for (uint64_t k = 0; k < blocks; ++k) {
+                ScheduleFill(req.key, first + k, result.data.Slice(k * bs, bs));
+            }
+            out.data = req.size == 0 ? std::move(result.data)
+                                     : result.data.Slice(req.offset - aligned.offset, req.size);
+        }
+    }
+
+    for (size_t k = 0; k < hits.size(); ++k) {
+        auto task = std::move(local[k]);
+        (*results)[hits[k]].status = co_await task;
+    }
+}
+
+AsyncTask<Status> CachingBackend::HealthCheck() {
+    co_return co_await remote_->HealthCheck();
+}
+
+AsyncTask<Status> CachingBackend::GetCapacity(CapacityInfo* info) {
+    co_return co_await remote_->GetCapacity(info);
+}
+
+} // namespace nebulastore::storage
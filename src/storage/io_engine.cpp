@@ -0,0 +1,101 @@
+// ================================
+// IO 引擎: 线程池实现 + 工厂
+// ================================
+
+#include "nebulastore/storage/io_engine.h"
+#include "nebulastore/common/bounded_queue.h"
+#include "nebulastore/common/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <thread>
+#include <unistd.h>
+
+namespace nebulastore::storage {
+
+namespace {
+
+// 阻塞 pread/pwrite, 处理短读写和 EINTR
+int64_t DoBlockingIo(const IoRequest& req) {
+    if (req.op == IoOp::kFsync) {
+        return ::fdatasync(req.fd) == 0 ? 0 : -errno;
+    }
+
+    auto* buf = static_cast<uint8_t*>(req.buf);
+    uint64_t done = 0;
+    while (done < req.len) {
+        ssize_t n = req.op == IoOp::kRead
+            ? ::pread(req.fd, buf + done, req.len - done, req.offset + done)
+            : ::pwrite(req.fd, buf + done, req.len - done, req.offset + done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -errno;
+        }
+        if (n == 0) break;  // EOF
+        done += static_cast<uint64_t>(n);
+    }
+    return static_cast<int64_t>(done);
+}
+
+class ThreadPoolIoEngine : public IoEngine {
+public:
+    explicit ThreadPoolIoEngine(const Config& config)
+        // 队列不设上限: 工作线程在完成回调里恢复的协程可能再次提交, 有界会自锁
+        : queue_(std::numeric_limits<size_t>::max()) {
+        uint32_t n = std::max<uint32_t>(config.fallback_threads, 1);
+        for (uint32_t i = 0; i < n; ++i) {
+            workers_.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~ThreadPoolIoEngine() override {
+        for (size_t i = 0; i < workers_.size(); ++i) {
+            queue_.enqueue(nullptr);  // 退出哨兵
+        }
+        for (auto& w : workers_) {
+            if (w.joinable()) w.join();
+        }
+    }
+
+    void Submit(IoCompletion* c) override {
+        queue_.enqueue(c);
+    }
+
+    const char* Name() const override { return "threadpool"; }
+
+private:
+    void WorkerLoop() {
+        while (true) {
+            auto item = queue_.dequeue();
+            IoCompletion* c = item ? *item : nullptr;
+            if (!c) break;
+            c->result = DoBlockingIo(c->req);
+            c->on_complete(c);
+        }
+    }
+
+    BoundedQueue<IoCompletion*> queue_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace
+
+std::unique_ptr<IoEngine> CreateThreadPoolIoEngine(const IoEngine::Config& config) {
+    return std::make_unique<ThreadPoolIoEngine>(config);
+}
+
+std::unique_ptr<IoEngine> CreateIoEngine(const IoEngine::Config& config) {
+    if (config.use_io_uring) {
+        auto engine = CreateIoUringEngine(config);
+        if (engine) {
+            LOG_INFO("IoEngine: io_uring (depth=%u, sqpoll=%d)",
+                     config.queue_depth, config.sqpoll ? 1 : 0);
+            return engine;
+        }
+        LOG_WARN("io_uring unavailable, falling back to thread pool");
+    }
+    LOG_INFO("IoEngine: thread pool (%u threads)", config.fallback_threads);
+    return CreateThreadPoolIoEngine(config);
+}
+
+} // namespace nebulastore::storage
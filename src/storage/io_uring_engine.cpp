@@ -0,0 +1,386 @@
+// ================================
+// io_uring IO 引擎 (直接系统调用, 无 liburing 依赖)
+// ================================
+
+#include "nebulastore/storage/io_engine.h"
+#include "nebulastore/common/semaphore.h"
+#include "nebulastore/common/logger.h"
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace nebulastore::storage {
+
+namespace {
+
+int SysSetup(uint32_t entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int SysEnter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                                      flags, nullptr, 0));
+}
+
+int SysRegister(int fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+inline uint32_t LoadAcquire(const uint32_t* p) {
+    return std::atomic_ref<const uint32_t>(*p).load(std::memory_order_acquire);
+}
+
+inline void StoreRelease(uint32_t* p, uint32_t v) {
+    std::atomic_ref<uint32_t>(*p).store(v, std::memory_order_release);
+}
+
+// 停止哨兵: user_data == 0 的 NOP
+constexpr uint64_t kStopUserData = 0;
+
+class IoUringEngine : public IoEngine {
+public:
+    explicit IoUringEngine(const Config& config) : config_(config) {}
+
+    ~IoUringEngine() override {
+        if (reaper_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(sq_mutex_);
+                io_uring_sqe* sqe = NextSqe();
+                while (!sqe) {
+                    Flush(0);
+                    sqe = NextSqe();
+                }
+                std::memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = IORING_OP_NOP;
+                sqe->user_data = kStopUserData;
+                Flush(1);
+            }
+            reaper_.join();
+        }
+        if (sqes_) ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_ring_size_);
+        if (sq_ring_) ::munmap(sq_ring_, sq_ring_size_);
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+    }
+
+    Status Init() {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        p.flags = IORING_SETUP_CQSIZE;
+        p.cq_entries = config_.queue_depth * 2;
+        if (config_.sqpoll) {
+            p.flags |= IORING_SETUP_SQPOLL;
+            p.sq_thread_idle = config_.sqpoll_idle_ms;
+        }
+
+        ring_fd_ = SysSetup(config_.queue_depth, &p);
+        if (ring_fd_ < 0) {
+            return Status::IO("io_uring_setup failed: " + std::string(strerror(errno)));
+        }
+        sqpoll_ = config_.sqpoll;
+
+        sq_ring_size_ = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+        cq_ring_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED) {
+            sq_ring_ = nullptr;
+            return Status::IO("mmap sq ring failed");
+        }
+        if (single_mmap) {
+            cq_ring_ = sq_ring_;
+        } else {
+            cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED) {
+                cq_ring_ = nullptr;
+                return Status::IO("mmap cq ring failed");
+            }
+        }
+        sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+        auto* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return Status::IO("mmap sqes failed");
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<uint8_t*>(sq_ring_);
+        sq_head_ = reinterpret_cast<uint32_t*>(sq + p.sq_off.head);
+        sq_tail_ = reinterpret_cast<uint32_t*>(sq + p.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<uint32_t*>(sq + p.sq_off.ring_mask);
+        sq_entries_ = p.sq_entries;
+        sq_flags_ = reinterpret_cast<uint32_t*>(sq + p.sq_off.flags);
+        sq_array_ = reinterpret_cast<uint32_t*>(sq + p.sq_off.array);
+        local_tail_ = *sq_tail_;
+
+        auto* cq = static_cast<uint8_t*>(cq_ring_);
+        cq_head_ = reinterpret_cast<uint32_t*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<uint32_t*>(cq + p.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<uint32_t*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+        // 在途 IO 不超过 CQ 容量, 避免 CQ 溢出
+        inflight_ = std::make_unique<Semaphore>(static_cast<int>(p.cq_entries) - 1);
+
+        // 稀疏注册文件表, 后续通过 FILES_UPDATE 填充
+        if (config_.max_registered_files > 0) {
+            std::vector<int> fds(config_.max_registered_files, -1);
+            if (SysRegister(ring_fd_, IORING_REGISTER_FILES, fds.data(),
+                            static_cast<uint32_t>(fds.size())) == 0) {
+                free_file_slots_.reserve(fds.size());
+                for (int i = static_cast<int>(fds.size()) - 1; i >= 0; --i) {
+                    free_file_slots_.push_back(i);
+                }
+            }
+        }
+
+        reaper_ = std::thread([this] { ReapLoop(); });
+        return Status::Ok();
+    }
+
+    void Submit(IoCompletion* c) override {
+        IoCompletion* one[1] = {c};
+        SubmitBatch(one, 1);
+    }
+
+    void SubmitBatch(IoCompletion* const* cs, size_t n) override {
+        AcquireInflight(n);
+
+        std::lock_guard<std::mutex> lock(sq_mutex_);
+        uint32_t pending = 0;
+        for (size_t i = 0; i < n; ++i) {
+            io_uring_sqe* sqe = NextSqe();
+            while (!sqe) {
+                Flush(pending);
+                pending = 0;
+                sqe = NextSqe();
+            }
+            Prepare(sqe, cs[i]);
+            ++pending;
+        }
+        Flush(pending);
+    }
+
+    int RegisterFile(int fd) override {
+        std::lock_guard<std::mutex> lock(files_mutex_);
+        if (free_file_slots_.empty()) return -1;
+        int slot = free_file_slots_.back();
+        io_uring_files_update up;
+        std::memset(&up, 0, sizeof(up));
+        up.offset = static_cast<uint32_t>(slot);
+        up.fds = reinterpret_cast<uint64_t>(&fd);
+        if (SysRegister(ring_fd_, IORING_REGISTER_FILES_UPDATE, &up, 1) < 0) {
+            return -1;
+        }
+        free_file_slots_.pop_back();
+        return slot;
+    }
+
+    void UnregisterFile(int index) override {
+        if (index < 0) return;
+        std::lock_guard<std::mutex> lock(files_mutex_);
+        int fd = -1;
+        io_uring_files_update up;
+        std::memset(&up, 0, sizeof(up));
+        up.offset = static_cast<uint32_t>(index);
+        up.fds = reinterpret_cast<uint64_t>(&fd);
+        SysRegister(ring_fd_, IORING_REGISTER_FILES_UPDATE, &up, 1);
+        free_file_slots_.push_back(index);
+    }
+
+    bool RegisterBuffers(const std::vector<iovec>& iovs) override {
+        std::lock_guard<std::mutex> lock(files_mutex_);
+        if (buffers_registered_) {
+            SysRegister(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            buffers_registered_ = false;
+        }
+        if (iovs.empty()) return true;
+        if (SysRegister(ring_fd_, IORING_REGISTER_BUFFERS, iovs.data(),
+                        static_cast<uint32_t>(iovs.size())) < 0) {
+            LOG_WARN("io_uring register buffers failed: %s", strerror(errno));
+            return false;
+        }
+        buffers_registered_ = true;
+        return true;
+    }
+
+    const char* Name() const override { return "io_uring"; }
+
+private:
+    // 调用方持有 sq_mutex_; 填充后由 Flush 统一发布 tail
+    io_uring_sqe* NextSqe() {
+        if (local_tail_ - LoadAcquire(sq_head_) >= sq_entries_) {
+            return nullptr;  // SQ 满
+        }
+        uint32_t idx = local_tail_ & sq_mask_;
+        sq_array_[idx] = idx;
+        ++local_tail_;
+        return &sqes_[idx];
+    }
+
+    void Prepare(io_uring_sqe* sqe, IoCompletion* c) {
+        const IoRequest& req = c->req;
+        std::memset(sqe, 0, sizeof(*sqe));
+        switch (req.op) {
+            case IoOp::kRead:
+                sqe->opcode = req.buf_index >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+                break;
+            case IoOp::kWrite:
+                sqe->opcode = req.buf_index >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+                break;
+            case IoOp::kFsync:
+                sqe->opcode = IORING_OP_FSYNC;
+                sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+                break;
+        }
+        if (req.file_index >= 0) {
+            sqe->fd = req.file_index;
+            sqe->flags |= IOSQE_FIXED_FILE;
+        } else {
+            sqe->fd = req.fd;
+        }
+        sqe->addr = reinterpret_cast<uint64_t>(req.buf);
+        sqe->len = static_cast<uint32_t>(req.len);
+        sqe->off = req.offset;
+        if (req.buf_index >= 0) {
+            sqe->buf_index = static_cast<uint16_t>(req.buf_index);
+        }
+        sqe->user_data = reinterpret_cast<uint64_t>(c);
+    }
+
+    // 通知内核消费 SQ; SQPOLL 模式下仅在内核线程休眠时唤醒
+    void Flush(uint32_t to_submit) {
+        StoreRelease(sq_tail_, local_tail_);
+        if (sqpoll_) {
+            if (std::atomic_ref<uint32_t>(*sq_flags_).load(std::memory_order_acquire) &
+                IORING_SQ_NEED_WAKEUP) {
+                SysEnter(ring_fd_, 0, 0, IORING_ENTER_SQ_WAKEUP);
+            }
+            return;
+        }
+        while (to_submit > 0) {
+            int ret = SysEnter(ring_fd_, to_submit, 0, 0);
+            if (ret < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                LOG_ERROR("io_uring_enter submit failed: %s", strerror(errno));
+                return;
+            }
+            to_submit -= static_cast<uint32_t>(ret);
+        }
+    }
+
+    // 限制在途 IO 不超过 CQ 容量; 本引擎回调线程 (reaper) 内提交不能阻塞等待自己,
+    // 此时允许超额, 由后续完成抵扣. 只认本引擎的 reaper: 其他引擎的回调线程
+    // 向本引擎提交时照常等待
+    void AcquireInflight(size_t n) {
+        bool in_reaper = std::this_thread::get_id() == reaper_id_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            if (in_reaper) {
+                if (!inflight_->try_wait()) overcommit_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                inflight_->wait();
+            }
+        }
+    }
+
+    void ReleaseInflight() {
+        uint32_t over = overcommit_.load(std::memory_order_relaxed);
+        while (over > 0) {
+            if (overcommit_.compare_exchange_weak(over, over - 1, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        inflight_->signal();
+    }
+
+    void ReapLoop() {
+        reaper_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        bool stopping = false;
+        while (!stopping) {
+            uint32_t head = *cq_head_;
+            uint32_t tail = LoadAcquire(cq_tail_);
+            if (head == tail) {
+                int ret = SysEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+                if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                    LOG_ERROR("io_uring_enter wait failed: %s", strerror(errno));
+                }
+                continue;
+            }
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                if (cqe.user_data == kStopUserData) {
+                    stopping = true;
+                    continue;
+                }
+                auto* c = reinterpret_cast<IoCompletion*>(cqe.user_data);
+                c->result = cqe.res;
+                // 先释放 CQ 槽位再回调, 回调可能继续提交 IO
+                StoreRelease(cq_head_, head + 1);
+                ReleaseInflight();
+                c->on_complete(c);
+            }
+            StoreRelease(cq_head_, head);
+        }
+    }
+
+    Config config_;
+    int ring_fd_ = -1;
+    bool sqpoll_ = false;
+
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    uint32_t* sq_head_ = nullptr;
+    uint32_t* sq_tail_ = nullptr;
+    uint32_t* sq_flags_ = nullptr;
+    uint32_t* sq_array_ = nullptr;
+    uint32_t sq_mask_ = 0;
+    uint32_t sq_entries_ = 0;
+    uint32_t local_tail_ = 0;
+
+    uint32_t* cq_head_ = nullptr;
+    uint32_t* cq_tail_ = nullptr;
+    uint32_t cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::mutex sq_mutex_;
+    std::unique_ptr<Semaphore> inflight_;
+    std::atomic<uint32_t> overcommit_{0};
+    std::thread reaper_;
+    std::atomic<std::thread::id> reaper_id_{};
+
+    std::mutex files_mutex_;
+    std::vector<int> free_file_slots_;
+    bool buffers_registered_ = false;
+};
+
+} // namespace
+
+std::unique_ptr<IoEngine> CreateIoUringEngine(const IoEngine::Config& config) {
+    auto engine = std::make_unique<IoUringEngine>(config);
+    auto status = engine->Init();
+    if (!status.OK()) {
+        LOG_WARN("%s", status.message().c_str());
+        return nullptr;
+    }
+    return engine;
+}
+
+} // namespace nebulastore::storage
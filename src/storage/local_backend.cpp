@@ -5,12 +5,102 @@
 
 #include "nebulastore/storage/backend.h"
 #include "nebulastore/common/logger.h"
-#include <fstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
-#include <sstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 namespace nebulastore::storage {
 
+namespace {
+
+// io_uring 单个 SQE 的 len 为 32 位, 大 IO 按此拆分
+constexpr uint64_t kMaxIoSize = 1ULL << 30;
+
+} // namespace
+
+// ================================
+// 读句柄缓存
+// ================================
+
+// 引用计数的打开文件: 在途 IO 持有引用, 最后一个引用释放时关闭
+struct LocalBackend::OpenFile {
+    int fd = -1;
+    int slot = -1;               // io_uring 注册文件槽位
+    IoEngine* engine = nullptr;
+
+    ~OpenFile() {
+        if (slot >= 0) engine->UnregisterFile(slot);
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+class LocalBackend::FileCache {
+public:
+    FileCache(IoEngine* engine, size_t capacity)
+        : engine_(engine), capacity_(std::max<size_t>(capacity, 1)) {}
+
+    // 返回只读句柄, 文件不存在时返回 nullptr (errno 保留)
+    std::shared_ptr<OpenFile> Acquire(const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = map_.find(path);
+            if (it != map_.end()) {
+                lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+                return it->second.file;
+            }
+        }
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return nullptr;
+
+        auto file = std::make_shared<OpenFile>();
+        file->fd = fd;
+        file->engine = engine_;
+        file->slot = engine_->RegisterFile(fd);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(path);
+        if (it != map_.end()) {
+            return it->second.file;  // 并发打开, 使用先插入的句柄
+        }
+        lru_.push_front(path);
+        map_.emplace(path, Entry{file, lru_.begin()});
+        while (map_.size() > capacity_) {
+            map_.erase(lru_.back());
+            lru_.pop_back();
+        }
+        return file;
+    }
+
+    void Evict(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(path);
+        if (it != map_.end()) {
+            lru_.erase(it->second.lru_it);
+            map_.erase(it);
+        }
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<OpenFile> file;
+        std::list<std::string>::iterator lru_it;
+    };
+
+    IoEngine* engine_;
+    size_t capacity_;
+    std::mutex mutex_;
+    std::list<std::string> lru_;
+    std::unordered_map<std::string, Entry> map_;
+};
+
 // ================================
 // LocalBackend
 // ================================
@@ -19,7 +109,19 @@ LocalBackend::LocalBackend(Config config)
     : config_(std::move(config)) {
     // 确保数据目录存在
     std::filesystem::create_directories(config_.data_dir);
-    LOG_INFO("LocalBackend initialized: %s", config_.data_dir.c_str());
+    io_engine_ = CreateIoEngine(config_.io);
+    file_cache_ = std::make_unique<FileCache>(io_engine_.get(), config_.max_open_files);
+    if (config_.buffer_pool && !config_.buffer_pool->RegisterWith(io_engine_.get())) {
+        LOG_INFO("LocalBackend: buffer pool not registered with %s engine", io_engine_->Name());
+    }
+    LOG_INFO("LocalBackend initialized: %s (io=%s)",
+             config_.data_dir.c_str(), io_engine_->Name());
+}
+
+// 先释放句柄 (注销注册文件), 再销毁引擎
+LocalBackend::~LocalBackend() {
+    file_cache_.reset();
+    io_engine_.reset();
 }
 
 std::string LocalBackend::KeyToPath(const std::string& key) {
@@ -33,6 +135,33 @@ std::string LocalBackend::KeyToPath(const std::string& key) {
     return path;
 }
 
+ByteBuffer LocalBackend::AllocateBuffer(size_t size) {
+    if (config_.buffer_pool) {
+        auto pooled = config_.buffer_pool->Acquire(size);
+        if (pooled.hasValue()) {
+            auto owner = std::make_shared<PooledBuffer>(std::move(pooled).value());
+            return ByteBuffer::Wrap(owner->data(), size, owner);
+        }
+    }
+    return ByteBuffer::Allocate(size);
+}
+
+AsyncTask<int64_t> LocalBackend::ReadFull(const OpenFile& file, uint8_t* buf,
+                                           uint64_t len, uint64_t offset) {
+    uint64_t done = 0;
+    while (done < len) {
+        uint64_t chunk = std::min(len - done, kMaxIoSize);
+        int buf_index = config_.buffer_pool ? config_.buffer_pool->FixedIndex(buf + done, chunk) : -1;
+        int64_t n = co_await io_engine_->Read(file.fd, buf + done, chunk, offset + done,
+                                              file.slot, buf_index);
+        if (n == -EINTR || n == -EAGAIN) continue;
+        if (n < 0) co_return n;
+        if (n == 0) break;  // EOF
+        done += static_cast<uint64_t>(n);
+    }
+    co_return static_cast<int64_t>(done);
+}
+
 AsyncTask<Status> LocalBackend::Put(
     const std::string& key,
     const ByteBuffer& data
@@ -48,18 +177,31 @@ AsyncTask<Status> LocalBackend::Put(
         co_return Status::IO("Failed to create directory: " + ec.message());
     }
 
-    // 写入文件
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
+    // 覆盖写: 旧的缓存句柄作废
+    file_cache_->Evict(path);
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
         LOG_ERROR("Failed to open file for writing: %s", path.c_str());
         co_return Status::IO("Failed to open file: " + path);
     }
 
-    file.write(reinterpret_cast<const char*>(data.data()), data.size());
-    if (!file) {
-        LOG_ERROR("Failed to write file: %s", path.c_str());
-        co_return Status::IO("Failed to write file: " + path);
+    uint64_t done = 0;
+    while (done < data.size()) {
+        uint64_t chunk = std::min<uint64_t>(data.size() - done, kMaxIoSize);
+        int buf_index = config_.buffer_pool
+                            ? config_.buffer_pool->FixedIndex(data.data() + done, chunk) : -1;
+        int64_t n = co_await io_engine_->Write(fd, data.data() + done, chunk, done, -1, buf_index);
+        if (n == -EINTR || n == -EAGAIN) continue;
+        if (n <= 0) {
+            ::close(fd);
+            LOG_ERROR("Failed to write file: %s (%s)", path.c_str(),
+                      n < 0 ? strerror(static_cast<int>(-n)) : "short write");
+            co_return Status::IO("Failed to write file: " + path);
+        }
+        done += static_cast<uint64_t>(n);
     }
+    ::close(fd);
 
     LOG_DEBUG("Written %zu bytes to %s", data.size(), path.c_str());
     co_return Status::Ok();
@@ -71,29 +213,31 @@ AsyncTask<Status> LocalBackend::Get(
 ) {
     auto path = KeyToPath(key);
 
-    // 读取文件
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    auto file = file_cache_->Acquire(path);
     if (!file) {
         LOG_ERROR("Failed to open file for reading: %s", path.c_str());
         co_return Status::NotFound("File not found: " + key);
     }
 
-    auto size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::vector<uint8_t> buffer(size);
-    file.read(reinterpret_cast<char*>(buffer.data()), size);
+    struct stat st;
+    if (::fstat(file->fd, &st) != 0) {
+        co_return Status::IO("Failed to stat file: " + path);
+    }
+    auto size = static_cast<uint64_t>(st.st_size);
 
-    if (!file) {
-        LOG_ERROR("Failed to read file: %s", path.c_str());
+    ByteBuffer buffer = AllocateBuffer(size);
+    int64_t n = co_await ReadFull(*file, buffer.data(), size, 0);
+    if (n < 0) {
+        LOG_ERROR("Failed to read file: %s (%s)", path.c_str(), strerror(static_cast<int>(-n)));
         co_return Status::IO("Failed to read file: " + path);
     }
+    buffer.Truncate(static_cast<size_t>(n));
 
     if (data) {
-        data->assign(std::move(buffer));
+        *data = std::move(buffer);
     }
 
-    LOG_DEBUG("Read %ld bytes from %s", static_cast<long>(size), path.c_str());
+    LOG_DEBUG("Read %ld bytes from %s", static_cast<long>(n), path.c_str());
     co_return Status::Ok();
 }
 
@@ -101,6 +245,7 @@ AsyncTask<Status> LocalBackend::Delete(
     const std::string& key
 ) {
     auto path = KeyToPath(key);
+    file_cache_->Evict(path);
 
     std::error_code ec;
     std::filesystem::remove(path, ec);
@@ -136,51 +281,165 @@ AsyncTask<Status> LocalBackend::GetRange(
 ) {
     auto path = KeyToPath(key);
 
-    std::ifstream file(path, std::ios::binary);
+    auto file = file_cache_->Acquire(path);
     if (!file) {
         co_return Status::NotFound("File not found: " + key);
     }
 
-    // 跳到偏移位置
-    file.seekg(offset, std::ios::beg);
-    if (!file) {
-        co_return Status::InvalidArgument("Invalid offset");
-    }
-
-    // 读取指定大小
-    std::vector<uint8_t> buffer(size);
-    file.read(reinterpret_cast<char*>(buffer.data()), size);
-
-    auto bytes_read = file.gcount();
-    if (!file && !file.eof()) {
+    // 读取指定大小 (越过文件末尾时返回短读)
+    ByteBuffer buffer = AllocateBuffer(size);
+    int64_t n = co_await ReadFull(*file, buffer.data(), size, offset);
+    if (n < 0) {
         co_return Status::IO("Failed to read file range");
     }
 
     if (data) {
-        buffer.resize(bytes_read);
-        data->assign(std::move(buffer));
+        buffer.Truncate(static_cast<size_t>(n));
+        *data = std::move(buffer);
     }
 
     LOG_DEBUG("Read range %lu+%lu from %s", offset, size, path.c_str());
     co_return Status::Ok();
 }
 
-AsyncTask<Status> LocalBackend::BatchGet(
-    const std::vector<std::string>& keys,
-    std::vector<ByteBuffer>* data
+AsyncTask<Status> LocalBackend::GetRangeInto(
+    const std::string& key,
+    uint64_t offset,
+    uint64_t size,
+    uint8_t* dst,
+    uint64_t* bytes_read
+) {
+    auto file = file_cache_->Acquire(KeyToPath(key));
+    if (!file) {
+        co_return Status::NotFound("File not found: " + key);
+    }
+
+    int64_t n = co_await ReadFull(*file, dst, size, offset);
+    if (n < 0) {
+        co_return Status::IO("Failed to read file range");
+    }
+    *bytes_read = static_cast<uint64_t>(n);
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> LocalBackend::GetStream(
+    const std::string& key,
+    uint64_t offset,
+    uint64_t size,
+    ChunkSink sink
 ) {
-    data->resize(keys.size());
+    auto file = file_cache_->Acquire(KeyToPath(key));
+    if (!file) {
+        co_return Status::NotFound("File not found: " + key);
+    }
+    if (size == 0) {
+        struct stat st;
+        if (::fstat(file->fd, &st) != 0) {
+            co_return Status::IO("Failed to stat file: " + key);
+        }
+        auto file_size = static_cast<uint64_t>(st.st_size);
+        size = file_size > offset ? file_size - offset : 0;
+    }
 
-    for (size_t i = 0; i < keys.size(); ++i) {
-        auto status = co_await Get(keys[i], &(*data)[i]);
+    // 单块缓冲区循环复用
+    ByteBuffer chunk = AllocateBuffer(std::min(size, std::max<uint64_t>(config_.stream_chunk_size, 4096)));
+    uint64_t done = 0;
+    while (done < size) {
+        uint64_t len = std::min<uint64_t>(chunk.size(), size - done);
+        int64_t n = co_await ReadFull(*file, chunk.data(), len, offset + done);
+        if (n < 0) {
+            co_return Status::IO("Failed to read file: " + key);
+        }
+        if (n == 0) break;  // EOF
+        auto status = sink(chunk.data(), static_cast<size_t>(n));
         if (!status.OK()) {
             co_return status;
         }
+        done += static_cast<uint64_t>(n);
+        if (static_cast<uint64_t>(n) < len) break;
     }
-
     co_return Status::Ok();
 }
 
+AsyncTask<void> LocalBackend::BatchRead(
+    const std::vector<ReadRequest>& requests,
+    std::vector<ReadResult>* results,
+    uint32_t max_concurrency
+) {
+    results->assign(requests.size(), ReadResult{});
+    // 一轮的 IO 数不能超过引擎在途上限, 否则 SubmitBatch 会等待自己
+    size_t window = std::clamp<size_t>(max_concurrency, 1, std::max<uint32_t>(config_.io.queue_depth, 1));
+
+    for (size_t begin = 0; begin < requests.size(); begin += window) {
+        size_t end = std::min(requests.size(), begin + window);
+
+        // 打开文件并分配缓冲区, 每项的首次读放进同一批提交
+        std::vector<std::shared_ptr<OpenFile>> files(end - begin);
+        std::vector<IoRequest> batch;
+        std::vector<size_t> batch_items;
+        std::vector<uint64_t> lengths(end - begin, 0);
+        for (size_t i = begin; i < end; ++i) {
+            const auto& req = requests[i];
+            auto& result = (*results)[i];
+            auto file = file_cache_->Acquire(KeyToPath(req.key));
+            if (!file) {
+                result.status = Status::NotFound("File not found: " + req.key);
+                continue;
+            }
+            uint64_t offset = req.offset;
+            uint64_t len = req.size;
+            if (len == 0) {
+                struct stat st;
+                if (::fstat(file->fd, &st) != 0) {
+                    result.status = Status::IO("Failed to stat file: " + req.key);
+                    continue;
+                }
+                offset = 0;
+                len = static_cast<uint64_t>(st.st_size);
+            }
+            result.data = AllocateBuffer(len);
+            lengths[i - begin] = len;
+            if (len == 0) continue;
+
+            uint64_t chunk = std::min(len, kMaxIoSize);
+            int buf_index = config_.buffer_pool
+                                ? config_.buffer_pool->FixedIndex(result.data.data(), chunk) : -1;
+            batch.push_back(IoRequest{IoOp::kRead, file->fd, result.data.data(), chunk, offset,
+                                      file->slot, buf_index});
+            batch_items.push_back(i);
+            files[i - begin] = std::move(file);
+        }
+
+        auto done = co_await io_engine_->ReadBatch(batch);
+
+        for (size_t k = 0; k < batch_items.size(); ++k) {
+            size_t i = batch_items[k];
+            const auto& req = requests[i];
+            auto& result = (*results)[i];
+            uint64_t len = lengths[i - begin];
+            uint64_t offset = req.size == 0 ? 0 : req.offset;
+            int64_t n = done[k];
+            bool retry = n == -EINTR || n == -EAGAIN;
+            if (retry) n = 0;
+            // 普通文件短读即到达末尾; 被打断或超过单次 IO 上限时补读剩余部分
+            if (retry || (n >= 0 && static_cast<uint64_t>(n) == batch[k].len &&
+                          static_cast<uint64_t>(n) < len)) {
+                int64_t rest = co_await ReadFull(*files[i - begin], result.data.data() + n,
+                                                 len - n, offset + n);
+                n = rest < 0 ? rest : n + rest;
+            }
+            if (n < 0) {
+                LOG_ERROR("Failed to read file: %s (%s)", req.key.c_str(), strerror(static_cast<int>(-n)));
+                result.status = Status::IO("Failed to read file: " + req.key);
+                result.data = ByteBuffer();
+                continue;
+            }
+            result.data.Truncate(static_cast<size_t>(n));
+        }
+    }
+    co_return;
+}
+
 AsyncTask<Status> LocalBackend::HealthCheck() {
     // 检查数据目录是否可访问
     std::error_code ec;
@@ -0,0 +1,483 @@
+// ================================
+// 进程内块缓存实现 (分片 S3-FIFO)
+// ================================
+
+#include "nebulastore/storage/memory_cache.h"
+#include <algorithm>
+#include <cstring>
+
+namespace nebulastore::storage {
+
+namespace {
+
+// 每个缓存项的索引/链表开销估计, 计入内存上限
+constexpr uint64_t kNodeOverhead = 128;
+constexpr uint8_t kMaxFreq = 3;
+
+uint64_t Mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+uint64_t BlockHash(const std::string& key, uint64_t block) {
+    return Mix64(std::hash<std::string>{}(key) ^ Mix64(block + 1));
+}
+
+// 从首块跳过 skip 字节后拷出至多 size 字节; 单块时直接返回视图
+ByteBuffer CopyBlocks(const std::vector<ByteBuffer>& blocks, uint64_t skip, uint64_t size) {
+    if (blocks.size() == 1) {
+        return blocks[0].Slice(std::min<uint64_t>(skip, blocks[0].size()), size);
+    }
+    ByteBuffer out = ByteBuffer::Allocate(size);
+    uint64_t copied = 0;
+    for (const auto& block : blocks) {
+        if (skip >= block.size()) break;
+        uint64_t n = std::min<uint64_t>(block.size() - skip, size - copied);
+        std::memcpy(out.data() + copied, block.data() + skip, n);
+        copied += n;
+        skip = 0;
+    }
+    out.Truncate(copied);
+    return out;
+}
+
+}  // namespace
+
+// ================================
+// BlockCache
+// ================================
+
+struct BlockCache::Shard {
+    struct Node {
+        std::string key;
+        uint64_t block;
+        uint64_t hash;
+        ByteBuffer data;
+        uint64_t charge;
+        uint8_t freq = 0;
+        bool in_main = false;
+    };
+    using List = std::list<Node>;
+
+    mutable std::mutex mutex;
+    uint64_t capacity = 0;
+    uint64_t small_capacity = 0;
+    uint64_t small_bytes = 0;
+    uint64_t main_bytes = 0;
+    List small;                 // 头部最新, 从尾部淘汰
+    List main;
+    std::unordered_map<std::string, std::unordered_map<uint64_t, List::iterator>> index;
+    std::list<uint64_t> ghost_fifo;
+    std::unordered_set<uint64_t> ghost;
+    Stats stats;
+
+    uint64_t Bytes() const { return small_bytes + main_bytes; }
+
+    void Unlink(List::iterator it) {
+        auto& node = *it;
+        auto kit = index.find(node.key);
+        kit->second.erase(node.block);
+        if (kit->second.empty()) index.erase(kit);
+        if (node.in_main) {
+            main_bytes -= node.charge;
+            main.erase(it);
+        } else {
+            small_bytes -= node.charge;
+            small.erase(it);
+        }
+        --stats.entries;
+    }
+
+    void AddGhost(uint64_t hash) {
+        if (!ghost.insert(hash).second) return;
+        ghost_fifo.push_back(hash);
+        // ghost 条目数不超过常驻条目数
+        size_t limit = std::max<size_t>(64, stats.entries);
+        while (ghost_fifo.size() > limit) {
+            ghost.erase(ghost_fifo.front());
+            ghost_fifo.pop_front();
+        }
+    }
+
+    void EvictSmall() {
+        auto it = std::prev(small.end());
+        if (it->freq > 0) {
+            // 在 small 中被再次访问: 晋升 main
+            it->freq = 0;
+            it->in_main = true;
+            small_bytes -= it->charge;
+            main_bytes += it->charge;
+            main.splice(main.begin(), small, it);
+            return;
+        }
+        AddGhost(it->hash);
+        Unlink(it);
+        ++stats.evictions;
+    }
+
+    void EvictMain() {
+        auto it = std::prev(main.end());
+        if (it->freq > 0) {
+            --it->freq;
+            main.splice(main.begin(), main, it);
+            return;
+        }
+        Unlink(it);
+        ++stats.evictions;
+    }
+
+    void MakeRoom(uint64_t need) {
+        while (Bytes() + need > capacity && (!small.empty() || !main.empty())) {
+            if (!small.empty() && (small_bytes > small_capacity || main.empty())) {
+                EvictSmall();
+            } else {
+                EvictMain();
+            }
+        }
+    }
+};
+
+BlockCache::BlockCache(Config config) : config_(config) {
+    if (config_.shards == 0) config_.shards = 1;
+    uint64_t per_shard = config_.capacity_bytes / config_.shards;
+    for (uint32_t i = 0; i < config_.shards; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->capacity = per_shard;
+        shard->small_capacity = per_shard * config_.small_ratio_percent / 100;
+        shards_.push_back(std::move(shard));
+    }
+}
+
+BlockCache::~BlockCache() = default;
+
+BlockCache::Shard& BlockCache::ShardFor(uint64_t hash) {
+    return *shards_[hash % shards_.size()];
+}
+
+bool BlockCache::Lookup(const std::string& key, uint64_t block, ByteBuffer* data) {
+    auto& shard = ShardFor(BlockHash(key, block));
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto kit = shard.index.find(key);
+    if (kit != shard.index.end()) {
+        auto bit = kit->second.find(block);
+        if (bit != kit->second.end()) {
+            auto& node = *bit->second;
+            node.freq = std::min<uint8_t>(node.freq + 1, kMaxFreq);
+            *data = node.data;
+            ++shard.stats.hits;
+            return true;
+        }
+    }
+    ++shard.stats.misses;
+    return false;
+}
+
+void BlockCache::Insert(const std::string& key, uint64_t block, ByteBuffer data) {
+    uint64_t hash = BlockHash(key, block);
+    auto& shard = ShardFor(hash);
+    uint64_t charge = data.size() + key.size() + kNodeOverhead;
+    if (charge > shard.capacity) return;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto kit = shard.index.find(key);
+    if (kit != shard.index.end()) {
+        auto bit = kit->second.find(block);
+        if (bit != kit->second.end()) shard.Unlink(bit->second);
+    }
+    shard.MakeRoom(charge);
+
+    // 近期被淘汰过的块说明不是一次性访问, 直接进 main
+    bool in_main = shard.ghost.erase(hash) > 0;
+    auto& list = in_main ? shard.main : shard.small;
+    list.push_front(Shard::Node{key, block, hash, std::move(data), charge, 0, in_main});
+    (in_main ? shard.main_bytes : shard.small_bytes) += charge;
+    shard.index[key][block] = list.begin();
+
+    ++shard.stats.inserts;
+    ++shard.stats.entries;
+    if (in_main) ++shard.stats.ghost_hits;
+}
+
+void BlockCache::EraseObject(const std::string& key) {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        auto kit = shard->index.find(key);
+        if (kit == shard->index.end()) continue;
+        std::vector<Shard::List::iterator> nodes;
+        for (auto& [block, it] : kit->second) nodes.push_back(it);
+        for (auto it : nodes) shard->Unlink(it);
+    }
+}
+
+BlockCache::Stats BlockCache::stats() const {
+    Stats total;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total.hits += shard->stats.hits;
+        total.misses += shard->stats.misses;
+        total.inserts += shard->stats.inserts;
+        total.evictions += shard->stats.evictions;
+        total.ghost_hits += shard->stats.ghost_hits;
+        total.entries += shard->stats.entries;
+        total.bytes += shard->Bytes();
+    }
+    return total;
+}
+
+// ================================
+// MemoryCacheBackend
+// ================================
+
+MemoryCacheBackend::MemoryCacheBackend(Config config, std::shared_ptr<StorageBackend> inner)
+    : config_(config),
+      inner_(std::move(inner)),
+      cache_(config.cache) {
+    if (config_.block_size == 0) config_.block_size = 256ULL << 10;
+}
+
+void MemoryCacheBackend::InsertBlocks(const std::string& key, uint64_t first_block,
+                                      const ByteBuffer& data, uint64_t requested) {
+    const uint64_t bs = config_.block_size;
+    uint64_t block = first_block;
+    for (uint64_t off = 0; off < data.size(); off += bs, ++block) {
+        cache_.Insert(key, block, data.Slice(off, bs).Clone());
+    }
+    // 对象长度恰为块大小整数倍时, 用空块标记结尾
+    if (data.size() < requested && data.size() % bs == 0) {
+        cache_.Insert(key, block, ByteBuffer());
+    }
+}
+
+AsyncTask<Status> MemoryCacheBackend::LoadBlocks(const std::string& key, uint64_t first,
+                                                 uint64_t last, std::vector<ByteBuffer>* blocks) {
+    const uint64_t bs = config_.block_size;
+    blocks->clear();
+
+    for (uint64_t b = first; b <= last;) {
+        ByteBuffer block;
+        if (cache_.Lookup(key, b, &block)) {
+            bool short_block = block.size() < bs;
+            blocks->push_back(std::move(block));
+            if (short_block) break;
+            ++b;
+            continue;
+        }
+
+        // 连续未命中的块合并为一次下层读, 遇到命中块为止
+        uint64_t run_end = b;
+        ByteBuffer next_hit;
+        bool has_next_hit = false;
+        while (run_end < last) {
+            if (cache_.Lookup(key, run_end + 1, &next_hit)) {
+                has_next_hit = true;
+                break;
+            }
+            ++run_end;
+        }
+
+        uint64_t requested = (run_end - b + 1) * bs;
+        ByteBuffer data;
+        auto status = co_await inner_->GetRange(key, b * bs, requested, &data);
+        if (!status.OK()) {
+            co_return status;
+        }
+        InsertBlocks(key, b, data, requested);
+        for (uint64_t off = 0; off < data.size(); off += bs) {
+            blocks->push_back(data.Slice(off, bs));
+        }
+        if (data.size() < requested) break;
+
+        if (has_next_hit) {
+            bool short_block = next_hit.size() < bs;
+            blocks->push_back(std::move(next_hit));
+            if (short_block) break;
+            b = run_end + 2;
+        } else {
+            b = run_end + 1;
+        }
+    }
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> MemoryCacheBackend::GetRange(
+    const std::string& key,
+    uint64_t offset,
+    uint64_t size,
+    ByteBuffer* data
+) {
+    if (size == 0) {
+        *data = ByteBuffer();
+        co_return Status::Ok();
+    }
+    const uint64_t bs = config_.block_size;
+    uint64_t first = offset / bs;
+    std::vector<ByteBuffer> blocks;
+    auto status = co_await LoadBlocks(key, first, (offset + size - 1) / bs, &blocks);
+    if (!status.OK()) {
+        co_return status;
+    }
+
+    *data = CopyBlocks(blocks, offset - first * bs, size);
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> MemoryCacheBackend::GetRangeInto(
+    const std::string& key,
+    uint64_t offset,
+    uint64_t size,
+    uint8_t* dst,
+    uint64_t* bytes_read
+) {
+    *bytes_read = 0;
+    if (size == 0) {
+        co_return Status::Ok();
+    }
+    const uint64_t bs = config_.block_size;
+    uint64_t first = offset / bs;
+    std::vector<ByteBuffer> blocks;
+    auto status = co_await LoadBlocks(key, first, (offset + size - 1) / bs, &blocks);
+    if (!status.OK()) {
+        co_return status;
+    }
+
+    uint64_t skip = offset - first * bs;
+    uint64_t copied = 0;
+    for (const auto& block : blocks) {
+        if (skip >= block.size()) break;
+        uint64_t n = std::min<uint64_t>(block.size() - skip, size - copied);
+        std::memcpy(dst + copied, block.data() + skip, n);
+        copied += n;
+        skip = 0;
+    }
+    *bytes_read = copied;
+    co_return Status::Ok();
+}
+
+bool MemoryCacheBackend::LookupObject(const std::string& key, ByteBuffer* data) {
+    const uint64_t bs = config_.block_size;
+
+    // 从块 0 起全部命中且遇到结尾块时才算命中
+    std::vector<ByteBuffer> blocks;
+    ByteBuffer block;
+    while (cache_.Lookup(key, blocks.size(), &block)) {
+        bool last = block.size() < bs;
+        blocks.push_back(std::move(block));
+        if (last) {
+            *data = CopyBlocks(blocks, 0, blocks.size() * bs);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MemoryCacheBackend::LookupRange(const std::string& key, uint64_t offset, uint64_t size,
+                                     ByteBuffer* data) {
+    const uint64_t bs = config_.block_size;
+    uint64_t first = offset / bs;
+    uint64_t last = (offset + size - 1) / bs;
+    std::vector<ByteBuffer> blocks;
+    for (uint64_t b = first; b <= last; ++b) {
+        ByteBuffer block;
+        if (!cache_.Lookup(key, b, &block)) return false;
+        bool short_block = block.size() < bs;
+        blocks.push_back(std::move(block));
+        if (short_block) break;
+    }
+    *data = CopyBlocks(blocks, offset - first * bs, size);
+    return true;
+}
+
+AsyncTask<Status> MemoryCacheBackend::Get(const std::string& key, ByteBuffer* data) {
+    if (LookupObject(key, data)) {
+        co_return Status::Ok();
+    }
+
+    auto status = co_await inner_->Get(key, data);
+    if (!status.OK()) {
+        co_return status;
+    }
+    InsertBlocks(key, 0, *data, UINT64_MAX);
+    co_return Status::Ok();
+}
+
+AsyncTask<Status> MemoryCacheBackend::Put(const std::string& key, const ByteBuffer& data) {
+    cache_.EraseObject(key);
+    auto status = co_await inner_->Put(key, data);
+    // 写入期间并发读可能回填了旧数据
+    cache_.EraseObject(key);
+    co_return status;
+}
+
+AsyncTask<Status> MemoryCacheBackend::Delete(const std::string& key) {
+    cache_.EraseObject(key);
+    co_return co_await inner_->Delete(key);
+}
+
+AsyncTask<Status> MemoryCacheBackend::Exists(const std::string& key) {
+    co_return co_await inner_->Exists(key);
+}
+
+AsyncTask<void> MemoryCacheBackend::BatchRead(
+    const std::vector<ReadRequest>& requests,
+    std::vector<ReadResult>* results,
+    uint32_t max_concurrency
+) {
+    results->assign(requests.size(), ReadResult{});
+    const uint64_t bs = config_.block_size;
+
+    std::vector<size_t> missed;
+    std::vector<ReadRequest> inner_requests;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto& req = requests[i];
+        auto* out = &(*results)[i].data;
+        if (req.size == 0 ? LookupObject(req.key, out) : LookupRange(req.key, req.offset, req.size, out)) {
+            continue;
+        }
+        missed.push_back(i);
+        if (req.size == 0) {
+            inner_requests.push_back(req);
+        } else {
+            // 按块对齐读取, 返回后整块回填
+            uint64_t first = req.offset / bs;
+            uint64_t last = (req.offset + req.size - 1) / bs;
+            inner_requests.push_back(ReadRequest{req.key, first * bs, (last - first + 1) * bs});
+        }
+    }
+    if (missed.empty()) {
+        co_return;
+    }
+
+    std::vector<ReadResult> inner_results;
+    co_await inner_->BatchRead(inner_requests, &inner_results, max_concurrency);
+    for (size_t j = 0; j < missed.size(); ++j) {
+        const auto& req = requests[missed[j]];
+        const auto& aligned = inner_requests[j];
+        auto& result = inner_results[j];
+        auto& out = (*results)[missed[j]];
+        out.status = std::move(result.status);
+        if (!out.status.OK()) {
+            continue;
+        }
+        if (req.size == 0) {
+            InsertBlocks(req.key, 0, result.data, UINT64_MAX);
+            out.data = std::move(result.data);
+        } else {
+            InsertBlocks(req.key, aligned.offset / bs, result.data, aligned.size);
+            out.data = result.data.Slice(req.offset - aligned.offset, req.size);
+        }
+    }
+}
+
+AsyncTask<Status> MemoryCacheBackend::HealthCheck() {
+    co_return co_await inner_->HealthCheck();
+}
+
+AsyncTask<Status> MemoryCacheBackend::GetCapacity(CapacityInfo* info) {
+    co_return co_await inner_->GetCapacity(info);
+}
+
+} // namespace nebulastore::storage
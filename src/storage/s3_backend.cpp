@@ -3,330 +3,1359 @@
 // ================================
 
 #include "nebulastore/storage/backend.h"
+#include "nebulastore/storage/s3_client.h"
 #include "nebulastore/common/logger.h"
 #include <curl/curl.h>
-#include <openssl/hmac.h>
-#include <openssl/sha.h>
-#include <iomanip>
-#include <sstream>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/opensslv.h>
 #include <ctime>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cctype>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
 namespace nebulastore::storage {
 
 // ================================
-// S3 签名和 HTTP 辅助类
+// curl 句柄池
 // ================================
+//
+// 句柄用完 curl_easy_reset 后放回池中, 保留其 keep-alive 连接; 所有句柄
+// 通过 CURLSH 共享连接缓存、DNS 缓存与 TLS 会话, 任一句柄建立的连接都可
+// 被其他句柄复用. 句柄数上限为 max_connections, 超出时 Acquire 等待归还.
 
-class S3Backend::S3Client {
+class CurlPool {
 public:
-    explicit S3Client(const Config& config) : config_(config) {
-        curl_global_init(CURL_GLOBAL_DEFAULT);
+    CurlPool(uint32_t max_handles, bool http2)
+        : max_handles_(std::max<uint32_t>(max_handles, 1)), http2_(http2) {
+        share_ = curl_share_init();
+        if (share_) {
+            curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, LockShare);
+            curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+            curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        }
     }
 
-    ~S3Client() {
-        curl_global_cleanup();
+    // 调用方须先归还所有句柄
+    ~CurlPool() {
+        for (CURL* curl : idle_) {
+            curl_easy_cleanup(curl);
+        }
+        if (share_) {
+            curl_share_cleanup(share_);
+        }
     }
 
-    // PUT 对象
-    Status PutObject(const std::string& key, const ByteBuffer& data) {
-        auto url = BuildUrl(key);
-        auto headers = BuildHeaders("PUT", key, data.size());
+    CurlPool(const CurlPool&) = delete;
+    CurlPool& operator=(const CurlPool&) = delete;
+
+    // 取一个已设置好公共选项的句柄; 创建失败返回 nullptr
+    CURL* Acquire() {
+        CURL* curl = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return !idle_.empty() || created_ < max_handles_; });
+            if (!idle_.empty()) {
+                curl = idle_.back();
+                idle_.pop_back();
+            } else {
+                curl = curl_easy_init();
+                if (!curl) return nullptr;
+                ++created_;
+            }
+        }
+        ApplyDefaults(curl);
+        return curl;
+    }
 
-        CURL* curl = curl_easy_init();
-        if (!curl) return Status::IO("Failed to init curl");
+    // 不等待: 池已耗尽时返回 nullptr
+    CURL* TryAcquire() {
+        CURL* curl = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                curl = idle_.back();
+                idle_.pop_back();
+            } else if (created_ < max_handles_) {
+                curl = curl_easy_init();
+                if (!curl) return nullptr;
+                ++created_;
+            } else {
+                return nullptr;
+            }
+        }
+        ApplyDefaults(curl);
+        return curl;
+    }
 
-        struct curl_slist* header_list = nullptr;
-        for (const auto& h : headers) {
-            header_list = curl_slist_append(header_list, h.c_str());
+    bool http2() const { return http2_; }
+
+    void Release(CURL* curl) {
+        // reset 清除请求选项, 但保留连接、DNS 与会话缓存
+        curl_easy_reset(curl);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.push_back(curl);
         }
+        cv_.notify_one();
+    }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
-        curl_easy_setopt(curl, CURLOPT_READDATA, &data);
-        curl_easy_setopt(curl, CURLOPT_READFUNCTION, ReadCallback);
-        curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(data.size()));
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+private:
+    void ApplyDefaults(CURL* curl) {
+        if (share_) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+        }
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+        curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, static_cast<long>(max_handles_));
+        // TLS 连接上经 ALPN 协商 HTTP/2, 明文连接保持 HTTP/1.1
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION,
+                         http2_ ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1);
+    }
 
-        CURLcode res = curl_easy_perform(curl);
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    static void LockShare(CURL*, curl_lock_data data, curl_lock_access, void* userp) {
+        static_cast<CurlPool*>(userp)->share_locks_[data].lock();
+    }
 
-        curl_slist_free_all(header_list);
-        curl_easy_cleanup(curl);
+    static void UnlockShare(CURL*, curl_lock_data data, void* userp) {
+        static_cast<CurlPool*>(userp)->share_locks_[data].unlock();
+    }
 
-        if (res != CURLE_OK) {
-            return Status::IO(std::string("curl error: ") + curl_easy_strerror(res));
-        }
-        if (http_code >= 400) {
-            return Status::IO("S3 PUT failed, HTTP " + std::to_string(http_code));
-        }
-        return Status::Ok();
+    const uint32_t max_handles_;
+    const bool http2_;
+    CURLSH* share_ = nullptr;
+    std::mutex share_locks_[CURL_LOCK_DATA_LAST];
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<CURL*> idle_;
+    uint32_t created_ = 0;
+};
+
+// ================================
+// AWS SigV4 签名
+// ================================
+
+// 每线程一个摘要上下文; OpenSSL 3 下预取算法实现, 免去每次按名查找
+struct SigV4Signer::DigestContext {
+    EVP_MD_CTX* ctx = nullptr;
+    const EVP_MD* md = nullptr;
+
+    DigestContext() {
+        ctx = EVP_MD_CTX_new();
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        fetched_ = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+        md = fetched_ ? fetched_ : EVP_sha256();
+#else
+        md = EVP_sha256();
+#endif
     }
+    ~DigestContext() {
+        EVP_MD_CTX_free(ctx);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        EVP_MD_free(fetched_);
+#endif
+    }
+    DigestContext(const DigestContext&) = delete;
+    DigestContext& operator=(const DigestContext&) = delete;
 
-    // GET 对象
-    Status GetObject(const std::string& key, ByteBuffer* data) {
-        auto url = BuildUrl(key);
-        auto headers = BuildHeaders("GET", key, 0);
+    static DigestContext& Get() {
+        thread_local DigestContext instance;
+        return instance;
+    }
 
-        CURL* curl = curl_easy_init();
-        if (!curl) return Status::IO("Failed to init curl");
+private:
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MD* fetched_ = nullptr;
+#endif
+};
 
-        struct curl_slist* header_list = nullptr;
-        for (const auto& h : headers) {
-            header_list = curl_slist_append(header_list, h.c_str());
-        }
+std::vector<std::string> SigV4Signer::Sign(std::string_view method, std::string_view host,
+                                           std::string_view canonical_uri, std::string_view query,
+                                           time_t now) const {
+    static constexpr std::string_view kAlgorithm = "AWS4-HMAC-SHA256";
+    static constexpr std::string_view kSignedHeaders = "host;x-amz-content-sha256;x-amz-date";
+    static constexpr std::string_view kPayloadHash = "UNSIGNED-PAYLOAD";
+
+    std::string_view date = AmzDate(now);
+    std::string_view date_stamp = date.substr(0, 8);
+    Digest signing_key = SigningKey(date_stamp);
+
+    thread_local std::string canonical;
+    canonical.clear();
+    canonical.append(method).append("\n")
+             .append(canonical_uri).append("\n")
+             .append(query).append("\n")
+             .append("host:").append(host).append("\n")
+             .append("x-amz-content-sha256:").append(kPayloadHash).append("\n")
+             .append("x-amz-date:").append(date).append("\n\n")
+             .append(kSignedHeaders).append("\n")
+             .append(kPayloadHash);
+
+    unsigned char digest[kDigestSize];
+    Sha256(canonical, digest);
+
+    // credential scope 紧跟在 string-to-sign 的日期行之后, 记下位置供 Authorization 复用
+    thread_local std::string to_sign;
+    to_sign.clear();
+    to_sign.append(kAlgorithm).append("\n").append(date).append("\n");
+    size_t scope_begin = to_sign.size();
+    to_sign.append(date_stamp).append("/").append(region_).append("/s3/aws4_request");
+    size_t scope_end = to_sign.size();
+    to_sign.append("\n");
+    AppendHex(&to_sign, digest, kDigestSize);
+
+    unsigned char signature[kDigestSize];
+    HmacSha256(signing_key.data(), signing_key.size(), to_sign, signature);
+    std::string_view scope(to_sign.data() + scope_begin, scope_end - scope_begin);
+
+    std::vector<std::string> headers(4);
+    headers[0].reserve(6 + host.size());
+    headers[0].append("Host: ").append(host);
+    headers[1].reserve(12 + date.size());
+    headers[1].append("x-amz-date: ").append(date);
+    headers[2].reserve(22 + kPayloadHash.size());
+    headers[2].append("x-amz-content-sha256: ").append(kPayloadHash);
+    auto& auth = headers[3];
+    auth.reserve(64 + access_key_.size() + scope.size() + kSignedHeaders.size() + 2 * kDigestSize);
+    auth.append("Authorization: ").append(kAlgorithm)
+        .append(" Credential=").append(access_key_).append("/").append(scope)
+        .append(", SignedHeaders=").append(kSignedHeaders)
+        .append(", Signature=");
+    AppendHex(&auth, signature, kDigestSize);
+    return headers;
+}
 
-        std::vector<uint8_t> buffer;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+void SigV4Signer::Sha256(std::string_view data, unsigned char* out) {
+    auto& d = DigestContext::Get();
+    EVP_DigestInit_ex(d.ctx, d.md, nullptr);
+    EVP_DigestUpdate(d.ctx, data.data(), data.size());
+    EVP_DigestFinal_ex(d.ctx, out, nullptr);
+}
 
-        CURLcode res = curl_easy_perform(curl);
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+void SigV4Signer::HmacSha256(const unsigned char* key, size_t key_len, std::string_view data,
+                             unsigned char* out) {
+    static constexpr size_t kBlockSize = 64;
+    unsigned char pad[kBlockSize] = {};
+    if (key_len > kBlockSize) {
+        Sha256(std::string_view(reinterpret_cast<const char*>(key), key_len), pad);
+    } else {
+        std::memcpy(pad, key, key_len);
+    }
 
-        curl_slist_free_all(header_list);
-        curl_easy_cleanup(curl);
+    auto& d = DigestContext::Get();
+    unsigned char inner[kDigestSize];
+    for (auto& b : pad) b ^= 0x36;
+    EVP_DigestInit_ex(d.ctx, d.md, nullptr);
+    EVP_DigestUpdate(d.ctx, pad, kBlockSize);
+    EVP_DigestUpdate(d.ctx, data.data(), data.size());
+    EVP_DigestFinal_ex(d.ctx, inner, nullptr);
+
+    for (auto& b : pad) b ^= 0x36 ^ 0x5c;
+    EVP_DigestInit_ex(d.ctx, d.md, nullptr);
+    EVP_DigestUpdate(d.ctx, pad, kBlockSize);
+    EVP_DigestUpdate(d.ctx, inner, kDigestSize);
+    EVP_DigestFinal_ex(d.ctx, out, nullptr);
+    OPENSSL_cleanse(pad, sizeof(pad));
+}
 
-        if (res != CURLE_OK) {
-            return Status::IO(std::string("curl error: ") + curl_easy_strerror(res));
+SigV4Signer::Digest SigV4Signer::DeriveKey(std::string_view secret, std::string_view date_stamp,
+                                           std::string_view region, std::string_view service) {
+    std::string seed;
+    seed.reserve(4 + secret.size());
+    seed.append("AWS4").append(secret);
+    Digest k;
+    HmacSha256(reinterpret_cast<const unsigned char*>(seed.data()), seed.size(), date_stamp, k.data());
+    HmacSha256(k.data(), k.size(), region, k.data());
+    HmacSha256(k.data(), k.size(), service, k.data());
+    HmacSha256(k.data(), k.size(), "aws4_request", k.data());
+    OPENSSL_cleanse(seed.data(), seed.size());
+    return k;
+}
+
+void SigV4Signer::AppendHex(std::string* out, const unsigned char* data, size_t len) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    size_t pos = out->size();
+    out->resize(pos + 2 * len);
+    char* p = out->data() + pos;
+    for (size_t i = 0; i < len; ++i) {
+        *p++ = kHex[data[i] >> 4];
+        *p++ = kHex[data[i] & 0x0f];
+    }
+}
+
+std::string_view SigV4Signer::AmzDate(time_t now) {
+    thread_local time_t cached_time = -1;
+    thread_local char buf[17];
+    if (now != cached_time) {
+        struct tm tm_buf;
+        gmtime_r(&now, &tm_buf);
+        strftime(buf, sizeof(buf), "%Y%m%dT%H%M%SZ", &tm_buf);
+        cached_time = now;
+    }
+    return std::string_view(buf, 16);
+}
+
+SigV4Signer::Digest SigV4Signer::SigningKey(std::string_view date_stamp) const {
+    std::lock_guard<std::mutex> lock(key_mutex_);
+    if (date_stamp != std::string_view(key_date_, sizeof(key_date_))) {
+        key_ = DeriveKey(secret_key_, date_stamp, region_, "s3");
+        std::memcpy(key_date_, date_stamp.data(), sizeof(key_date_));
+    }
+    return key_;
+}
+
+// ================================
+// 延迟直方图
+// ================================
+
+void LatencyHistogram::Record(uint64_t micros) {
+    buckets_[Bucket(micros)].fetch_add(1, std::memory_order_relaxed);
+    if (total_.fetch_add(1, std::memory_order_relaxed) + 1 >= kDecaySamples) {
+        Decay();
+    }
+}
+
+uint64_t LatencyHistogram::Percentile(double p) const {
+    uint64_t counts[kBuckets];
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) return 0;
+    auto target = static_cast<uint64_t>(std::ceil(p * static_cast<double>(total)));
+    target = std::clamp<uint64_t>(target, 1, total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= target) return UpperBound(i);
+    }
+    return UpperBound(kBuckets - 1);
+}
+
+size_t LatencyHistogram::Bucket(uint64_t v) {
+    if (v < (1u << kSubBits)) return static_cast<size_t>(v);
+    int msb = 63 - __builtin_clzll(v);
+    uint64_t sub = (v >> (msb - kSubBits)) & ((1u << kSubBits) - 1);
+    return (static_cast<size_t>(msb - kSubBits + 1) << kSubBits) + sub;
+}
+
+uint64_t LatencyHistogram::UpperBound(size_t bucket) {
+    if (bucket < (1u << kSubBits)) return bucket;
+    int msb = static_cast<int>(bucket >> kSubBits) + kSubBits - 1;
+    uint64_t sub = bucket & ((1u << kSubBits) - 1);
+    uint64_t width = 1ULL << (msb - kSubBits);
+    uint64_t lower = (1ULL << msb) + sub * width;
+    return lower + (width - 1);
+}
+
+void LatencyHistogram::Decay() {
+    std::unique_lock<std::mutex> lock(decay_mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || total_.load(std::memory_order_relaxed) < kDecaySamples) return;
+    uint64_t remaining = 0;
+    for (auto& bucket : buckets_) {
+        uint64_t v = bucket.load(std::memory_order_relaxed);
+        bucket.fetch_sub(v / 2, std::memory_order_relaxed);
+        remaining += v - v / 2;
+    }
+    total_.store(remaining, std::memory_order_relaxed);
+}
+
+// ================================
+// 对冲预算
+// ================================
+
+void HedgeBudget::Earn() {
+    int64_t tokens = tokens_.load(std::memory_order_relaxed);
+    while (tokens < cap_ &&
+           !tokens_.compare_exchange_weak(tokens, std::min<int64_t>(cap_, tokens + percent_),
+                                          std::memory_order_relaxed)) {
+    }
+}
+
+bool HedgeBudget::Take() {
+    int64_t tokens = tokens_.load(std::memory_order_relaxed);
+    while (tokens >= 100) {
+        if (tokens_.compare_exchange_weak(tokens, tokens - 100, std::memory_order_relaxed)) {
+            return true;
         }
-        if (http_code == 404) {
-            return Status::NotFound("Object not found: " + key);
+    }
+    return false;
+}
+
+// ================================
+// 批量范围读规划
+// ================================
+
+std::vector<RangeFetch> PlanRangeFetches(const std::vector<StorageBackend::ReadRequest>& requests) {
+    std::vector<RangeFetch> fetches;
+    std::vector<size_t> ranges;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (requests[i].size == 0) {
+            fetches.push_back(RangeFetch{requests[i].key, 0, 0, {i}});
+        } else {
+            ranges.push_back(i);
+        }
+    }
+    std::sort(ranges.begin(), ranges.end(), [&](size_t a, size_t b) {
+        const auto& ra = requests[a];
+        const auto& rb = requests[b];
+        return ra.key != rb.key ? ra.key < rb.key : ra.offset < rb.offset;
+    });
+    for (size_t i : ranges) {
+        const auto& req = requests[i];
+        if (!fetches.empty()) {
+            auto& last = fetches.back();
+            uint64_t last_end = last.offset + last.size;
+            uint64_t end = std::max(last_end, req.offset + req.size);
+            if (last.size != 0 && last.key == req.key &&
+                req.offset <= last_end + kRangeMergeGap && end - last.offset <= kMaxMergedRange) {
+                last.size = end - last.offset;
+                last.members.push_back(i);
+                continue;
+            }
+        }
+        fetches.push_back(RangeFetch{req.key, req.offset, req.size, {i}});
+    }
+    return fetches;
+}
+
+void DistributeRangeFetch(const RangeFetch& fetch, const Status& status, const ByteBuffer& body,
+                          const std::vector<StorageBackend::ReadRequest>& requests,
+                          std::vector<StorageBackend::ReadResult>* results) {
+    for (size_t i : fetch.members) {
+        auto& result = (*results)[i];
+        result.status = status;
+        if (!status.OK()) continue;
+        const auto& req = requests[i];
+        result.data = req.size == 0 ? body : body.Slice(req.offset - fetch.offset, req.size);
+    }
+}
+
+// ================================
+// S3 签名和 HTTP 辅助类
+// ================================
+
+class S3Backend::S3Client {
+public:
+    explicit S3Client(const Config& config)
+        : config_(config),
+          global_(),
+          pool_(config.max_connections, config.http2),
+          signer_(config.access_key, config.secret_key, config.region),
+          host_(Host()),
+          hedge_budget_(config.hedge_budget_percent) {}
+
+    // PUT 对象
+    Status PutObject(const std::string& key, const ByteBuffer& data) {
+        ReadContext ctx{&data, 0};
+        long http_code = 0;
+        auto status = Perform(BuildUrl(key), BuildHeaders("PUT", key, data.size()), [&](CURL* curl) {
+            ctx.offset = 0;
+            curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+            curl_easy_setopt(curl, CURLOPT_READDATA, &ctx);
+            curl_easy_setopt(curl, CURLOPT_READFUNCTION, ReadCallback);
+            // 复用的连接失效时 curl 需要回绕请求体重发
+            curl_easy_setopt(curl, CURLOPT_SEEKDATA, &ctx);
+            curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, SeekCallback);
+            curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(data.size()));
+        }, &http_code);
+        if (!status.OK()) {
+            return status;
         }
         if (http_code >= 400) {
-            return Status::IO("S3 GET failed, HTTP " + std::to_string(http_code));
+            return Status::IO("S3 PUT failed, HTTP " + std::to_string(http_code));
+        }
+        return Status::Ok();
+    }
+
+    // GET 对象
+    Status GetObject(const std::string& key, ByteBuffer* data) {
+        // 按 Content-Length 一次分配, 响应体直接写入最终缓冲区
+        std::array<BodySink, 2> sinks;
+        BodySink* body = nullptr;
+        auto status = HedgedGet(key, "", &sinks, [](BodySink* sink, bool) {
+            sink->buffer = ByteBuffer();
+        }, &body);
+        if (!status.OK()) {
+            return status;
         }
 
         if (data) {
-            data->assign(std::move(buffer));
+            body->buffer.Truncate(body->written);
+            *data = std::move(body->buffer);
         }
         return Status::Ok();
     }
 
     // GET 范围
     Status GetObjectRange(const std::string& key, uint64_t offset, uint64_t size, ByteBuffer* data) {
-        auto url = BuildUrl(key);
-        auto headers = BuildHeaders("GET", key, 0);
-        headers.push_back("Range: bytes=" + std::to_string(offset) + "-" + std::to_string(offset + size - 1));
+        // 长度已知: 响应体直接写入最终缓冲区, 无需增长与再拷贝
+        std::array<BodySink, 2> sinks;
+        BodySink* body = nullptr;
+        auto status = HedgedGet(key, RangeSpec(offset, size), &sinks, [&](BodySink* sink, bool) {
+            if (sink->buffer.size() != size) sink->buffer = ByteBuffer::Allocate(size);
+            sink->fixed = true;
+        }, &body);
+        if (!status.OK()) {
+            return status;
+        }
 
-        CURL* curl = curl_easy_init();
-        if (!curl) return Status::IO("Failed to init curl");
+        if (data) {
+            body->buffer.Truncate(body->written);
+            *data = std::move(body->buffer);
+        }
+        return Status::Ok();
+    }
 
-        struct curl_slist* header_list = nullptr;
-        for (const auto& h : headers) {
-            header_list = curl_slist_append(header_list, h.c_str());
+    // GET 范围直接写入调用方内存, 越过对象末尾时短读
+    Status GetObjectInto(const std::string& key, uint64_t offset, uint64_t size, uint8_t* dst,
+                         uint64_t* bytes_read) {
+        // 调用方内存只在本次同步请求内使用; 对冲副本写入自己的缓冲区, 胜出时再拷入
+        std::array<BodySink, 2> sinks;
+        BodySink* body = nullptr;
+        auto status = HedgedGet(key, RangeSpec(offset, size), &sinks, [&](BodySink* sink, bool hedge) {
+            if (!hedge) {
+                sink->buffer = ByteBuffer::Unowned(dst, size);
+            } else if (sink->buffer.size() != size) {
+                sink->buffer = ByteBuffer::Allocate(size);
+            }
+            sink->fixed = true;
+        }, &body);
+        if (!status.OK()) {
+            return status;
         }
+        if (body != &sinks[0] && body->written > 0) {
+            std::memcpy(dst, body->buffer.data(), body->written);
+        }
+        *bytes_read = body->written;
+        return Status::Ok();
+    }
 
-        std::vector<uint8_t> buffer;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+    // 流式 GET: 响应体按 curl 收到的块顺序交给 sink, 不在内存中缓冲;
+    // size == 0 读到对象末尾. sink 返回错误时中止传输并返回该错误
+    Status GetObjectStream(const std::string& key, uint64_t offset, uint64_t size, const ChunkSink& sink) {
+        auto headers = BuildHeaders("GET", key, 0);
+        bool range = offset > 0 || size > 0;
+        if (range) {
+            headers.push_back("Range: bytes=" + (size > 0 ? RangeSpec(offset, size)
+                                                           : std::to_string(offset) + "-"));
+        }
 
-        CURLcode res = curl_easy_perform(curl);
+        StreamContext ctx{nullptr, &sink, Status::Ok(), 0};
         long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        auto status = Perform(BuildUrl(key), headers, [&](CURL* curl) {
+            ctx.curl = curl;
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ctx);
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, StreamWriteCallback);
+        }, &http_code, [&] {
+            // 已交给 sink 的数据无法收回, 只在尚未交付时重试
+            return ctx.delivered == 0;
+        });
+        if (!ctx.status.OK()) {
+            return ctx.status;
+        }
+        if (!status.OK()) {
+            return status;
+        }
+        return GetStatus(key, http_code, range);
+    }
 
-        curl_slist_free_all(header_list);
-        curl_easy_cleanup(curl);
+    // 并发批量 GET (curl multi): 在途传输数不超过 max_concurrency 与句柄池上限,
+    // 同一对象相邻 (间隙不超过 kRangeMergeGap) 的范围请求合并为一次范围 GET
+    void MultiGet(const std::vector<ReadRequest>& requests, std::vector<ReadResult>* results,
+                  uint32_t max_concurrency) {
+        results->assign(requests.size(), ReadResult{});
+        auto fetches = PlanRangeFetches(requests);
+        std::vector<std::unique_ptr<Transfer>> transfers(fetches.size());
+
+        RunConcurrent(fetches.size(), max_concurrency,
+            [&](size_t i, CURL* curl) {
+                transfers[i] = std::make_unique<Transfer>();
+                return StartTransfer(curl, fetches[i], transfers[i].get());
+            },
+            [&](size_t i, const Status& result, long http_code) {
+                const auto& fetch = fetches[i];
+                Status status = result.OK() ? GetStatus(fetch.key, http_code, fetch.size != 0) : result;
+                ByteBuffer body;
+                if (status.OK()) {
+                    auto& sink = transfers[i]->sink;
+                    sink.buffer.Truncate(sink.written);
+                    body = std::move(sink.buffer);
+                }
+                DistributeRangeFetch(fetch, status, body, requests, results);
+                transfers[i].reset();
+                return Outcome::kDone;
+            });
+    }
 
-        if (res != CURLE_OK) {
-            return Status::IO(std::string("curl error: ") + curl_easy_strerror(res));
-        }
-        if (http_code == 404) {
-            return Status::NotFound("Object not found: " + key);
+    // 分片上传: 创建上传 → 并发上传各分片 (单片失败重试) → 完成; 失败时中止上传,
+    // 服务端丢弃已上传的分片
+    Status MultipartPut(const std::string& key, const ByteBuffer& data) {
+        std::string upload_id;
+        auto status = CreateMultipartUpload(key, &upload_id);
+        if (!status.OK()) {
+            return status;
         }
-        if (http_code >= 400 && http_code != 206) {
-            return Status::IO("S3 GET range failed, HTTP " + std::to_string(http_code));
+
+        uint64_t part_size = std::max(config_.part_size, kMinPartSize);
+        size_t count = static_cast<size_t>((data.size() + part_size - 1) / part_size);
+        std::vector<Part> parts(count);
+        for (size_t i = 0; i < count; ++i) {
+            parts[i].data = data.Slice(i * part_size, part_size);
         }
 
-        if (data) {
-            data->assign(std::move(buffer));
+        Status error;
+        RunConcurrent(count, config_.upload_concurrency,
+            [&](size_t i, CURL* curl) {
+                return StartPartUpload(curl, key, upload_id, i + 1, &parts[i]);
+            },
+            [&](size_t i, const Status& result, long http_code) {
+                auto& part = parts[i];
+                Status part_status = result;
+                if (part_status.OK() && http_code >= 400) {
+                    part_status = Status::IO("S3 upload part failed, HTTP " + std::to_string(http_code));
+                } else if (part_status.OK() && part.etag.empty()) {
+                    part_status = Status::IO("S3 upload part returned no ETag");
+                }
+                if (part_status.OK()) {
+                    return Outcome::kDone;
+                }
+                if (++part.attempts <= config_.max_part_retries) {
+                    LOG_WARN("S3 upload part %zu of %s failed (%s), retry %u", i + 1, key.c_str(),
+                             part_status.message().c_str(), part.attempts);
+                    return Outcome::kRetry;
+                }
+                error = part_status;
+                return Outcome::kStop;
+            });
+
+        if (error.OK()) {
+            error = CompleteMultipartUpload(key, upload_id, parts);
         }
-        return Status::Ok();
+        if (!error.OK()) {
+            auto abort_status = AbortMultipartUpload(key, upload_id);
+            if (!abort_status.OK()) {
+                LOG_WARN("S3 abort multipart upload of %s failed: %s", key.c_str(),
+                         abort_status.message().c_str());
+            }
+        }
+        return error;
     }
 
     // DELETE 对象
     Status DeleteObject(const std::string& key) {
-        auto url = BuildUrl(key);
-        auto headers = BuildHeaders("DELETE", key, 0);
-
-        CURL* curl = curl_easy_init();
-        if (!curl) return Status::IO("Failed to init curl");
+        long http_code = 0;
+        auto status = Perform(BuildUrl(key), BuildHeaders("DELETE", key, 0), [](CURL* curl) {
+            curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+        }, &http_code);
+        if (!status.OK()) {
+            return status;
+        }
+        if (http_code >= 400 && http_code != 404) {
+            return Status::IO("S3 DELETE failed, HTTP " + std::to_string(http_code));
+        }
+        return Status::Ok();
+    }
 
-        struct curl_slist* header_list = nullptr;
-        for (const auto& h : headers) {
-            header_list = curl_slist_append(header_list, h.c_str());
+    // HEAD 对象 (检查存在)
+    Status HeadObject(const std::string& key) {
+        long http_code = 0;
+        auto status = Perform(BuildUrl(key), BuildHeaders("HEAD", key, 0), [](CURL* curl) {
+            curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+        }, &http_code);
+        if (!status.OK()) {
+            return status;
+        }
+        if (http_code == 404) {
+            return Status::NotFound("Object not found");
+        }
+        if (http_code >= 400) {
+            return Status::IO("S3 HEAD failed, HTTP " + std::to_string(http_code));
         }
+        return Status::Ok();
+    }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+    Stats stats() const {
+        Stats stats;
+        stats.requests = requests_.load(std::memory_order_relaxed);
+        stats.retries = retries_.load(std::memory_order_relaxed);
+        stats.hedges = hedges_.load(std::memory_order_relaxed);
+        stats.hedge_wins = hedge_wins_.load(std::memory_order_relaxed);
+        stats.ttfb_p50_us = ttfb_.Percentile(0.50);
+        stats.ttfb_p95_us = ttfb_.Percentile(0.95);
+        stats.ttfb_p99_us = ttfb_.Percentile(0.99);
+        return stats;
+    }
 
-        CURLcode res = curl_easy_perform(curl);
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+private:
+    // curl 全局初始化须早于句柄池创建、晚于其销毁
+    struct CurlGlobal {
+        CurlGlobal() { curl_global_init(CURL_GLOBAL_DEFAULT); }
+        ~CurlGlobal() { curl_global_cleanup(); }
+    };
+
+    Config config_;
+    CurlGlobal global_;
+    CurlPool pool_;
+    SigV4Signer signer_;
+    std::string host_;      // 构造时确定, 签名时直接引用
+
+    // 本端点 GET 首字节延迟, 驱动对冲阈值
+    LatencyHistogram ttfb_;
+    std::atomic<uint64_t> hedge_delay_us_{0};   // 缓存的对冲阈值
+    std::atomic<uint64_t> hedge_checks_{0};
+    HedgeBudget hedge_budget_;
+
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> retries_{0};
+    std::atomic<uint64_t> hedges_{0};
+    std::atomic<uint64_t> hedge_wins_{0};
+
+    // 样本不足时不对冲; 阈值每隔若干次 GET 按最新 p95 刷新
+    static constexpr uint64_t kHedgeMinSamples = 64;
+    static constexpr uint64_t kHedgeRefreshInterval = 64;
+
+    // 响应体写入 buffer. 错误响应 (HTTP >= 400) 的响应体丢弃.
+    // fixed: buffer 为预分配的目标, 超出容量视为错误 (返回值不等于输入长度时 curl 中止);
+    // 否则首次回调按 Content-Length 一次分配, 长度未知 (chunked) 时倍增扩容
+    struct BodySink {
+        CURL* curl = nullptr;
+        ByteBuffer buffer;
+        size_t written = 0;
+        bool fixed = false;
+    };
 
+    // 从池中取句柄执行一次请求, setup 设置请求相关选项 (每次尝试前调用, 须可重入).
+    // 可重试的错误按退避重试; can_retry 非空时还须它允许
+    Status Perform(const std::string& url, const std::vector<std::string>& headers,
+                   const std::function<void(CURL*)>& setup, long* http_code,
+                   const std::function<bool()>& can_retry = nullptr) {
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        struct curl_slist* header_list = HeaderList(headers);
+
+        CURLcode res = CURLE_OK;
+        for (uint32_t attempt = 0;; ++attempt) {
+            CURL* curl = pool_.Acquire();
+            if (!curl) {
+                curl_slist_free_all(header_list);
+                return Status::IO("Failed to init curl");
+            }
+            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+            setup(curl);
+
+            res = curl_easy_perform(curl);
+            *http_code = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, http_code);
+            pool_.Release(curl);
+
+            if (attempt >= config_.max_retries || !Retryable(res, *http_code) ||
+                (can_retry && !can_retry())) {
+                break;
+            }
+            LOG_WARN("S3 request %s failed (%s), retry %u", url.c_str(),
+                     Describe(res, *http_code).c_str(), attempt + 1);
+            Backoff(attempt);
+        }
         curl_slist_free_all(header_list);
-        curl_easy_cleanup(curl);
 
         if (res != CURLE_OK) {
             return Status::IO(std::string("curl error: ") + curl_easy_strerror(res));
         }
-        if (http_code >= 400 && http_code != 404) {
-            return Status::IO("S3 DELETE failed, HTTP " + std::to_string(http_code));
-        }
         return Status::Ok();
     }
 
-    // HEAD 对象 (检查存在)
-    Status HeadObject(const std::string& key) {
+    using PrepareSink = std::function<void(BodySink*, bool hedge)>;
+
+    // GET (带重试与对冲). prepare 在每份请求发出前初始化其响应体目标 (sinks[0] 为
+    // 主请求, sinks[1] 为对冲副本); 成功时 *body 指向先完成的一份
+    Status HedgedGet(const std::string& key, const std::string& range,
+                     std::array<BodySink, 2>* sinks, const PrepareSink& prepare, BodySink** body) {
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        auto headers = BuildHeaders("GET", key, 0);
+        if (!range.empty()) {
+            headers.push_back("Range: bytes=" + range);
+        }
+        struct curl_slist* header_list = HeaderList(headers);
         auto url = BuildUrl(key);
-        auto headers = BuildHeaders("HEAD", key, 0);
 
-        CURL* curl = curl_easy_init();
-        if (!curl) return Status::IO("Failed to init curl");
+        CURLcode res = CURLE_OK;
+        long http_code = 0;
+        size_t winner = 0;
+        for (uint32_t attempt = 0;; ++attempt) {
+            res = GetAttempt(url, header_list, sinks, prepare, &http_code, &winner);
+            if (attempt >= config_.max_retries || !Retryable(res, http_code)) {
+                break;
+            }
+            LOG_WARN("S3 GET %s failed (%s), retry %u", key.c_str(),
+                     Describe(res, http_code).c_str(), attempt + 1);
+            Backoff(attempt);
+        }
+        curl_slist_free_all(header_list);
+
+        if (res != CURLE_OK) {
+            return Status::IO(std::string("curl error: ") + curl_easy_strerror(res));
+        }
+        auto status = GetStatus(key, http_code, !range.empty());
+        if (status.OK()) {
+            *body = &(*sinks)[winner];
+        }
+        return status;
+    }
+
+    // 一次 GET 尝试. 主请求超过对冲阈值仍未收到响应体时, 在预算内再发一份相同请求,
+    // 取先完成且结果确定 (非可重试错误) 的一份; 另一份随即取消. 两份都失败时
+    // 返回后失败的一份
+    CURLcode GetAttempt(const std::string& url, struct curl_slist* header_list,
+                        std::array<BodySink, 2>* sinks, const PrepareSink& prepare,
+                        long* http_code, size_t* winner) {
+        using Clock = std::chrono::steady_clock;
+        *http_code = 0;
+        *winner = 0;
+
+        CURL* handles[2] = {pool_.Acquire(), nullptr};
+        if (!handles[0]) return CURLE_FAILED_INIT;
+        auto start = [&](size_t i) {
+            auto& sink = (*sinks)[i];
+            prepare(&sink, i == 1);
+            sink.curl = handles[i];
+            sink.written = 0;
+            curl_easy_setopt(handles[i], CURLOPT_URL, url.c_str());
+            curl_easy_setopt(handles[i], CURLOPT_HTTPHEADER, header_list);
+            curl_easy_setopt(handles[i], CURLOPT_WRITEDATA, &sink);
+            curl_easy_setopt(handles[i], CURLOPT_WRITEFUNCTION, BodyWriteCallback);
+        };
+        start(0);
+
+        hedge_budget_.Earn();
+        uint64_t delay_us = HedgeDelayMicros();
+        CURLM* multi = delay_us > 0 ? curl_multi_init() : nullptr;
+        if (!multi) {
+            CURLcode res = curl_easy_perform(handles[0]);
+            curl_easy_getinfo(handles[0], CURLINFO_RESPONSE_CODE, http_code);
+            if (res == CURLE_OK) RecordFirstByte(handles[0]);
+            pool_.Release(handles[0]);
+            return res;
+        }
+
+        curl_multi_add_handle(multi, handles[0]);
+        Clock::time_point started[2] = {Clock::now(), {}};
+        auto hedge_at = started[0] + std::chrono::microseconds(delay_us);
+        bool running[2] = {true, false};
+        bool finished = false;
+        CURLcode result = CURLE_OK;
+        while (!finished) {
+            int still_running = 0;
+            curl_multi_perform(multi, &still_running);
+
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+                if (msg->msg != CURLMSG_DONE) continue;
+                size_t i = msg->easy_handle == handles[0] ? 0 : 1;
+                running[i] = false;
+                CURLcode res = msg->data.result;
+                long code = 0;
+                curl_easy_getinfo(handles[i], CURLINFO_RESPONSE_CODE, &code);
+                if (res == CURLE_OK) RecordFirstByte(handles[i]);
+                // 另一份仍在途时, 可重试的失败留给它兜底
+                if (!finished && (!Retryable(res, code) || !running[1 - i])) {
+                    result = res;
+                    *http_code = code;
+                    *winner = i;
+                    finished = true;
+                }
+            }
+            if (finished) break;
+
+            auto now = Clock::now();
+            if (!handles[1] && running[0] && (*sinks)[0].written == 0 && now >= hedge_at) {
+                if (hedge_budget_.Take() && (handles[1] = pool_.TryAcquire())) {
+                    start(1);
+                    curl_multi_add_handle(multi, handles[1]);
+                    started[1] = now;
+                    running[1] = true;
+                    hedges_.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    hedge_at = Clock::time_point::max();
+                }
+            }
+
+            int timeout_ms = 100;
+            if (!handles[1] && hedge_at != Clock::time_point::max()) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(hedge_at - now).count();
+                timeout_ms = static_cast<int>(std::clamp<int64_t>(wait, 1, timeout_ms));
+            }
+            curl_multi_poll(multi, nullptr, 0, timeout_ms, nullptr);
+        }
+
+        // 被取消的一份若还没收到响应体, 以已等待的时间记一个样本, 慢请求不会从统计中消失
+        auto now = Clock::now();
+        for (size_t i = 0; i < 2; ++i) {
+            if (!handles[i]) continue;
+            if (running[i] && (*sinks)[i].written == 0) {
+                ttfb_.Record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - started[i]).count()));
+            }
+            curl_multi_remove_handle(multi, handles[i]);
+            pool_.Release(handles[i]);
+        }
+        curl_multi_cleanup(multi);
+        if (*winner == 1) {
+            hedge_wins_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    void RecordFirstByte(CURL* curl) {
+        curl_off_t micros = 0;
+        if (curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &micros) == CURLE_OK && micros > 0) {
+            ttfb_.Record(static_cast<uint64_t>(micros));
+        }
+    }
+
+    // 当前对冲阈值 (微秒), 取本端点首字节延迟 p95 与下限中的较大者; 0 表示不对冲
+    uint64_t HedgeDelayMicros() {
+        if (!config_.hedge_reads || config_.hedge_budget_percent == 0 ||
+            ttfb_.count() < kHedgeMinSamples) {
+            return 0;
+        }
+        uint64_t delay = hedge_delay_us_.load(std::memory_order_relaxed);
+        if (delay == 0 || hedge_checks_.fetch_add(1, std::memory_order_relaxed) % kHedgeRefreshInterval == 0) {
+            delay = std::max<uint64_t>(ttfb_.Percentile(0.95), uint64_t{config_.hedge_min_delay_ms} * 1000);
+            hedge_delay_us_.store(delay, std::memory_order_relaxed);
+        }
+        return delay;
+    }
+
+    // 连接失败、超时、连接中断与 408/429/5xx 可重试; 4xx 与回调中止 (sink 出错) 不重试
+    static bool Retryable(CURLcode res, long http_code) {
+        switch (res) {
+        case CURLE_OK:
+            return http_code == 408 || http_code == 429 || http_code == 500 ||
+                   http_code == 502 || http_code == 503 || http_code == 504;
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_OPERATION_TIMEDOUT:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_PARTIAL_FILE:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_HTTP2:
+        case CURLE_HTTP2_STREAM:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static std::string Describe(CURLcode res, long http_code) {
+        return res != CURLE_OK ? curl_easy_strerror(res) : "HTTP " + std::to_string(http_code);
+    }
+
+    // 全抖动指数退避: 第 n 次重试在 [0, min(max, base * 2^n)] 内均匀随机
+    std::chrono::milliseconds BackoffDelay(uint32_t attempt) const {
+        uint64_t cap = std::min<uint64_t>(config_.retry_max_delay_ms,
+                                          uint64_t{config_.retry_base_delay_ms} << std::min<uint32_t>(attempt, 20));
+        thread_local std::mt19937_64 rng(std::random_device{}());
+        return std::chrono::milliseconds(cap > 0 ? rng() % (cap + 1) : 0);
+    }
+
+    void Backoff(uint32_t attempt) {
+        retries_.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::sleep_for(BackoffDelay(attempt));
+    }
 
+    static struct curl_slist* HeaderList(const std::vector<std::string>& headers) {
         struct curl_slist* header_list = nullptr;
         for (const auto& h : headers) {
             header_list = curl_slist_append(header_list, h.c_str());
         }
+        return header_list;
+    }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+    static std::string RangeSpec(uint64_t offset, uint64_t size) {
+        return std::to_string(offset) + "-" + std::to_string(offset + size - 1);
+    }
 
-        CURLcode res = curl_easy_perform(curl);
-        long http_code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    enum class Outcome {
+        kDone,      // 该请求结束
+        kRetry,     // 重新排队
+        kStop,      // 不再发起排队中的请求 (在途请求仍会完成)
+    };
 
-        curl_slist_free_all(header_list);
-        curl_easy_cleanup(curl);
+    // curl multi 并发执行 n 个请求, 在途数不超过 limit 与句柄池上限.
+    // setup(i, handle) 设置第 i 个请求并返回其头部列表 (由此处释放), 重试时会再次调用;
+    // done(i, status, http_code) 处理结果, status 只反映传输层错误.
+    // 可重试的错误 (见 Retryable) 在此按退避重发, 用尽次数后才交给 done; done 返回
+    // kRetry 的请求同样退避后重发. 已持有句柄时不阻塞等待句柄池, 避免多个并发批次
+    // 互相占满句柄池
+    void RunConcurrent(size_t n, size_t limit,
+                       const std::function<struct curl_slist*(size_t, CURL*)>& setup,
+                       const std::function<Outcome(size_t, const Status&, long)>& done) {
+        using Clock = std::chrono::steady_clock;
+        requests_.fetch_add(n, std::memory_order_relaxed);
+        std::deque<size_t> pending;
+        for (size_t i = 0; i < n; ++i) pending.push_back(i);
+        std::vector<uint32_t> attempts(n, 0);
+        std::vector<std::pair<Clock::time_point, size_t>> delayed;     // 退避中的请求
+
+        CURLM* multi = curl_multi_init();
+        if (!multi) {
+            for (size_t i : pending) done(i, Status::IO("Failed to init curl multi"), 0);
+            return;
+        }
+        if (pool_.http2()) {
+            // HTTP/2 下多个传输复用同一连接的不同流
+            curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        }
 
-        if (res != CURLE_OK) {
-            return Status::IO(std::string("curl error: ") + curl_easy_strerror(res));
+        auto retry_later = [&](size_t i) {
+            delayed.emplace_back(Clock::now() + BackoffDelay(attempts[i]), i);
+            ++attempts[i];
+            retries_.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        limit = std::clamp<size_t>(limit, 1, std::max<uint32_t>(config_.max_connections, 1));
+        struct Active {
+            size_t index;
+            struct curl_slist* header_list;
+        };
+        std::unordered_map<CURL*, Active> active;
+        while (!pending.empty() || !active.empty() || !delayed.empty()) {
+            auto now = Clock::now();
+            auto next_retry = Clock::time_point::max();
+            for (size_t k = 0; k < delayed.size();) {
+                if (delayed[k].first <= now) {
+                    pending.push_back(delayed[k].second);
+                    delayed[k] = delayed.back();
+                    delayed.pop_back();
+                } else {
+                    next_retry = std::min(next_retry, delayed[k].first);
+                    ++k;
+                }
+            }
+
+            while (!pending.empty() && active.size() < limit) {
+                CURL* curl = active.empty() ? pool_.Acquire() : pool_.TryAcquire();
+                if (!curl && !active.empty()) break;
+                size_t i = pending.front();
+                pending.pop_front();
+                if (!curl) {
+                    done(i, Status::IO("Failed to init curl"), 0);
+                    continue;
+                }
+                active.emplace(curl, Active{i, setup(i, curl)});
+                curl_multi_add_handle(multi, curl);
+            }
+
+            if (active.empty()) {
+                // 只剩退避中的请求
+                if (pending.empty() && next_retry != Clock::time_point::max()) {
+                    std::this_thread::sleep_until(next_retry);
+                }
+                continue;
+            }
+
+            int running = 0;
+            curl_multi_perform(multi, &running);
+
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+                if (msg->msg != CURLMSG_DONE) continue;
+                CURL* curl = msg->easy_handle;
+                CURLcode res = msg->data.result;
+                auto it = active.find(curl);
+                Active item = it->second;
+                active.erase(it);
+
+                long http_code = 0;
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+                curl_multi_remove_handle(multi, curl);
+                curl_slist_free_all(item.header_list);
+                pool_.Release(curl);
+
+                if (attempts[item.index] < config_.max_retries && Retryable(res, http_code)) {
+                    retry_later(item.index);
+                    continue;
+                }
+                Status status = res == CURLE_OK
+                    ? Status::Ok()
+                    : Status::IO(std::string("curl error: ") + curl_easy_strerror(res));
+                switch (done(item.index, status, http_code)) {
+                case Outcome::kDone:
+                    break;
+                case Outcome::kRetry:
+                    retry_later(item.index);
+                    break;
+                case Outcome::kStop:
+                    pending.clear();
+                    delayed.clear();
+                    break;
+                }
+            }
+
+            if (!active.empty()) {
+                int timeout_ms = 100;
+                if (next_retry != Clock::time_point::max()) {
+                    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_retry - Clock::now()).count();
+                    timeout_ms = static_cast<int>(std::clamp<int64_t>(wait, 1, timeout_ms));
+                }
+                curl_multi_poll(multi, nullptr, 0, timeout_ms, nullptr);
+            }
         }
-        if (http_code == 404) {
-            return Status::NotFound("Object not found");
+        curl_multi_cleanup(multi);
+    }
+
+    struct ReadContext {
+        const ByteBuffer* data;
+        size_t offset;
+    };
+
+    // S3 要求除最后一片外分片不小于 5MB
+    static constexpr uint64_t kMinPartSize = 5ULL << 20;
+
+    struct Part {
+        ByteBuffer data;            // 原对象的视图
+        ReadContext ctx{nullptr, 0};
+        std::string etag;
+        uint32_t attempts = 0;
+    };
+
+    Status CreateMultipartUpload(const std::string& key, std::string* upload_id) {
+        const std::string query = "uploads=";
+        std::vector<uint8_t> body;
+        long http_code = 0;
+        auto status = Perform(BuildUrl(key, query), BuildHeaders("POST", key, 0, query), [&](CURL* curl) {
+            body.clear();
+            curl_easy_setopt(curl, CURLOPT_POST, 1L);
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "");
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, 0L);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+        }, &http_code);
+        if (!status.OK()) {
+            return status;
         }
         if (http_code >= 400) {
-            return Status::IO("S3 HEAD failed, HTTP " + std::to_string(http_code));
+            return Status::IO("S3 create multipart upload failed, HTTP " + std::to_string(http_code));
+        }
+        *upload_id = XmlValue(std::string(body.begin(), body.end()), "UploadId");
+        if (upload_id->empty()) {
+            return Status::IO("S3 create multipart upload returned no UploadId");
         }
         return Status::Ok();
     }
 
-private:
-    Config config_;
+    struct curl_slist* StartPartUpload(CURL* curl, const std::string& key, const std::string& upload_id,
+                                       size_t part_number, Part* part) {
+        std::string query = "partNumber=" + std::to_string(part_number) +
+                            "&uploadId=" + UrlEncode(upload_id, false);
+        part->ctx = ReadContext{&part->data, 0};
+        part->etag.clear();
 
-    std::string BuildUrl(const std::string& key) {
-        std::string host = config_.endpoint.empty()
-            ? config_.bucket + ".s3." + config_.region + ".amazonaws.com"
-            : config_.endpoint;
-        return "https://" + host + "/" + UrlEncode(key);
+        struct curl_slist* header_list = nullptr;
+        for (const auto& h : BuildHeaders("PUT", key, part->data.size(), query)) {
+            header_list = curl_slist_append(header_list, h.c_str());
+        }
+        auto url = BuildUrl(key, query);
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+        curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+        curl_easy_setopt(curl, CURLOPT_READDATA, &part->ctx);
+        curl_easy_setopt(curl, CURLOPT_READFUNCTION, ReadCallback);
+        curl_easy_setopt(curl, CURLOPT_SEEKDATA, &part->ctx);
+        curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, SeekCallback);
+        curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(part->data.size()));
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &part->etag);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, EtagCallback);
+        return header_list;
     }
 
-    std::vector<std::string> BuildHeaders(const std::string& method, const std::string& key, size_t content_length) {
-        std::string date = GetAmzDate();
-        std::string date_stamp = date.substr(0, 8);
-
-        std::string host = config_.endpoint.empty()
-            ? config_.bucket + ".s3." + config_.region + ".amazonaws.com"
-            : config_.endpoint;
+    Status CompleteMultipartUpload(const std::string& key, const std::string& upload_id,
+                                   const std::vector<Part>& parts) {
+        std::string xml = "<CompleteMultipartUpload>";
+        for (size_t i = 0; i < parts.size(); ++i) {
+            xml += "<Part><PartNumber>" + std::to_string(i + 1) + "</PartNumber><ETag>" +
+                   parts[i].etag + "</ETag></Part>";
+        }
+        xml += "</CompleteMultipartUpload>";
 
-        // AWS Signature V4
-        std::string canonical_uri = "/" + key;
-        std::string canonical_querystring;
-        std::string payload_hash = "UNSIGNED-PAYLOAD";
+        std::string query = "uploadId=" + UrlEncode(upload_id, false);
+        std::vector<uint8_t> body;
+        long http_code = 0;
+        auto status = Perform(BuildUrl(key, query), BuildHeaders("POST", key, xml.size(), query), [&](CURL* curl) {
+            body.clear();
+            curl_easy_setopt(curl, CURLOPT_POST, 1L);
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, xml.c_str());
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(xml.size()));
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+        }, &http_code);
+        if (!status.OK()) {
+            return status;
+        }
+        // 完成请求可能返回 200 但响应体为 <Error>
+        std::string response(body.begin(), body.end());
+        if (http_code >= 400 || response.find("<Error>") != std::string::npos) {
+            return Status::IO("S3 complete multipart upload failed, HTTP " + std::to_string(http_code) +
+                              " " + XmlValue(response, "Code"));
+        }
+        return Status::Ok();
+    }
 
-        std::string canonical_headers = "host:" + host + "\n" + "x-amz-content-sha256:" + payload_hash + "\n" + "x-amz-date:" + date + "\n";
-        std::string signed_headers = "host;x-amz-content-sha256;x-amz-date";
+    Status AbortMultipartUpload(const std::string& key, const std::string& upload_id) {
+        std::string query = "uploadId=" + UrlEncode(upload_id, false);
+        long http_code = 0;
+        auto status = Perform(BuildUrl(key, query), BuildHeaders("DELETE", key, 0, query), [](CURL* curl) {
+            curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+        }, &http_code);
+        if (!status.OK()) {
+            return status;
+        }
+        if (http_code >= 400 && http_code != 404) {
+            return Status::IO("S3 abort multipart upload failed, HTTP " + std::to_string(http_code));
+        }
+        return Status::Ok();
+    }
 
-        std::string canonical_request = method + "\n" + canonical_uri + "\n" + canonical_querystring + "\n" + canonical_headers + "\n" + signed_headers + "\n" + payload_hash;
+    // 取 XML 中第一个 <tag>...</tag> 的文本, 不存在时返回空串
+    static std::string XmlValue(const std::string& xml, const std::string& tag) {
+        auto open = "<" + tag + ">";
+        auto begin = xml.find(open);
+        if (begin == std::string::npos) return "";
+        begin += open.size();
+        auto end = xml.find("</" + tag + ">", begin);
+        return end == std::string::npos ? "" : xml.substr(begin, end - begin);
+    }
 
-        std::string algorithm = "AWS4-HMAC-SHA256";
-        std::string credential_scope = date_stamp + "/" + config_.region + "/s3/aws4_request";
-        std::string string_to_sign = algorithm + "\n" + date + "\n" + credential_scope + "\n" + Sha256Hex(canonical_request);
+    // 从响应头中取 ETag (保留引号, 完成请求原样回传)
+    static size_t EtagCallback(char* buffer, size_t size, size_t nitems, void* userp) {
+        size_t n = size * nitems;
+        std::string_view line(buffer, n);
+        constexpr std::string_view kName = "etag:";
+        if (line.size() > kName.size() &&
+            std::equal(kName.begin(), kName.end(), line.begin(),
+                       [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); })) {
+            auto value = line.substr(kName.size());
+            while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) value.remove_prefix(1);
+            while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) value.remove_suffix(1);
+            static_cast<std::string*>(userp)->assign(value);
+        }
+        return n;
+    }
 
-        auto signing_key = GetSignatureKey(config_.secret_key, date_stamp, config_.region, "s3");
-        std::string signature = HmacSha256Hex(signing_key, string_to_sign);
+    struct StreamContext {
+        CURL* curl;
+        const ChunkSink* sink;
+        Status status;          // sink 返回的错误
+        uint64_t delivered;     // 已交给 sink 的字节数
+    };
 
-        std::string authorization = algorithm + " Credential=" + config_.access_key + "/" + credential_scope + ", SignedHeaders=" + signed_headers + ", Signature=" + signature;
+    struct Transfer {
+        BodySink sink;
+    };
 
-        return {
-            "Host: " + host,
-            "x-amz-date: " + date,
-            "x-amz-content-sha256: " + payload_hash,
-            "Authorization: " + authorization
-        };
-    }
+    struct curl_slist* StartTransfer(CURL* curl, const RangeFetch& fetch, Transfer* transfer) {
+        auto headers = BuildHeaders("GET", fetch.key, 0);
+        transfer->sink.curl = curl;
+        if (fetch.size != 0) {
+            headers.push_back("Range: bytes=" + std::to_string(fetch.offset) + "-" +
+                              std::to_string(fetch.offset + fetch.size - 1));
+            transfer->sink.buffer = ByteBuffer::Allocate(fetch.size);
+            transfer->sink.fixed = true;
+        }
+        struct curl_slist* header_list = nullptr;
+        for (const auto& h : headers) {
+            header_list = curl_slist_append(header_list, h.c_str());
+        }
 
-    static std::string GetAmzDate() {
-        time_t now = time(nullptr);
-        struct tm tm_buf;
-        gmtime_r(&now, &tm_buf);
-        char buf[32];
-        strftime(buf, sizeof(buf), "%Y%m%dT%H%M%SZ", &tm_buf);
-        return buf;
+        auto url = BuildUrl(fetch.key);
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());   // curl 内部复制 URL
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->sink);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, BodyWriteCallback);
+        return header_list;
     }
 
-    static std::string Sha256Hex(const std::string& data) {
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        SHA256(reinterpret_cast<const unsigned char*>(data.c_str()), data.size(), hash);
-        return ToHex(hash, SHA256_DIGEST_LENGTH);
+    static Status GetStatus(const std::string& key, long http_code, bool range) {
+        if (http_code == 404) {
+            return Status::NotFound("Object not found: " + key);
+        }
+        if (http_code >= 400) {
+            return Status::IO(std::string(range ? "S3 GET range failed" : "S3 GET failed") +
+                              ", HTTP " + std::to_string(http_code));
+        }
+        return Status::Ok();
     }
 
-    static std::vector<unsigned char> HmacSha256(const std::vector<unsigned char>& key, const std::string& data) {
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        unsigned int len = SHA256_DIGEST_LENGTH;
-        HMAC(EVP_sha256(), key.data(), key.size(),
-             reinterpret_cast<const unsigned char*>(data.c_str()), data.size(), hash, &len);
-        return std::vector<unsigned char>(hash, hash + len);
+    // endpoint 可带 http:// 或 https:// 前缀 (MinIO 常用明文), 默认 https
+    std::string Scheme() const {
+        if (config_.endpoint.rfind("http://", 0) == 0) return "http://";
+        return "https://";
     }
 
-    static std::vector<unsigned char> HmacSha256(const std::string& key, const std::string& data) {
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        unsigned int len = SHA256_DIGEST_LENGTH;
-        HMAC(EVP_sha256(), key.c_str(), key.size(),
-             reinterpret_cast<const unsigned char*>(data.c_str()), data.size(), hash, &len);
-        return std::vector<unsigned char>(hash, hash + len);
+    std::string Host() const {
+        if (config_.endpoint.empty()) {
+            return config_.bucket + ".s3." + config_.region + ".amazonaws.com";
+        }
+        auto pos = config_.endpoint.find("://");
+        return pos == std::string::npos ? config_.endpoint : config_.endpoint.substr(pos + 3);
     }
 
-    static std::string HmacSha256Hex(const std::vector<unsigned char>& key, const std::string& data) {
-        auto hash = HmacSha256(key, data);
-        return ToHex(hash.data(), hash.size());
+    // query 须已是规范形式 (按参数名排序, 值已编码)
+    std::string BuildUrl(const std::string& key, const std::string& query = "") {
+        std::string url = Scheme() + host_ + "/" + UrlEncode(key);
+        if (!query.empty()) url += "?" + query;
+        return url;
     }
 
-    static std::vector<unsigned char> GetSignatureKey(const std::string& secret, const std::string& date,
-                                                       const std::string& region, const std::string& service) {
-        auto k_date = HmacSha256("AWS4" + secret, date);
-        auto k_region = HmacSha256(k_date, region);
-        auto k_service = HmacSha256(k_region, service);
-        return HmacSha256(k_service, "aws4_request");
+    std::vector<std::string> BuildHeaders(const std::string& method, const std::string& key, size_t content_length,
+                                          const std::string& query = "") {
+        (void)content_length;   // 负载按 UNSIGNED-PAYLOAD 签名
+        thread_local std::string canonical_uri;
+        canonical_uri.assign("/");
+        AppendUrlEncoded(&canonical_uri, key, true);
+        return signer_.Sign(method, host_, canonical_uri, query, time(nullptr));
     }
 
-    static std::string ToHex(const unsigned char* data, size_t len) {
-        std::ostringstream ss;
-        ss << std::hex << std::setfill('0');
-        for (size_t i = 0; i < len; ++i) {
-            ss << std::setw(2) << static_cast<int>(data[i]);
-        }
-        return ss.str();
+    static std::string UrlEncode(const std::string& s, bool keep_slash = true) {
+        std::string escaped;
+        escaped.reserve(s.size());
+        AppendUrlEncoded(&escaped, s, keep_slash);
+        return escaped;
     }
 
-    static std::string UrlEncode(const std::string& s) {
-        std::ostringstream escaped;
-        escaped << std::hex << std::setfill('0');
+    static void AppendUrlEncoded(std::string* out, std::string_view s, bool keep_slash) {
+        static constexpr char kHex[] = "0123456789ABCDEF";
         for (char c : s) {
-            if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '/') {
-                escaped << c;
+            auto u = static_cast<unsigned char>(c);
+            if (isalnum(u) || c == '-' || c == '_' || c == '.' || c == '~' || (keep_slash && c == '/')) {
+                out->push_back(c);
             } else {
-                escaped << '%' << std::setw(2) << static_cast<int>(static_cast<unsigned char>(c));
+                out->push_back('%');
+                out->push_back(kHex[u >> 4]);
+                out->push_back(kHex[u & 0x0f]);
             }
         }
-        return escaped.str();
     }
 
     // CURL 回调
@@ -337,25 +1366,65 @@ private:
         return size * nmemb;
     }
 
-    struct ReadContext {
-        const ByteBuffer* data;
-        size_t offset;
-    };
+    static bool IsErrorResponse(CURL* curl) {
+        long http_code = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        return http_code >= 400;
+    }
+
+    static size_t BodyWriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+        auto* sink = static_cast<BodySink*>(userp);
+        size_t n = size * nmemb;
+        if (IsErrorResponse(sink->curl)) return n;
+        if (n > sink->buffer.size() - sink->written) {
+            if (sink->fixed) return 0;
+            size_t capacity = sink->written + n;
+            if (sink->buffer.size() == 0) {
+                curl_off_t length = -1;
+                curl_easy_getinfo(sink->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+                if (length > 0) capacity = std::max(capacity, static_cast<size_t>(length));
+            } else {
+                capacity = std::max(capacity, sink->buffer.size() * 2);
+            }
+            auto grown = ByteBuffer::Allocate(capacity);
+            if (sink->written > 0) std::memcpy(grown.data(), sink->buffer.data(), sink->written);
+            sink->buffer = std::move(grown);
+        }
+        std::memcpy(sink->buffer.data() + sink->written, contents, n);
+        sink->written += n;
+        return n;
+    }
+
+    static size_t StreamWriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+        auto* ctx = static_cast<StreamContext*>(userp);
+        size_t n = size * nmemb;
+        if (IsErrorResponse(ctx->curl)) return n;
+        ctx->status = (*ctx->sink)(static_cast<const uint8_t*>(contents), n);
+        if (!ctx->status.OK()) return 0;
+        ctx->delivered += n;
+        return n;
+    }
 
     static size_t ReadCallback(void* ptr, size_t size, size_t nmemb, void* userp) {
-        auto* data = static_cast<const ByteBuffer*>(userp);
-        static thread_local size_t offset = 0;
-        size_t remaining = data->size() - offset;
+        auto* ctx = static_cast<ReadContext*>(userp);
+        size_t remaining = ctx->data->size() - ctx->offset;
         size_t to_copy = std::min(remaining, size * nmemb);
         if (to_copy > 0) {
-            memcpy(ptr, data->data() + offset, to_copy);
-            offset += to_copy;
-        }
-        if (offset >= data->size()) {
-            offset = 0;  // Reset for next request
+            memcpy(ptr, ctx->data->data() + ctx->offset, to_copy);
+            ctx->offset += to_copy;
         }
         return to_copy;
     }
+
+    static int SeekCallback(void* userp, curl_off_t offset, int origin) {
+        auto* ctx = static_cast<ReadContext*>(userp);
+        if (origin != SEEK_SET || offset < 0 ||
+            static_cast<size_t>(offset) > ctx->data->size()) {
+            return CURL_SEEKFUNC_CANTSEEK;
+        }
+        ctx->offset = static_cast<size_t>(offset);
+        return CURL_SEEKFUNC_OK;
+    }
 };
 
 // ================================
@@ -372,7 +1441,8 @@ S3Backend::S3Backend(Config config)
 S3Backend::~S3Backend() = default;
 
 AsyncTask<Status> S3Backend::Put(const std::string& key, const ByteBuffer& data) {
-    auto status = client_->PutObject(key, data);
+    bool multipart = config_.multipart_threshold > 0 && data.size() >= config_.multipart_threshold;
+    auto status = multipart ? client_->MultipartPut(key, data) : client_->PutObject(key, data);
     if (status.OK()) {
         LOG_DEBUG("S3 PUT: %s (%zu bytes)", key.c_str(), data.size());
     } else {
@@ -411,15 +1481,31 @@ AsyncTask<Status> S3Backend::GetRange(const std::string& key, uint64_t offset, u
     co_return status;
 }
 
-AsyncTask<Status> S3Backend::BatchGet(const std::vector<std::string>& keys, std::vector<ByteBuffer>* data) {
-    data->resize(keys.size());
-    for (size_t i = 0; i < keys.size(); ++i) {
-        auto status = co_await Get(keys[i], &(*data)[i]);
-        if (!status.OK()) {
-            co_return status;
-        }
+AsyncTask<Status> S3Backend::GetRangeInto(const std::string& key, uint64_t offset, uint64_t size,
+                                          uint8_t* dst, uint64_t* bytes_read) {
+    *bytes_read = 0;
+    if (size == 0) {
+        co_return Status::Ok();
     }
-    co_return Status::Ok();
+    co_return client_->GetObjectInto(key, offset, size, dst, bytes_read);
+}
+
+AsyncTask<Status> S3Backend::GetStream(const std::string& key, uint64_t offset, uint64_t size,
+                                       ChunkSink sink) {
+    auto status = client_->GetObjectStream(key, offset, size, sink);
+    if (!status.OK()) {
+        LOG_ERROR("S3 GET stream failed: %s - %s", key.c_str(), status.message().c_str());
+    }
+    co_return status;
+}
+
+AsyncTask<void> S3Backend::BatchRead(const std::vector<ReadRequest>& requests,
+                                     std::vector<ReadResult>* results, uint32_t max_concurrency) {
+    client_->MultiGet(requests, results, max_concurrency);
+    size_t failed = std::count_if(results->begin(), results->end(),
+                                  [](const ReadResult& r) { return !r.status.OK(); });
+    LOG_DEBUG("S3 batch read: %zu requests, %zu failed", requests.size(), failed);
+    co_return;
 }
 
 AsyncTask<Status> S3Backend::HealthCheck() {
@@ -431,6 +1517,10 @@ AsyncTask<Status> S3Backend::HealthCheck() {
     co_return Status::Ok();
 }
 
+S3Backend::Stats S3Backend::stats() const {
+    return client_->stats();
+}
+
 AsyncTask<Status> S3Backend::GetCapacity(CapacityInfo* info) {
     // S3 存储容量理论上无限
     info->total_bytes = UINT64_MAX;
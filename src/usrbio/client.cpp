@@ -0,0 +1,269 @@
+// ================================
+// usrbio 客户端库实现
+// ================================
+
+#include "nebulastore/usrbio/client.h"
+#include "nebulastore/usrbio/control.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace nebulastore {
+namespace usrbio {
+
+struct UsrbioClient::Mapping {
+    int fd = -1;
+    uint8_t* addr = nullptr;
+    size_t size = 0;
+
+    ~Mapping() {
+        if (addr) ::munmap(addr, size);
+        if (fd >= 0) ::close(fd);
+    }
+
+    // 创建 memfd 并映射, 失败返回 nullptr (errno 保留).
+    // 定长后封住缩小: 服务端映射了它, 截断会让服务端访问时收到 SIGBUS
+    static std::unique_ptr<Mapping> Create(const char* name, size_t size) {
+        auto m = std::make_unique<Mapping>();
+        m->fd = ::memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (m->fd < 0 || ::ftruncate(m->fd, static_cast<off_t>(size)) != 0 ||
+            ::fcntl(m->fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) != 0) {
+            return nullptr;
+        }
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0);
+        if (p == MAP_FAILED) return nullptr;
+        m->addr = static_cast<uint8_t*>(p);
+        m->size = size;
+        return m;
+    }
+};
+
+namespace {
+
+Status ErrnoStatus(const std::string& what, int err) {
+    return Status::IO(what + ": " + strerror(err));
+}
+
+}  // namespace
+
+Result<std::unique_ptr<UsrbioClient>> UsrbioClient::Connect(const std::string& socket_path) {
+    sockaddr_un addr{};
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        return Err<std::unique_ptr<UsrbioClient>>(ErrorCode::kInvalidArgument,
+                                                  "socket path too long");
+    }
+    int sock = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        return ErrnoStatus("usrbio socket", errno);
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    if (::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        int err = errno;
+        ::close(sock);
+        return ErrnoStatus("usrbio connect " + socket_path, err);
+    }
+    return std::unique_ptr<UsrbioClient>(new UsrbioClient(sock));
+}
+
+UsrbioClient::UsrbioClient(int sock) : sock_(sock) {}
+
+UsrbioClient::~UsrbioClient() {
+    // 关闭连接即释放服务端资源, 之后再解除本地映射
+    if (sock_ >= 0) ::close(sock_);
+    for (auto& [id, fds] : doorbells_) {
+        ::close(fds.first);
+        ::close(fds.second);
+    }
+    ring_views_.clear();
+    rings_.clear();
+    buffers_.clear();
+}
+
+int UsrbioClient::Call(const void* req, size_t len, const int* fds, size_t nfds, uint32_t* id) {
+    int ret = SendCtrlMsg(sock_, req, len, fds, nfds);
+    if (ret != 0) return ret;
+    CtrlResponse resp{};
+    ret = RecvCtrlMsg(sock_, &resp, sizeof(resp));
+    if (ret < 0) return ret;
+    if (ret != static_cast<int>(sizeof(resp))) return -ECONNRESET;
+    if (id) *id = resp.id;
+    return resp.status;
+}
+
+// ================================
+// 资源注册
+// ================================
+
+Result<UsrbioClient::Buffer> UsrbioClient::RegisterBuffer(size_t size) {
+    auto mem = Mapping::Create("nebula-usrbio-buf", size);
+    if (!mem) {
+        return ErrnoStatus("usrbio buffer alloc", errno);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    CtrlRequest req{CtrlOp::kRegisterBuffer, 0, size};
+    uint32_t id = 0;
+    int ret = Call(&req, sizeof(req), &mem->fd, 1, &id);
+    if (ret != 0) {
+        return ErrnoStatus("usrbio register buffer", -ret);
+    }
+
+    Buffer buffer{id, mem->addr, mem->size};
+    buffers_[id] = std::move(mem);
+    return buffer;
+}
+
+Result<UsrbioClient::Buffer> UsrbioClient::RegisterBuffer(const storage::BufferPool& pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CtrlRequest req{CtrlOp::kRegisterBuffer, 0, pool.capacity()};
+    int fd = pool.fd();
+    uint32_t id = 0;
+    int ret = Call(&req, sizeof(req), &fd, 1, &id);
+    if (ret != 0) {
+        return ErrnoStatus("usrbio register pool", -ret);
+    }
+    // 映射归池所有, 这里只记录 ID
+    buffers_[id] = nullptr;
+    return Buffer{id, pool.base(), pool.capacity()};
+}
+
+Status UsrbioClient::UnregisterBuffer(const Buffer& buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CtrlRequest req{CtrlOp::kUnregisterBuffer, buffer.id, 0};
+    int ret = Call(&req, sizeof(req), nullptr, 0, nullptr);
+    buffers_.erase(buffer.id);
+    return ret == 0 ? Status::Ok() : ErrnoStatus("usrbio unregister buffer", -ret);
+}
+
+Result<UsrbioClient::Ring> UsrbioClient::CreateRing(uint32_t entries, bool for_read) {
+    if (entries == 0) {
+        return Err<Ring>(ErrorCode::kInvalidArgument, "ring entries must be > 0");
+    }
+    size_t size = IoRing::BytesFor(entries);
+    auto mem = Mapping::Create("nebula-usrbio-ring", size);
+    if (!mem) {
+        return ErrnoStatus("usrbio ring alloc", errno);
+    }
+    int sq_fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    int cq_fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (sq_fd < 0 || cq_fd < 0) {
+        int err = errno;
+        if (sq_fd >= 0) ::close(sq_fd);
+        if (cq_fd >= 0) ::close(cq_fd);
+        return ErrnoStatus("usrbio doorbell", err);
+    }
+    auto view = IoRing::Create(mem->addr, mem->size, entries, for_read);
+    view->SetDoorbells(sq_fd, cq_fd);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    CtrlRequest req{CtrlOp::kRegisterRing, 0, size};
+    int fds[3] = {mem->fd, sq_fd, cq_fd};
+    uint32_t id = 0;
+    int ret = Call(&req, sizeof(req), fds, 3, &id);
+    if (ret != 0) {
+        ::close(sq_fd);
+        ::close(cq_fd);
+        return ErrnoStatus("usrbio register ring", -ret);
+    }
+
+    Ring ring{id, view.get()};
+    rings_[id] = std::move(mem);
+    ring_views_[id] = std::move(view);
+    doorbells_[id] = {sq_fd, cq_fd};
+    return ring;
+}
+
+Status UsrbioClient::DestroyRing(const Ring& ring) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CtrlRequest req{CtrlOp::kUnregisterRing, ring.id, 0};
+    int ret = Call(&req, sizeof(req), nullptr, 0, nullptr);
+    ring_views_.erase(ring.id);
+    rings_.erase(ring.id);
+    auto it = doorbells_.find(ring.id);
+    if (it != doorbells_.end()) {
+        ::close(it->second.first);
+        ::close(it->second.second);
+        doorbells_.erase(it);
+    }
+    return ret == 0 ? Status::Ok() : ErrnoStatus("usrbio unregister ring", -ret);
+}
+
+// ================================
+// IO
+// ================================
+
+int UsrbioClient::PrepareIo(const Ring& ring, const Buffer& buffer, uint32_t buf_off,
+                            InodeID inode, uint64_t file_off, uint64_t len, void* userdata) {
+    if (buf_off > buffer.size || len > buffer.size - buf_off) {
+        return -EINVAL;
+    }
+    IoArgs args{buffer.id, buf_off, inode, file_off, len, userdata};
+    int idx = ring.io->AddSqe(args);
+    return idx < 0 ? -EAGAIN : idx;
+}
+
+void UsrbioClient::Submit(const Ring& ring) {
+    ring.io->NotifySq();
+}
+
+int UsrbioClient::SubmitIos(const Ring& ring, const IoArgs* args, int n) {
+    if (n <= 0) return 0;
+    uint32_t added = ring.io->AddSqes(args, static_cast<uint32_t>(n));
+    if (added > 0) ring.io->NotifySq();
+    return static_cast<int>(added);
+}
+
+int UsrbioClient::Wait(const Ring& ring, IoCqe* cqes, int max_cqes, int min_complete,
+                       int timeout_ms) {
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+    IoRing& io = *ring.io;
+    int got = 0;
+    uint32_t idle = 0;
+
+    while (got < max_cqes) {
+        uint32_t n = io.PopCqes(cqes + got, static_cast<uint32_t>(max_cqes - got));
+        if (n > 0) {
+            got += static_cast<int>(n);
+            idle = 0;
+            continue;
+        }
+        if (got >= min_complete) break;
+
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - Clock::now()).count();
+            if (left <= 0) break;
+            wait_ms = static_cast<int>(left);
+        }
+        // 先短暂自旋, 再登记并阻塞在 CQ 门铃上
+        if (++idle < 64 || io.CqDoorbell() < 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        io.SetCqNeedWakeup(true);
+        if (io.CqeCount() == 0) {
+            pollfd pfd{io.CqDoorbell(), POLLIN, 0};
+            if (::poll(&pfd, 1, wait_ms) > 0) {
+                uint64_t value;
+                (void)!::read(pfd.fd, &value, sizeof(value));
+            }
+        }
+        io.SetCqNeedWakeup(false);
+        idle = 0;
+    }
+    return got;
+}
+
+}  // namespace usrbio
+}  // namespace nebulastore
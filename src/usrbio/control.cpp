@@ -0,0 +1,84 @@
+// ================================
+// usrbio 控制通道: 带 fd 的消息收发
+// ================================
+
+#include "nebulastore/usrbio/control.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace nebulastore {
+namespace usrbio {
+
+int SendCtrlMsg(int sock, const void* msg, size_t len, const int* fds, size_t nfds) {
+    if (nfds > kMaxCtrlFds) return -EINVAL;
+
+    iovec iov{const_cast<void*>(msg), len};
+    msghdr mh{};
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxCtrlFds)];
+    if (nfds > 0) {
+        std::memset(control, 0, sizeof(control));
+        mh.msg_control = control;
+        mh.msg_controllen = CMSG_SPACE(sizeof(int) * nfds);
+        cmsghdr* cm = CMSG_FIRSTHDR(&mh);
+        cm->cmsg_level = SOL_SOCKET;
+        cm->cmsg_type = SCM_RIGHTS;
+        cm->cmsg_len = CMSG_LEN(sizeof(int) * nfds);
+        std::memcpy(CMSG_DATA(cm), fds, sizeof(int) * nfds);
+    }
+
+    while (true) {
+        ssize_t n = ::sendmsg(sock, &mh, MSG_NOSIGNAL);
+        if (n >= 0) return 0;
+        if (errno != EINTR) return -errno;
+    }
+}
+
+int RecvCtrlMsg(int sock, void* msg, size_t len, int* fds, size_t max_fds, size_t* nfds) {
+    size_t count = 0;
+
+    iovec iov{msg, len};
+    msghdr mh{};
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxCtrlFds)];
+    mh.msg_control = control;
+    mh.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do {
+        n = ::recvmsg(sock, &mh, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        if (nfds) *nfds = 0;
+        return -errno;
+    }
+
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&mh); cm; cm = CMSG_NXTHDR(&mh, cm)) {
+        if (cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS) continue;
+        size_t received = (cm->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < received; ++i) {
+            int fd;
+            std::memcpy(&fd, CMSG_DATA(cm) + i * sizeof(int), sizeof(int));
+            if (fds && count < max_fds) {
+                fds[count++] = fd;
+            } else {
+                ::close(fd);  // 调用方不需要的 fd, 避免泄漏
+            }
+        }
+    }
+    if (mh.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) {
+        for (size_t i = 0; i < count; ++i) ::close(fds[i]);
+        if (nfds) *nfds = 0;
+        return -EMSGSIZE;
+    }
+    if (nfds) *nfds = count;
+    return static_cast<int>(n);
+}
+
+}  // namespace usrbio
+}  // namespace nebulastore
@@ -0,0 +1,546 @@
+// ================================
+// usrbio 服务端实现
+// ================================
+
+#include "nebulastore/usrbio/server.h"
+#include "nebulastore/usrbio/control.h"
+#include "nebulastore/namespace/slice_writer.h"
+#include "nebulastore/common/logger.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+namespace nebulastore {
+namespace usrbio {
+
+// ================================
+// 内部结构
+// ================================
+
+struct UsrbioServer::Mapping {
+    uint8_t* addr = nullptr;
+    size_t size = 0;
+
+    ~Mapping() {
+        if (addr) ::munmap(addr, size);
+    }
+
+    // 映射客户端传来的 memfd, 映射后即可关闭 fd. 须已封住缩小 (F_SEAL_SHRINK),
+    // 否则客户端截断后服务端访问映射会收到 SIGBUS. 失败返回 nullptr, *err 为 errno
+    static std::shared_ptr<Mapping> Map(int fd, size_t size, int* err) {
+        struct stat st;
+        if (size == 0 || ::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < size) {
+            *err = EINVAL;
+            return nullptr;
+        }
+        int seals = ::fcntl(fd, F_GET_SEALS);
+        if (seals < 0 || !(seals & F_SEAL_SHRINK)) {
+            *err = EPERM;
+            return nullptr;
+        }
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            *err = errno;
+            return nullptr;
+        }
+        auto m = std::make_shared<Mapping>();
+        m->addr = static_cast<uint8_t*>(p);
+        m->size = size;
+        return m;
+    }
+};
+
+struct UsrbioServer::Ring {
+    std::shared_ptr<Mapping> mem;
+    std::unique_ptr<IoRing> io;
+    std::weak_ptr<Session> session;
+    int sq_doorbell = -1;              // 客户端提交后敲响
+    int cq_doorbell = -1;              // 完成后按需敲响
+    std::atomic<uint32_t> inflight{0};
+    std::atomic<bool> closed{false};
+
+    // CQ 是单生产者, 完成可能来自多个线程; 攒批后一次发布
+    std::mutex cq_mutex;
+    std::vector<IoCqe> pending_cqes;
+    bool draining = false;             // IO 线程正在取 SQE, 由其统一发布
+
+    ~Ring() {
+        if (sq_doorbell >= 0) ::close(sq_doorbell);
+        if (cq_doorbell >= 0) ::close(cq_doorbell);
+    }
+
+    // 需持有 cq_mutex
+    void FlushCompletions() {
+        if (pending_cqes.empty()) return;
+        auto n = static_cast<uint32_t>(pending_cqes.size());
+        if (!closed.load(std::memory_order_relaxed)) {
+            io->CompleteSqes(pending_cqes.data(), n);
+            io->NotifyCq();
+        }
+        pending_cqes.clear();
+        // 发布后才释放在途额度, 与 DrainRing 的 CQ 容量检查配合
+        inflight.fetch_sub(n, std::memory_order_release);
+    }
+};
+
+struct UsrbioServer::Session {
+    int fd = -1;
+    std::mutex mutex;
+    uint32_t next_buffer_id = 0;
+    uint32_t next_ring_id = 0;
+    std::unordered_map<uint32_t, std::shared_ptr<Mapping>> buffers;
+    std::unordered_map<uint32_t, std::shared_ptr<Ring>> rings;
+
+    std::shared_ptr<Mapping> FindBuffer(uint32_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = buffers.find(id);
+        return it == buffers.end() ? nullptr : it->second;
+    }
+};
+
+// ================================
+// 生命周期
+// ================================
+
+UsrbioServer::UsrbioServer(Config config,
+                           metadata::MetadataService* metadata,
+                           storage::StorageBackend* backend)
+    : config_(std::move(config)), metadata_(metadata), backend_(backend), planner_(backend) {}
+
+UsrbioServer::~UsrbioServer() {
+    Stop();
+}
+
+Status UsrbioServer::Start() {
+    if (running_.load()) return Status::Ok();
+
+    sockaddr_un addr{};
+    if (config_.socket_path.size() >= sizeof(addr.sun_path)) {
+        return Status::InvalidArgument("usrbio socket path too long: " + config_.socket_path);
+    }
+
+    auto parent = std::filesystem::path(config_.socket_path).parent_path();
+    std::error_code ec;
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+    ::unlink(config_.socket_path.c_str());
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        return Status::IO(std::string("usrbio socket: ") + strerror(errno));
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, config_.socket_path.c_str(), config_.socket_path.size() + 1);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 64) != 0) {
+        int err = errno;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return Status::IO("usrbio bind " + config_.socket_path + ": " + strerror(err));
+    }
+
+    wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    io_wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd_ < 0 || io_wake_fd_ < 0) {
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        if (io_wake_fd_ >= 0) ::close(io_wake_fd_);
+        wake_fd_ = io_wake_fd_ = -1;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return Status::IO(std::string("usrbio eventfd: ") + strerror(errno));
+    }
+
+    running_.store(true);
+    control_thread_ = std::thread([this] { ControlLoop(); });
+    io_thread_ = std::thread([this] { IoLoop(); });
+    LOG_INFO("usrbio server listening on %s", config_.socket_path.c_str());
+    return Status::Ok();
+}
+
+void UsrbioServer::Stop() {
+    if (!running_.exchange(false)) return;
+
+    uint64_t one = 1;
+    (void)!::write(wake_fd_, &one, sizeof(one));
+    WakeIoThread();
+    if (control_thread_.joinable()) control_thread_.join();
+    if (io_thread_.joinable()) io_thread_.join();
+
+    // 等待在途 IO 落地, 它们持有 ring/缓冲区的引用并访问后端
+    while (inflight_total_.load(std::memory_order_acquire) > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        for (auto& [fd, session] : sessions_) {
+            ::close(fd);
+        }
+        sessions_.clear();
+    }
+    io_rings_.clear();
+    io_pollfds_.clear();
+
+    ::close(listen_fd_);
+    ::close(wake_fd_);
+    ::close(io_wake_fd_);
+    listen_fd_ = wake_fd_ = io_wake_fd_ = -1;
+    ::unlink(config_.socket_path.c_str());
+    LOG_INFO("usrbio server stopped");
+}
+
+// ================================
+// 控制通道
+// ================================
+
+void UsrbioServer::ControlLoop() {
+    std::vector<pollfd> fds;
+    while (running_.load(std::memory_order_relaxed)) {
+        fds.clear();
+        fds.push_back({wake_fd_, POLLIN, 0});
+        fds.push_back({listen_fd_, POLLIN, 0});
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            for (auto& [fd, session] : sessions_) {
+                fds.push_back({fd, POLLIN, 0});
+            }
+        }
+
+        int n = ::poll(fds.data(), fds.size(), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("usrbio poll failed: %s", strerror(errno));
+            break;
+        }
+        if (fds[0].revents) break;  // Stop()
+
+        if (fds[1].revents & POLLIN) {
+            int cfd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (cfd >= 0) {
+                auto session = std::make_shared<Session>();
+                session->fd = cfd;
+                std::lock_guard<std::mutex> lock(sessions_mutex_);
+                sessions_[cfd] = std::move(session);
+                LOG_DEBUG("usrbio client connected (fd=%d)", cfd);
+            }
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i) {
+            if (!fds[i].revents) continue;
+            std::shared_ptr<Session> session;
+            {
+                std::lock_guard<std::mutex> lock(sessions_mutex_);
+                auto it = sessions_.find(fds[i].fd);
+                if (it == sessions_.end()) continue;
+                session = it->second;
+            }
+            HandleRequest(session, fds[i].fd);
+        }
+    }
+}
+
+void UsrbioServer::HandleRequest(const std::shared_ptr<Session>& session, int sock) {
+    CtrlRequest req{};
+    int passed_fds[kMaxCtrlFds];
+    size_t nfds = 0;
+    int n = RecvCtrlMsg(sock, &req, sizeof(req), passed_fds, kMaxCtrlFds, &nfds);
+    if (n <= 0) {
+        CloseSession(session);
+        return;
+    }
+
+    CtrlResponse resp{0, 0};
+    if (n != static_cast<int>(sizeof(req))) {
+        resp.status = -EINVAL;
+    } else {
+        switch (req.op) {
+        case CtrlOp::kRegisterBuffer: {
+            std::shared_ptr<Mapping> mem;
+            int err = 0;
+            if (nfds != 1 || req.size > config_.max_buffer_size) {
+                resp.status = -EINVAL;
+            } else if (!(mem = Mapping::Map(passed_fds[0], req.size, &err))) {
+                resp.status = -err;
+            } else {
+                std::lock_guard<std::mutex> lock(session->mutex);
+                if (session->buffers.size() >= config_.max_buffers_per_client) {
+                    resp.status = -ENOSPC;
+                } else {
+                    resp.id = session->next_buffer_id++;
+                    session->buffers[resp.id] = std::move(mem);
+                }
+            }
+            break;
+        }
+        case CtrlOp::kRegisterRing: {
+            std::shared_ptr<Mapping> mem;
+            int err = 0;
+            if (nfds != 3) {
+                resp.status = -EINVAL;
+            } else if (!(mem = Mapping::Map(passed_fds[0], req.size, &err))) {
+                resp.status = -err;
+            } else {
+                auto ring = std::make_shared<Ring>();
+                ring->io = IoRing::Attach(mem->addr, mem->size);
+                ring->mem = std::move(mem);
+                ring->session = session;
+                // 门铃 fd 转交给 ring 持有
+                ring->sq_doorbell = std::exchange(passed_fds[1], -1);
+                ring->cq_doorbell = std::exchange(passed_fds[2], -1);
+                if (!ring->io || ring->io->CqCapacity() + 1 > config_.max_ring_entries) {
+                    resp.status = -EINVAL;
+                } else {
+                    ring->io->SetDoorbells(ring->sq_doorbell, ring->cq_doorbell);
+                    std::lock_guard<std::mutex> lock(session->mutex);
+                    if (session->rings.size() >= config_.max_rings_per_client) {
+                        resp.status = -ENOSPC;
+                    } else {
+                        resp.id = session->next_ring_id++;
+                        session->rings[resp.id] = std::move(ring);
+                        rings_version_.fetch_add(1, std::memory_order_release);
+                        WakeIoThread();
+                    }
+                }
+            }
+            break;
+        }
+        case CtrlOp::kUnregisterBuffer: {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            resp.status = session->buffers.erase(req.id) ? 0 : -ENOENT;
+            break;
+        }
+        case CtrlOp::kUnregisterRing: {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            auto it = session->rings.find(req.id);
+            if (it == session->rings.end()) {
+                resp.status = -ENOENT;
+            } else {
+                it->second->closed.store(true);
+                session->rings.erase(it);
+                rings_version_.fetch_add(1, std::memory_order_release);
+                WakeIoThread();
+            }
+            break;
+        }
+        default:
+            resp.status = -EINVAL;
+            break;
+        }
+    }
+    for (size_t i = 0; i < nfds; ++i) {
+        if (passed_fds[i] >= 0) ::close(passed_fds[i]);
+    }
+
+    if (SendCtrlMsg(sock, &resp, sizeof(resp)) != 0) {
+        CloseSession(session);
+    }
+}
+
+// 客户端断开: 释放其全部 ring 和缓冲区 (在途 IO 持有的引用会延后释放映射)
+void UsrbioServer::CloseSession(const std::shared_ptr<Session>& session) {
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        for (auto& [id, ring] : session->rings) {
+            ring->closed.store(true);
+        }
+        session->rings.clear();
+        session->buffers.clear();
+    }
+    rings_version_.fetch_add(1, std::memory_order_release);
+    WakeIoThread();
+
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    sessions_.erase(session->fd);
+    ::close(session->fd);
+    LOG_DEBUG("usrbio client disconnected (fd=%d)", session->fd);
+}
+
+// ================================
+// IO 线程
+// ================================
+
+void UsrbioServer::WakeIoThread() {
+    uint64_t one = 1;
+    (void)!::write(io_wake_fd_, &one, sizeof(one));
+}
+
+void UsrbioServer::RefreshRings() {
+    uint64_t version = rings_version_.load(std::memory_order_acquire);
+    if (version == io_rings_version_) return;
+
+    io_rings_.clear();
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        for (auto& [fd, session] : sessions_) {
+            std::lock_guard<std::mutex> session_lock(session->mutex);
+            for (auto& [id, ring] : session->rings) {
+                io_rings_.push_back(ring);
+            }
+        }
+    }
+    io_rings_version_ = version;
+
+    // 休眠时监听: 退出/刷新通知 + 各 ring 的 SQ 门铃
+    io_pollfds_.clear();
+    io_pollfds_.push_back({io_wake_fd_, POLLIN, 0});
+    for (auto& ring : io_rings_) {
+        io_pollfds_.push_back({ring->sq_doorbell, POLLIN, 0});
+    }
+}
+
+void UsrbioServer::IoLoop() {
+    uint32_t idle_rounds = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        RefreshRings();
+
+        uint32_t popped = 0;
+        for (auto& ring : io_rings_) {
+            popped += DrainRing(ring);
+        }
+        if (popped > 0) {
+            idle_rounds = 0;
+            continue;
+        }
+        if (++idle_rounds < config_.spin_rounds) {
+            continue;
+        }
+
+        // 登记休眠, 再检查一次队列, 然后等门铃
+        for (auto& ring : io_rings_) ring->io->SetSqNeedWakeup(true);
+        bool pending = false;
+        for (auto& ring : io_rings_) {
+            if (ring->io->SqeCount() > 0 && !ring->closed.load(std::memory_order_relaxed)) {
+                pending = true;
+                break;
+            }
+        }
+        if (!pending) {
+            int n = ::poll(io_pollfds_.data(), io_pollfds_.size(),
+                           static_cast<int>(config_.idle_timeout_ms));
+            if (n > 0) {
+                uint64_t value;
+                for (auto& pfd : io_pollfds_) {
+                    if (pfd.revents & POLLIN) (void)!::read(pfd.fd, &value, sizeof(value));
+                }
+            }
+        }
+        for (auto& ring : io_rings_) ring->io->SetSqNeedWakeup(false);
+        idle_rounds = 0;
+    }
+}
+
+uint32_t UsrbioServer::DrainRing(const std::shared_ptr<Ring>& ring) {
+    if (ring->closed.load(std::memory_order_relaxed)) return 0;
+
+    constexpr uint32_t kBatch = 64;
+    IoSqe sqes[kBatch];
+    IoArgs args[kBatch];
+    IoRing& io = *ring->io;
+
+    {
+        std::lock_guard<std::mutex> lock(ring->cq_mutex);
+        ring->draining = true;
+    }
+
+    uint32_t popped = 0;
+    while (true) {
+        // 在途 + 未消费的 CQE 不超过 CQ 容量, 保证完成时一定能投递
+        uint32_t used = ring->inflight.load(std::memory_order_acquire) + io.CqeCount();
+        if (used >= io.CqCapacity()) break;
+        uint32_t n = io.PopSqes(sqes, args, std::min(kBatch, io.CqCapacity() - used));
+        if (n == 0) break;
+
+        ring->inflight.fetch_add(n, std::memory_order_relaxed);
+        inflight_total_.fetch_add(n, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < n; ++i) {
+            ProcessSqe(ring, sqes[i], args[i]);
+        }
+        popped += n;
+    }
+
+    // 本轮同步完成的 IO 一次发布
+    std::lock_guard<std::mutex> lock(ring->cq_mutex);
+    ring->draining = false;
+    ring->FlushCompletions();
+    return popped;
+}
+
+DetachedTask UsrbioServer::ProcessSqe(std::shared_ptr<Ring> ring, IoSqe sqe, IoArgs args) {
+    int64_t result;
+    auto session = ring->session.lock();
+    auto buffer = session ? session->FindBuffer(args.buf_id) : nullptr;
+
+    if (!buffer) {
+        result = -EBADF;
+    } else if (args.io_len > static_cast<uint64_t>(INT32_MAX) ||
+               args.buf_off > buffer->size || args.io_len > buffer->size - args.buf_off) {
+        result = -EINVAL;
+    } else if (args.io_len == 0) {
+        result = 0;
+    } else if (ring->io->IsForRead()) {
+        result = co_await ReadFile(args.file_iid, args.file_off, args.io_len,
+                                   buffer->addr + args.buf_off);
+    } else {
+        // 数据视图持有共享映射, 后端即使保留它也不会悬空
+        result = co_await WriteFile(args.file_iid, args.file_off,
+                                    ByteBuffer::Wrap(buffer->addr + args.buf_off, args.io_len, buffer));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(ring->cq_mutex);
+        ring->pending_cqes.push_back(IoCqe{sqe.index, static_cast<int32_t>(result), sqe.userdata});
+        if (!ring->draining) {
+            ring->FlushCompletions();
+        }
+    }
+    inflight_total_.fetch_sub(1, std::memory_order_release);
+}
+
+// ================================
+// 数据通路
+// ================================
+
+AsyncTask<int64_t> UsrbioServer::ReadFile(InodeID inode, uint64_t offset, uint64_t len,
+                                          uint8_t* dst) {
+    FileLayout layout;
+    auto status = co_await metadata_->GetLayout(inode, &layout);
+    if (!status.OK()) {
+        co_return status.code() == ErrorCode::kNotFound ? -ENOENT : -EIO;
+    }
+
+    // 计划覆盖所有相交 slice, 并发直接读入共享缓冲区
+    auto plan = namespace_::ReadPlanner::Plan(layout, offset, len);
+    status = co_await planner_.Execute(plan, dst);
+    if (!status.OK()) co_return -EIO;
+    co_return static_cast<int64_t>(plan.length);
+}
+
+AsyncTask<int64_t> UsrbioServer::WriteFile(InodeID inode, uint64_t offset, ByteBuffer data) {
+    // 每次写入一个新 slice, 对象键带唯一 slice ID: 同一偏移的重写不覆盖旧 slice
+    // 仍引用的对象, 压缩也能按 slice ID 区分
+    uint64_t len = data.size();
+    uint64_t slice_id = namespace_::NextSliceId();
+    std::string storage_key = SliceStorageKey(inode, slice_id);
+    auto status = co_await backend_->Put(storage_key, data);
+    if (!status.OK()) co_return -EIO;
+
+    // slice 与文件大小一次提交, 大小只增不减 (中间写入不截断文件)
+    std::vector<SliceInfo> slices{SliceInfo{slice_id, offset, len, std::move(storage_key)}};
+    status = co_await metadata_->AddSlices(inode, slices, offset + len);
+    if (!status.OK()) co_return -EIO;
+    co_return static_cast<int64_t>(len);
+}
+
+}  // namespace usrbio
+}  // namespace nebulastore
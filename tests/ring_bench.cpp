@@ -0,0 +1,81 @@
+// ================================
+// 环形队列吞吐基准
+// ================================
+//
+// 对比两种多生产者提交方式 (单消费者):
+//   spsc+mutex: 生产者之间用互斥锁串行化后写 LockFreeRing
+//   mpmc      : 生产者直接 CAS 写 MpmcRing
+// 用法: ring-bench [总条目数, 均分给各生产者]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "nebulastore/usrbio/ioring.h"
+
+using namespace nebulastore::usrbio;
+
+namespace {
+
+constexpr uint32_t kRingCapacity = 4096;
+
+template <typename PushFn, typename PopFn>
+double Run(int producers, uint64_t per_producer, PushFn push, PopFn pop) {
+    const uint64_t total = producers * per_producer;
+    std::atomic<bool> start{false};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            while (!start.load(std::memory_order_acquire)) {}
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                while (!push(i)) std::this_thread::yield();
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    uint64_t got = 0;
+    uint64_t v;
+    while (got < total) {
+        if (pop(v)) {
+            ++got;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    for (auto& t : threads) t.join();
+    return total / elapsed;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    uint64_t total_items = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::cout << "producers   spsc+mutex (Mops/s)   mpmc (Mops/s)\n";
+    for (int producers : {1, 2, 4, 8, 16}) {
+        LockFreeRing<uint64_t> spsc(kRingCapacity);
+        std::mutex push_mutex;
+        double locked = Run(producers, total_items / producers,
+            [&](uint64_t v) {
+                std::lock_guard<std::mutex> lock(push_mutex);
+                return spsc.Push(v);
+            },
+            [&](uint64_t& v) { return spsc.Pop(v); });
+
+        MpmcRing<uint64_t> mpmc(kRingCapacity);
+        double lockfree = Run(producers, total_items / producers,
+            [&](uint64_t v) { return mpmc.Push(v); },
+            [&](uint64_t& v) { return mpmc.Pop(v); });
+
+        std::cout << "  " << producers << "\t\t" << locked / 1e6
+                  << "\t\t\t" << lockfree / 1e6 << "\n";
+    }
+    return 0;
+}
@@ -109,6 +109,39 @@ void TestObjectMetaEncodeDecode() {
     assert(dec2.user_metadata.empty());
     std::cout << "  [OK] Empty user_metadata handled" << std::endl;
 
+    // v2 紧凑格式: 只有 bucket/key 的对象 1 + 1 + 2 + 2 字节
+    assert(enc2.size() == 6);
+    assert(!dec2.Decode(enc2.substr(0, enc2.size() - 1)));
+    assert(!dec2.Decode(enc2 + "x"));
+    std::string bad_ver = encoded;
+    bad_ver[0] = 3;
+    assert(!dec2.Decode(bad_ver));
+    std::cout << "  [OK] v2 compact: " << enc2.size() << " bytes, truncated/garbage rejected"
+              << std::endl;
+
+    // 兼容 v1 定长格式
+    std::string v1;
+    encoding::PutU32(v1, 1);
+    encoding::PutString(v1, meta.bucket);
+    encoding::PutString(v1, meta.key);
+    encoding::PutU64(v1, meta.size);
+    encoding::PutString(v1, meta.etag);
+    encoding::PutString(v1, meta.content_type);
+    encoding::PutU64(v1, meta.last_modified);
+    encoding::PutString(v1, meta.storage_class);
+    encoding::PutString(v1, meta.data_path);
+    encoding::PutU32(v1, 1);
+    encoding::PutString(v1, "x-amz-meta-author");
+    encoding::PutString(v1, "test");
+    ObjectMeta dec_v1;
+    assert(dec_v1.Decode(v1));
+    assert(dec_v1.key == meta.key && dec_v1.size == meta.size);
+    assert(dec_v1.last_modified == meta.last_modified);
+    assert(dec_v1.user_metadata["x-amz-meta-author"] == "test");
+    assert(encoded.size() < v1.size());
+    std::cout << "  [OK] v1 decode: " << v1.size() << " -> v2 " << encoded.size() << " bytes"
+              << std::endl;
+
     std::cout << "ObjectMeta tests passed!" << std::endl;
 }
 